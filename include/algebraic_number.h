@@ -27,16 +27,37 @@
 extern "C" {
 #endif
 
+/** Internal state of an algebraic number (opaque) */
+typedef struct lp_algebraic_number_state_struct lp_algebraic_number_state_t;
+
 /**
  * Algebraic number represented as the only root of the polynomial f in the
  * interval (a,b). The signs at the points a and b are kept to improve
  * refinement of the interval when needed. If f is 0, then the interval is
  * a single point, and that is the value of the number.
+ *
+ * A lazy number (see lp_algebraic_number_is_lazy()) is the value of an
+ * arithmetic expression that hasn't been computed yet. The expression is kept
+ * in the internal state, and the other fields are not used. Such numbers are
+ * compared and approximated using interval arithmetic, and the defining
+ * polynomial is only computed when needed (see lp_algebraic_number_force).
+ *
+ * Numbers obtained from root isolation are roots of a shared root set, kept in
+ * the internal state. The polynomial f is then owned by the set and shared
+ * with the other roots, roots of the same set are compared by their index,
+ * and the refined intervals are shared through the set.
+ *
+ * Algebraic numbers are not thread-safe. Even the const operations refine the
+ * interval and compute lazy values in place, and copies share the lazy
+ * expressions and the root sets through plain reference counts. A number, and
+ * all the numbers sharing state with it (its copies, and the other roots from
+ * the same root isolation), must only be used by one thread at a time.
  */
 struct lp_algebraic_number_struct {
   lp_upolynomial_t* f;
   lp_dyadic_interval_t I;
   int sgn_at_a, sgn_at_b;
+  lp_algebraic_number_state_t* state;
 };
 
 /**
@@ -105,7 +126,18 @@ void lp_algebraic_number_get_dyadic_midpoint(const lp_algebraic_number_t* a, lp_
 /** Get the midpoint of the defining interval */
 void lp_algebraic_number_get_rational_midpoint(const lp_algebraic_number_t* a, lp_rational_t* q);
 
-/** Refine the number by halving its interval. */
+/** Strategies for refining the isolating interval */
+typedef enum {
+  /** Halve the interval (one bit per step) */
+  LP_ALGEBRAIC_NUMBER_REFINE_BISECTION,
+  /** Quadratic interval refinement (secant guided, default) */
+  LP_ALGEBRAIC_NUMBER_REFINE_QIR
+} lp_algebraic_number_refinement_t;
+
+/** Set the strategy used to refine the isolating intervals */
+void lp_algebraic_number_set_refinement(lp_algebraic_number_refinement_t refinement);
+
+/** Refine the number by shrinking its interval (at least halving it). */
 void lp_algebraic_number_refine(lp_algebraic_number_t* a);
 
 /**
@@ -114,6 +146,25 @@ void lp_algebraic_number_refine(lp_algebraic_number_t* a);
  */
 void lp_algebraic_number_refine_const(const lp_algebraic_number_t* a);
 
+/**
+ * Enable or disable lazy arithmetic (enabled by default). When enabled, the
+ * arithmetic operations only record the expression and the resultants are
+ * computed when the value is needed.
+ */
+void lp_algebraic_number_set_lazy(int lazy);
+
+/** Returns true if the number is the value of a not yet computed expression */
+int lp_algebraic_number_is_lazy(const lp_algebraic_number_t* a);
+
+/** Compute the defining polynomial and interval of a lazy number */
+void lp_algebraic_number_force(lp_algebraic_number_t* a);
+
+/**
+ * Same as above, but const version for convenience: NOT CONST, the number is
+ * the same but internally it might change.
+ */
+void lp_algebraic_number_force_const(const lp_algebraic_number_t* a);
+
 /** Restore the interval that has been lost due to refinement (be careful) */
 void lp_algebraic_number_restore_interval(lp_algebraic_number_t* a, const lp_dyadic_interval_t* I);
 
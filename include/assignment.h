@@ -26,11 +26,37 @@
 extern "C" {
 #endif
 
+/** Previous value of a variable, kept on the trail to undo a change */
+typedef struct {
+  /** The variable */
+  lp_variable_t x;
+  /** The value before the change */
+  lp_value_t value;
+} lp_assignment_trail_entry_t;
+
 struct lp_assignment_struct {
   /** Size of the map */
   size_t size;
   /** The values */
   lp_value_t* values;
+  /** Timestamps of the values (when they were last changed) */
+  size_t* timestamps;
+  /** Current timestamp, increased on every change */
+  size_t timestamp;
+  /** Unique id of the assignment (for caching) */
+  size_t id;
+  /** Previous values of the changed variables (only with open scopes) */
+  lp_assignment_trail_entry_t* trail;
+  /** Size of the trail */
+  size_t trail_size;
+  /** Capacity of the trail */
+  size_t trail_capacity;
+  /** Trail sizes at the open scopes */
+  size_t* scopes;
+  /** Number of open scopes */
+  size_t scopes_size;
+  /** Capacity of the scopes */
+  size_t scopes_capacity;
   /** The variable database */
   const lp_variable_db_t* var_db;
 };
@@ -55,13 +81,46 @@ char* lp_assignment_to_string(const lp_assignment_t* m);
 
 /**
  * Set the value of a variable (value is copied over). If value is 0 (pointer)
- * the value is unset.
+ * the value is unset. If there are open scopes, the previous value is moved
+ * to the trail.
  */
 void lp_assignment_set_value(lp_assignment_t* m, lp_variable_t x, const lp_value_t* value);
 
+/**
+ * Open a new scope. All changes done in the scope are undone by the matching
+ * lp_assignment_pop().
+ */
+void lp_assignment_push(lp_assignment_t* m);
+
+/**
+ * Close the last scope, restoring the values it changed. The values are moved
+ * back from the trail, so this is linear in the number of changes, and not in
+ * the size of the values.
+ */
+void lp_assignment_pop(lp_assignment_t* m);
+
+/** Get the number of open scopes */
+size_t lp_assignment_scope_level(const lp_assignment_t* m);
+
 /** Get the value of a variable */
 const lp_value_t* lp_assignment_get_value(const lp_assignment_t* m, lp_variable_t x);
 
+/**
+ * Get the timestamp of the last change of the variable value (0 if never
+ * changed). Timestamps only increase, so any result computed at timestamp t
+ * from the values of some variables stays valid while their timestamps are at
+ * most t.
+ */
+size_t lp_assignment_get_timestamp(const lp_assignment_t* m, lp_variable_t x);
+
+/**
+ * Get the version of the assignment, i.e. the timestamp of the last change.
+ * Any change (including the ones undone by lp_assignment_pop()) gives a new
+ * version, so results computed from the assignment at the same version are
+ * still valid.
+ */
+size_t lp_assignment_get_version(const lp_assignment_t* m);
+
 /** Get an approximate value of the variable */
 void lp_assignment_get_value_approx(const lp_assignment_t* m, lp_variable_t x, lp_rational_interval_t* approx);
 
@@ -73,12 +132,14 @@ struct lp_interval_assignment_struct {
   size_t size;
   /** The intervals */
   lp_interval_t* intervals;
-  /** Timestamps */
+  /** Timestamps of the intervals (when they were last set) */
   size_t* timestamps;
   /** The variable database */
   const lp_variable_db_t* var_db;
-  /** Current timestamp */
+  /** Timestamp of the last reset, only intervals set after it are valid */
   size_t timestamp;
+  /** Current time, increased on every change */
+  size_t clock;
 };
 
 /** Construct an empty assignment of intervals */
@@ -108,6 +169,17 @@ void lp_interval_assignment_set_interval(lp_interval_assignment_t* m, lp_variabl
 /** Get the value of a variable */
 const lp_interval_t* lp_interval_assignment_get_interval(const lp_interval_assignment_t* m, lp_variable_t x);
 
+/**
+ * Get the timestamp of the last change of the interval of x (setting it, or
+ * resetting the assignment). Timestamps only increase, so any result computed
+ * at time t from the intervals of some variables stays valid while their
+ * timestamps are at most t.
+ */
+size_t lp_interval_assignment_get_timestamp(const lp_interval_assignment_t* m, lp_variable_t x);
+
+/** Get the current time of the assignment, i.e. the timestamp of the last change */
+size_t lp_interval_assignment_get_clock(const lp_interval_assignment_t* m);
+
 /** Reset the assignment (no values) */
 void lp_interval_assignment_reset(lp_interval_assignment_t* m);
 
@@ -0,0 +1,165 @@
+/**
+ * Copyright 2015, SRI International.
+ *
+ * This file is part of LibPoly.
+ *
+ * LibPoly is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LibPoly is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with LibPoly.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "poly.h"
+#include "value.h"
+#include "polynomial_hash_set.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Projection operators */
+typedef enum {
+  /**
+   * McCallum: coefficients (down to the first constant one), discriminants
+   * and pairwise resultants.
+   */
+  LP_CAD_PROJECTION_MCCALLUM,
+  /**
+   * Lazard: leading and trailing coefficients, discriminants and pairwise
+   * resultants.
+   */
+  LP_CAD_PROJECTION_LAZARD
+} lp_cad_projection_type_t;
+
+/**
+ * Project the polynomials in the set with respect to the variable x. The
+ * polynomials should not contain variables above x in the variable order.
+ *
+ * The polynomials are first split into square-free factors, without content.
+ * The factors with top variable x are refined into a square-free basis
+ * (pairwise coprime factors), which is added to basis. The other factors are
+ * added to projection directly, together with the (square-free factors of
+ * the) projection of the basis.
+ *
+ * All factors are primitive with positive leading coefficient, so both sets
+ * are duplicate free. Both basis and projection (constructed by the caller)
+ * are closed on return. The polynomials set can be closed or not.
+ *
+ * The independent factorizations, discriminants and resultants are computed
+ * in parallel, see lp_set_threads(). The result doesn't depend on the number
+ * of threads.
+ */
+void lp_cad_project(lp_cad_projection_type_t type, const lp_polynomial_hash_set_t* polynomials, lp_variable_t x,
+    lp_polynomial_hash_set_t* basis, lp_polynomial_hash_set_t* projection);
+
+/** A root of a polynomial, after substituting the values of lower variables */
+typedef struct {
+  /** The polynomial (0 for infinite bounds) */
+  lp_polynomial_t* p;
+  /** Index of the root among the distinct real roots of p, from the left */
+  size_t index;
+  /** Value of the root */
+  lp_value_t value;
+} lp_cad_root_t;
+
+/** The bounds of a cell in one variable */
+typedef struct {
+  /** The variable */
+  lp_variable_t x;
+  /** If true, the cell is the section x = lower (and upper is the same root) */
+  int is_section;
+  /** The lower bound, lower < x */
+  lp_cad_root_t lower;
+  /** The upper bound, x < upper */
+  lp_cad_root_t upper;
+} lp_cad_cell_level_t;
+
+/**
+ * A cylindrical cell around a sample point. In each variable, the cell is
+ * bounded by roots of polynomials in the variable (with lower variables
+ * ranging over the cell below). All polynomials in projection (including the
+ * square-free factors of the input) are sign-invariant over the cell.
+ */
+struct lp_cad_cell_struct {
+  /** Number of levels */
+  size_t size;
+  /** The levels, following the variable order from the bottom */
+  lp_cad_cell_level_t* levels;
+  /** The polynomials that are sign-invariant over the cell (closed) */
+  lp_polynomial_hash_set_t projection;
+  /** The variable database (for printing) */
+  const lp_variable_db_t* var_db;
+};
+
+/**
+ * Construct the cell around the sample point m, in which all the given
+ * polynomials are sign-invariant. The polynomials can only contain variables
+ * from the given order, which should agree with the order of their context,
+ * and all variables of the order must be assigned in m.
+ *
+ * The cell is computed level by level from the top, projecting the
+ * polynomials so that only the roots closest to the sample value are
+ * needed. When the values of the lower variables are rational, only those
+ * roots are isolated. Otherwise, all roots are isolated with
+ * lp_polynomial_roots_isolate().
+ */
+lp_cad_cell_t* lp_cad_cell_new(const lp_polynomial_hash_set_t* polynomials, const lp_variable_order_t* order, const lp_assignment_t* m);
+
+/** Delete the cell */
+void lp_cad_cell_delete(lp_cad_cell_t* cell);
+
+/** Print the cell */
+int lp_cad_cell_print(const lp_cad_cell_t* cell, FILE* out);
+
+/**
+ * A sample point of a CAD, as a node of the lifting tree. The root has no
+ * value. The children of a sample are the samples of the cells in the
+ * cylinder above it, sorted by the value of the next variable in the order.
+ * Sections (roots of the polynomials) alternate with sectors.
+ */
+struct lp_cad_sample_struct {
+  /** The variable (lp_variable_null for the root) */
+  lp_variable_t x;
+  /** The value of the variable */
+  lp_value_t value;
+  /** True if the value is a root of some polynomial */
+  int is_section;
+  /** The parent (0 for the root) */
+  lp_cad_sample_t* parent;
+  /** The children */
+  lp_cad_sample_t* children;
+  /** Number of children */
+  size_t children_size;
+};
+
+/**
+ * Construct the samples of a full CAD for the given polynomials, lifting
+ * through all the variables of the order (which should agree with the order
+ * of the polynomials' context). The polynomials should be closed under
+ * projection, e.g. the bases of lp_cad_project() for each variable.
+ *
+ * The samples of each level are lifted in parallel, see lp_set_threads().
+ * The tree doesn't depend on the number of threads. Returns the root of the
+ * tree, to be deleted with lp_cad_sample_delete().
+ */
+lp_cad_sample_t* lp_cad_lift(const lp_polynomial_hash_set_t* polynomials, const lp_variable_order_t* order);
+
+/** Delete the lifting tree (given the root) */
+void lp_cad_sample_delete(lp_cad_sample_t* root);
+
+/** Set the values of the sample (and all samples below it) in m */
+void lp_cad_sample_get_assignment(const lp_cad_sample_t* sample, lp_assignment_t* m);
+
+#ifdef __cplusplus
+} /* close extern "C" { */
+#endif
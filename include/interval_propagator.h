@@ -0,0 +1,73 @@
+/**
+ * Copyright 2015, SRI International.
+ *
+ * This file is part of LibPoly.
+ *
+ * LibPoly is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LibPoly is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with LibPoly.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "poly.h"
+#include "sign_condition.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Interval constraint propagation over a set of polynomial constraints
+ * sgn(A) ~ sgn_condition. Each constraint is revised HC4-style: the terms of
+ * A = sum c_k x^k are evaluated over the intervals (forward), and the
+ * interval allowed by the sign condition is projected back onto x and,
+ * recursively, onto the coefficients c_k (backward). The intervals are only
+ * ever narrowed.
+ *
+ * A constraint is revised again only when the interval of one of its
+ * variables has changed since its last revision (see
+ * lp_interval_assignment_get_timestamp()), so the propagator is meant to be
+ * used with one interval assignment, across calls.
+ */
+lp_interval_propagator_t* lp_interval_propagator_new(void);
+
+/** Delete the propagator */
+void lp_interval_propagator_delete(lp_interval_propagator_t* P);
+
+/**
+ * Add the constraint sgn(A) ~ sgn_condition (negated if negated is true).
+ * The polynomial is copied. Returns the index of the constraint.
+ */
+size_t lp_interval_propagator_add(lp_interval_propagator_t* P, const lp_polynomial_t* A, lp_sign_condition_t sgn_condition, int negated);
+
+/** Get the number of constraints */
+size_t lp_interval_propagator_size(const lp_interval_propagator_t* P);
+
+/**
+ * Propagate the constraints into M, until a fixpoint or until budget
+ * constraints have been revised. Returns 1 if some interval has been
+ * narrowed, 0 if not, and -1 if some constraint has no solution in M (see
+ * lp_interval_propagator_get_conflict()). The constraints left unrevised
+ * when the budget runs out are revised by the next call.
+ */
+int lp_interval_propagator_run(lp_interval_propagator_t* P, lp_interval_assignment_t* M, size_t budget);
+
+/** Get the index of the constraint in conflict (after run returns -1) */
+size_t lp_interval_propagator_get_conflict(const lp_interval_propagator_t* P);
+
+/** Get the number of revisions done by the last run */
+size_t lp_interval_propagator_get_revisions(const lp_interval_propagator_t* P);
+
+#ifdef __cplusplus
+} /* close extern "C" { */
+#endif
@@ -60,6 +60,7 @@ typedef struct lp_algebraic_number_struct lp_algebraic_number_t;
 typedef struct lp_value_struct lp_value_t;
 typedef struct lp_assignment_struct lp_assignment_t;
 typedef struct lp_interval_assignment_struct lp_interval_assignment_t;
+typedef struct lp_interval_propagator_struct lp_interval_propagator_t;
 
 typedef struct lp_rational_interval_struct lp_rational_interval_t;
 typedef struct lp_dyadic_interval_struct lp_dyadic_interval_t;
@@ -69,6 +70,9 @@ typedef struct lp_feasibility_set_struct lp_feasibility_set_t;
 typedef struct lp_polynomial_hash_set_struct lp_polynomial_hash_set_t;
 typedef struct lp_polynomial_vector_struct lp_polynomial_vector_t;
 
+typedef struct lp_cad_cell_struct lp_cad_cell_t;
+typedef struct lp_cad_sample_struct lp_cad_sample_t;
+
 /** Enable a given tag for tracing */
 void lp_trace_enable(const char* tag);
 
@@ -84,6 +88,20 @@ void lp_stats_print(FILE* file);
 /** Set the output language */
 void lp_set_output_language(lp_output_language_t lang);
 
+/**
+ * Set the precision (in bits) up to which the values of algebraic numbers are
+ * refined when computing the sign of a polynomial, before resorting to
+ * resultants. Default is 64, 0 disables the refinement.
+ */
+void lp_set_sgn_refinement_budget(unsigned bits);
+
+/**
+ * Set the number of threads used by the CAD operations (including the
+ * calling thread). Default is 1, i.e. everything runs in the calling thread.
+ * Has no effect if the library was built without thread support.
+ */
+void lp_set_threads(unsigned threads);
+
 #ifdef __cplusplus
 } /* close extern "C" { */
 #endif
@@ -332,6 +332,35 @@ int lp_polynomial_constraint_infer_bounds(const lp_polynomial_t* A, lp_sign_cond
  */
 lp_polynomial_t* lp_polynomial_constraint_explain_infer_bounds(const lp_polynomial_t* A, lp_sign_condition_t sgn_condition, int negated, lp_variable_t x);
 
+/**
+ * Contracts the bounded intervals of the variables of the equation A = 0 in
+ * M with one interval Newton step, x in m - A(m)/A'(X) for a point m of the
+ * interval X of x, where A' is the derivative in x evaluated over X and the
+ * intervals of the other variables in M. X is the interval of x in M, with
+ * algebraic bounds replaced by the bounds of their isolating intervals. If A'(X)
+ * contains 0, the Krawczyk operator is used instead. All variables are
+ * contracted from the intervals in M as given. Other sign conditions are
+ * not contracted.
+ *
+ * If negated is true, the constraint is considered negated.
+ *
+ * Returns 1 if some interval has been contracted, 0 if not, and -1 if there
+ * are no solutions.
+ */
+int lp_polynomial_constraint_contract_newton(const lp_polynomial_t* A, lp_sign_condition_t sgn_condition, int negated, lp_interval_assignment_t* M);
+
+/**
+ * Explains the contraction of x by lp_polynomial_constraint_contract_newton()
+ * in M (before the contraction) with a polynomial f(x), such that the
+ * contracted interval is f(x) <= 0. Returns 0 if x is not contracted.
+ *
+ * Unlike lp_polynomial_constraint_explain_infer_bounds(), f(x) <= 0 doesn't
+ * follow from the constraint alone: it follows from A = 0 together with the
+ * bounds in M of every variable of A (see lp_polynomial_get_variables()),
+ * including x. A lemma built from f must include all of these antecedents.
+ */
+lp_polynomial_t* lp_polynomial_constraint_explain_contract_newton(const lp_polynomial_t* A, lp_sign_condition_t sgn_condition, int negated, const lp_interval_assignment_t* M, lp_variable_t x);
+
 /**
  * Given a polynomial constraint, as above, evaluate its truth value.
  */
@@ -41,6 +41,10 @@ namespace poly {
     const Value& get(const Variable& var) const;
     /** Clear the assignment. */
     void clear();
+    /** Open a new scope. */
+    void push();
+    /** Undo all changes since the matching push(). */
+    void pop();
   };
 
   /** Stream the given Assignment to an output stream. */
@@ -162,6 +162,33 @@ int lp_upolynomial_sgn_at_rational(const lp_upolynomial_t* p, const lp_rational_
  */
 int lp_upolynomial_sgn_at_dyadic_rational(const lp_upolynomial_t* p, const lp_dyadic_rational_t* x);
 
+/**
+ * Evaluates the polynomial at the n given rational points, storing the
+ * results into the n (constructed) values. Evaluation is done in the integers
+ * and the powers of the denominator are shared among consecutive points with
+ * the same denominator, so sorting the points by denominator helps. Only makes
+ * sense for polynomials in Z[x].
+ */
+void lp_upolynomial_evaluate_many(const lp_upolynomial_t* p, size_t n, const lp_rational_t* x, lp_rational_t* values);
+
+/**
+ * Get the signs of the polynomial at the n given rational points. Only makes
+ * sense for polynomials in Z[x].
+ */
+void lp_upolynomial_sgn_many(const lp_upolynomial_t* p, size_t n, const lp_rational_t* x, int* sgns);
+
+/**
+ * Evaluates the polynomial at the n given dyadic points, storing the results
+ * into the n (constructed) values. Only makes sense for polynomials in Z[x].
+ */
+void lp_upolynomial_evaluate_many_dyadic(const lp_upolynomial_t* p, size_t n, const lp_dyadic_rational_t* x, lp_dyadic_rational_t* values);
+
+/**
+ * Get the signs of the polynomial at the n given dyadic points. Only makes
+ * sense for polynomials in Z[x].
+ */
+void lp_upolynomial_sgn_many_dyadic(const lp_upolynomial_t* p, size_t n, const lp_dyadic_rational_t* x, int* sgns);
+
 /**
  * Compares two polynomials (lexicographic from highest coefficient) and
  * returns -1 if p < q, 0 if p == q, and 1 if p > q.
@@ -173,6 +200,13 @@ int lp_upolynomial_cmp(const lp_upolynomial_t* p, const lp_upolynomial_t* q);
  */
 lp_upolynomial_t* lp_upolynomial_subst_x_neg(const lp_upolynomial_t* f);
 
+/**
+ * Returns the Taylor shift 2^(n*d)*f(x + c) of f of degree d, for c = a/2^n.
+ * For integer c this is just f(x + c). For c with n > 0 the polynomial f
+ * should be in Z[x].
+ */
+lp_upolynomial_t* lp_upolynomial_taylor_shift(const lp_upolynomial_t* f, const lp_dyadic_rational_t* c);
+
 /**
  * Returns the polynomial -f.
  */
@@ -352,6 +386,20 @@ int lp_upolynomial_roots_count(const lp_upolynomial_t* p, const lp_rational_inte
  */
 void lp_upolynomial_roots_isolate(const lp_upolynomial_t* p, lp_algebraic_number_t* roots, size_t* roots_size);
 
+/**
+ * Returns the composed sum of f and g in Z[x], i.e. the polynomial of degree
+ * deg(f)*deg(g) whose roots are a + b, for all (complex) roots a of f and b of
+ * g. The result is primitive with positive leading coefficient.
+ */
+lp_upolynomial_t* lp_upolynomial_composed_sum(const lp_upolynomial_t* f, const lp_upolynomial_t* g);
+
+/**
+ * Returns the composed product of f and g in Z[x], i.e. the polynomial of
+ * degree deg(f)*deg(g) whose roots are a*b, for all (complex) roots a of f and
+ * b of g. The result is primitive with positive leading coefficient.
+ */
+lp_upolynomial_t* lp_upolynomial_composed_product(const lp_upolynomial_t* f, const lp_upolynomial_t* g);
+
 /**
  * Reverses the coefficient of p in place. The result polynomial is
  * p'(x) = x^n * p(1/x) = a_n + ... + a_0 * x^n
@@ -72,6 +72,13 @@ int lp_variable_order_print(const lp_variable_order_t* var_order, const lp_varia
 /** Return a string representation of the order */
 char* lp_variable_order_to_string(const lp_variable_order_t* var_order, const lp_variable_db_t* var_db);
 
+/**
+ * Get the modification epoch of the order. The epoch changes (increases)
+ * whenever the order changes, so objects ordered by the order can record it
+ * and skip checking their order while it stays the same.
+ */
+size_t lp_variable_order_get_epoch(const lp_variable_order_t* var_order);
+
 /** Return the variable list */
 const lp_variable_list_t* lp_variable_order_get_list(const lp_variable_order_t* var_order);
 
@@ -0,0 +1,16 @@
+from setuptools import setup, Extension, find_packages
+
+polypy = Extension('polypy',
+                    sources = ['polypyAlgebraicNumber.c', 'polypyAssignment.c', 'polypyInteger.c', 'polypyPolynomial.c', 'polypy.c', 'polypyUPolynomial.c', 'utils.c', 'polypyVariable.c', 'polypyVariableOrder.c', 'polypyValue.c', 'polypyInterval.c', 'polypyFeasibilitySet.c'],
+                    include_dirs = ['../include'],
+                    libraries = ['poly'],
+                    library_dirs = ['/usr/local/lib']
+)
+
+setup (name = 'polypy',
+       version = '0.1.9',
+       description = 'A library for symbolic computation with polynomials',
+       author = 'Dejan Jovanovic',
+       author_email = 'dejan@csl.sri.com',
+       url = 'https://github.com/SRI-CSL/libpoly',
+       ext_modules = [polypy])
@@ -0,0 +1,632 @@
+/**
+ * Copyright 2015, SRI International.
+ *
+ * This file is part of LibPoly.
+ *
+ * LibPoly is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LibPoly is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with LibPoly.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cad.h>
+#include <polynomial.h>
+#include <polynomial_hash_set.h>
+#include <assignment.h>
+#include <variable_db.h>
+#include <variable_order.h>
+#include <variable_list.h>
+#include <upolynomial.h>
+#include <algebraic_number.h>
+#include <dyadic_interval.h>
+#include <rational_interval.h>
+
+#include "cad/projection.h"
+#include "polynomial/polynomial.h"
+#include "polynomial/coefficient.h"
+#include "upolynomial/bounds.h"
+
+#include "utils/debug_trace.h"
+#include "utils/statistics.h"
+
+#include <stdlib.h>
+#include <assert.h>
+
+STAT_DECLARE(int, cad, cell)
+STAT_DECLARE(int, cad, cell_roots_near)
+STAT_DECLARE(int, cad, cell_roots_isolate)
+
+/** The roots of a polynomial closest to the sample value */
+typedef struct {
+  /** Largest root below the sample value (LP_VALUE_NONE if none) */
+  lp_value_t lower;
+  /** The sample value, if a root (LP_VALUE_NONE otherwise) */
+  lp_value_t section;
+  /** Smallest root above the sample value (LP_VALUE_NONE if none) */
+  lp_value_t upper;
+  /** Number of roots below the sample value */
+  size_t below;
+} cell_roots_t;
+
+static
+void cell_roots_construct(cell_roots_t* roots) {
+  lp_value_construct_none(&roots->lower);
+  lp_value_construct_none(&roots->section);
+  lp_value_construct_none(&roots->upper);
+  roots->below = 0;
+}
+
+static
+void cell_roots_destruct(cell_roots_t* roots) {
+  lp_value_destruct(&roots->lower);
+  lp_value_destruct(&roots->section);
+  lp_value_destruct(&roots->upper);
+}
+
+/** Number of roots of f in the open interval between a and b (a != b) */
+static
+int cell_count(const lp_upolynomial_t* f, const lp_dyadic_rational_t* a, const lp_dyadic_rational_t* b) {
+  lp_rational_interval_t I;
+  if (lp_dyadic_rational_cmp(a, b) < 0) {
+    lp_rational_interval_construct_from_dyadic(&I, a, 1, b, 1);
+  } else {
+    lp_rational_interval_construct_from_dyadic(&I, b, 1, a, 1);
+  }
+  int count = lp_upolynomial_roots_count(f, &I);
+  lp_rational_interval_destruct(&I);
+  return count;
+}
+
+/** Construct v as the only root of f in the open interval (a, b) */
+static
+void cell_root_construct(lp_value_t* v, const lp_upolynomial_t* f, const lp_dyadic_rational_t* a, const lp_dyadic_rational_t* b) {
+
+  // The algebraic number needs a square-free primitive polynomial
+  lp_upolynomial_t* f_d = lp_upolynomial_derivative(f);
+  lp_upolynomial_t* gcd = lp_upolynomial_gcd(f, f_d);
+  lp_upolynomial_t* g = lp_upolynomial_div_exact(f, gcd);
+  lp_upolynomial_make_primitive_Z(g);
+  lp_upolynomial_delete(f_d);
+  lp_upolynomial_delete(gcd);
+
+  // ... with a non-zero constant term
+  if (!lp_upolynomial_const_term(g)) {
+    if (lp_dyadic_rational_sgn(a) < 0 && lp_dyadic_rational_sgn(b) > 0) {
+      lp_upolynomial_delete(g);
+      lp_value_construct_zero(v);
+      return;
+    }
+    lp_upolynomial_t* x = lp_upolynomial_construct_power(lp_Z, 1, 1);
+    lp_upolynomial_t* g_x = lp_upolynomial_div_exact(g, x);
+    lp_upolynomial_delete(x);
+    lp_upolynomial_delete(g);
+    g = g_x;
+  }
+
+  lp_dyadic_interval_t I;
+  lp_dyadic_interval_construct(&I, a, 1, b, 1);
+  lp_algebraic_number_t root;
+  lp_algebraic_number_construct(&root, g, &I);
+  lp_value_construct(v, LP_VALUE_ALGEBRAIC, &root);
+  lp_algebraic_number_destruct(&root);
+  lp_dyadic_interval_destruct(&I);
+}
+
+/**
+ * Construct v as the root of f closest to s, in direction dir (-1 or 1). The
+ * root must exist, and s can only be a root if it is the sample value.
+ *
+ * We search exponentially away from s for an interval with roots, and then
+ * bisect towards s until the closest root is isolated.
+ */
+static
+void cell_root_near(lp_value_t* v, const lp_upolynomial_t* f, const lp_dyadic_rational_t* s, int dir) {
+
+  lp_dyadic_rational_t near, far, w, m;
+  lp_dyadic_rational_construct_copy(&near, s);
+  lp_dyadic_rational_construct(&far);
+  lp_dyadic_rational_construct_from_int(&w, 1, 0);
+  lp_dyadic_rational_construct(&m);
+
+  for (;;) {
+    if (dir > 0) {
+      lp_dyadic_rational_add(&far, s, &w);
+    } else {
+      lp_dyadic_rational_sub(&far, s, &w);
+    }
+    if (cell_count(f, &near, &far) > 0 || lp_upolynomial_sgn_at_dyadic_rational(f, &far) == 0) {
+      break;
+    }
+    lp_dyadic_rational_mul_2exp(&w, &w, 1);
+  }
+
+  for (;;) {
+    int count = cell_count(f, &near, &far);
+    int far_sgn = lp_upolynomial_sgn_at_dyadic_rational(f, &far);
+    if (count == 0) {
+      // The closest root is far
+      assert(far_sgn == 0);
+      lp_value_construct(v, LP_VALUE_DYADIC_RATIONAL, &far);
+      break;
+    }
+    if (count == 1 && far_sgn != 0 && lp_upolynomial_sgn_at_dyadic_rational(f, &near) != 0) {
+      if (dir > 0) {
+        cell_root_construct(v, f, &near, &far);
+      } else {
+        cell_root_construct(v, f, &far, &near);
+      }
+      break;
+    }
+    lp_dyadic_rational_add(&m, &near, &far);
+    lp_dyadic_rational_div_2exp(&m, &m, 1);
+    if (cell_count(f, &near, &m) > 0 || lp_upolynomial_sgn_at_dyadic_rational(f, &m) == 0) {
+      lp_dyadic_rational_swap(&far, &m);
+    } else {
+      lp_dyadic_rational_swap(&near, &m);
+    }
+  }
+
+  lp_dyadic_rational_destruct(&near);
+  lp_dyadic_rational_destruct(&far);
+  lp_dyadic_rational_destruct(&w);
+  lp_dyadic_rational_destruct(&m);
+}
+
+/**
+ * Get the roots of f closest to the rational sample value alpha, without
+ * isolating the other roots.
+ */
+static
+void cell_roots_near(cell_roots_t* roots, const lp_upolynomial_t* f, const lp_value_t* alpha) {
+
+  STAT_INCR(cad, cell_roots_near)
+
+  size_t total = lp_upolynomial_roots_count(f, 0);
+  if (total == 0) {
+    return;
+  }
+
+  lp_rational_t alpha_q;
+  lp_rational_construct(&alpha_q);
+  lp_value_get_rational(alpha, &alpha_q);
+
+  int is_root = lp_upolynomial_sgn_at_rational(f, &alpha_q) == 0;
+
+  // Roots below alpha, all roots are in (-B, B)
+  lp_integer_t B;
+  lp_integer_construct(&B);
+  upolynomial_root_bound_cauchy(f, &B);
+  lp_integer_neg(lp_Z, &B, &B);
+  if (lp_rational_cmp_integer(&alpha_q, &B) > 0) {
+    lp_rational_t B_q;
+    lp_rational_construct_from_integer(&B_q, &B);
+    lp_rational_interval_t I;
+    lp_rational_interval_construct(&I, &B_q, 1, &alpha_q, 1);
+    roots->below = lp_upolynomial_roots_count(f, &I);
+    lp_rational_interval_destruct(&I);
+    lp_rational_destruct(&B_q);
+  }
+  lp_integer_destruct(&B);
+
+  // Dyadic s_lo <= alpha <= s_hi with no roots in [s_lo, s_hi] other than
+  // alpha, we search for the closest roots from there
+  lp_dyadic_rational_t s_lo, s_hi;
+  lp_dyadic_rational_construct(&s_lo);
+  lp_dyadic_rational_construct(&s_hi);
+  lp_integer_t floor;
+  lp_integer_construct(&floor);
+  lp_rational_t alpha_k;
+  lp_rational_construct(&alpha_k);
+  unsigned k;
+  for (k = 0; ; ++ k) {
+    lp_rational_mul_2exp(&alpha_k, &alpha_q, k);
+    lp_rational_floor(&alpha_k, &floor);
+    lp_dyadic_rational_destruct(&s_lo);
+    lp_dyadic_rational_construct_from_integer(&s_lo, &floor);
+    lp_dyadic_rational_div_2exp(&s_lo, &s_lo, k);
+    if (lp_dyadic_rational_cmp_rational(&s_lo, &alpha_q) == 0) {
+      lp_dyadic_rational_assign(&s_hi, &s_lo);
+      break;
+    }
+    lp_dyadic_rational_assign_int(&s_hi, 1, k);
+    lp_dyadic_rational_add(&s_hi, &s_lo, &s_hi);
+    if (lp_upolynomial_sgn_at_dyadic_rational(f, &s_lo) != 0 &&
+        lp_upolynomial_sgn_at_dyadic_rational(f, &s_hi) != 0 &&
+        cell_count(f, &s_lo, &s_hi) == is_root) {
+      break;
+    }
+  }
+  lp_rational_destruct(&alpha_k);
+  lp_integer_destruct(&floor);
+
+  if (roots->below > 0) {
+    lp_value_destruct(&roots->lower);
+    cell_root_near(&roots->lower, f, &s_lo, -1);
+  }
+  if (is_root) {
+    lp_value_destruct(&roots->section);
+    lp_value_construct_copy(&roots->section, alpha);
+  }
+  if (roots->below + is_root < total) {
+    lp_value_destruct(&roots->upper);
+    cell_root_near(&roots->upper, f, &s_hi, 1);
+  }
+
+  lp_dyadic_rational_destruct(&s_lo);
+  lp_dyadic_rational_destruct(&s_hi);
+  lp_rational_destruct(&alpha_q);
+}
+
+/** Get the roots of A (top variable unassigned in m) closest to alpha */
+static
+void cell_roots(cell_roots_t* roots, const lp_polynomial_t* A, const lp_assignment_t* m, const lp_value_t* alpha) {
+
+  const lp_polynomial_context_t* ctx = A->ctx;
+
+  // If the lower values are rational, we get a univariate polynomial and only
+  // look for the roots close to alpha
+  if (lp_value_is_rational(alpha)) {
+    coefficient_t A_rat;
+    lp_integer_t multiplier;
+    lp_integer_construct(&multiplier);
+    coefficient_construct(ctx, &A_rat);
+    coefficient_evaluate_rationals(ctx, &A->data, m, &A_rat, &multiplier);
+    int univariate = coefficient_is_univariate(&A_rat);
+    if (univariate) {
+      assert(coefficient_top_variable(&A_rat) == lp_polynomial_top_variable(A));
+      lp_upolynomial_t* f = coefficient_to_univariate(ctx, &A_rat);
+      cell_roots_near(roots, f, alpha);
+      lp_upolynomial_delete(f);
+    }
+    coefficient_destruct(&A_rat);
+    lp_integer_destruct(&multiplier);
+    if (univariate) {
+      return;
+    }
+  }
+
+  STAT_INCR(cad, cell_roots_isolate)
+
+  // Otherwise isolate all the roots (sorted)
+  size_t i, size = 0, deg = lp_polynomial_degree(A);
+  lp_value_t* values = malloc(sizeof(lp_value_t)*deg);
+  lp_polynomial_roots_isolate(A, m, values, &size);
+  for (i = 0; i < size; ++ i) {
+    int cmp = lp_value_cmp(values + i, alpha);
+    if (cmp < 0) {
+      roots->below = i + 1;
+      lp_value_destruct(&roots->lower);
+      lp_value_construct_copy(&roots->lower, values + i);
+    } else if (cmp == 0) {
+      lp_value_destruct(&roots->section);
+      lp_value_construct_copy(&roots->section, values + i);
+    } else if (roots->upper.type == LP_VALUE_NONE) {
+      lp_value_destruct(&roots->upper);
+      lp_value_construct_copy(&roots->upper, values + i);
+    }
+    lp_value_destruct(values + i);
+  }
+  free(values);
+}
+
+typedef struct {
+  /** The variables, from the bottom */
+  const lp_variable_list_t* vars;
+  /** Polynomials per level (top variable), pairwise different */
+  cad_polynomial_list_t* levels;
+  /** All polynomials added so far */
+  lp_polynomial_hash_set_t added;
+} cell_polynomials_t;
+
+/** Add the factors of p to their levels */
+static
+void cell_polynomials_add(cell_polynomials_t* P, const lp_polynomial_t* p) {
+  cad_polynomial_list_t factors;
+  cad_polynomial_list_construct(&factors);
+  cad_add_factors(&factors, p);
+  size_t i;
+  for (i = 0; i < factors.size; ++ i) {
+    lp_polynomial_t* f = factors.list[i];
+    if (lp_polynomial_hash_set_insert(&P->added, f)) {
+      int level = lp_variable_list_index(P->vars, lp_polynomial_top_variable(f));
+      assert(level >= 0);
+      cad_polynomial_list_push(P->levels + level, f);
+    } else {
+      lp_polynomial_delete(f);
+    }
+  }
+  factors.size = 0;
+  cad_polynomial_list_destruct(&factors);
+}
+
+/** Add the square-free factors of res(f, g) (or res(f, f') if g is 0) */
+static
+void cell_polynomials_add_resultant(cell_polynomials_t* P, const lp_polynomial_t* f, const lp_polynomial_t* g) {
+  const lp_polynomial_context_t* ctx = lp_polynomial_get_context(f);
+  lp_polynomial_t res, f_d;
+  lp_polynomial_construct(&res, ctx);
+  if (g) {
+    lp_polynomial_resultant(&res, f, g);
+  } else {
+    lp_polynomial_construct(&f_d, ctx);
+    lp_polynomial_derivative(&f_d, f);
+    lp_polynomial_resultant(&res, f, &f_d);
+    lp_polynomial_destruct(&f_d);
+  }
+  cell_polynomials_add(P, &res);
+  lp_polynomial_destruct(&res);
+}
+
+static
+void cad_root_construct_infinity(lp_cad_root_t* root, lp_value_type_t type) {
+  root->p = 0;
+  root->index = 0;
+  lp_value_construct(&root->value, type, 0);
+}
+
+static
+void cad_root_construct(lp_cad_root_t* root, const lp_polynomial_t* p, size_t index, const lp_value_t* value) {
+  root->p = lp_polynomial_new_copy(p);
+  root->index = index;
+  lp_value_construct_copy(&root->value, value);
+}
+
+static
+void cad_root_destruct(lp_cad_root_t* root) {
+  if (root->p) {
+    lp_polynomial_delete(root->p);
+  }
+  lp_value_destruct(&root->value);
+}
+
+static
+int cad_root_print(const lp_cad_root_t* root, FILE* out) {
+  int ret = 0;
+  if (root->p) {
+    ret += fprintf(out, "root(");
+    ret += lp_polynomial_print(root->p, out);
+    ret += fprintf(out, ", %zu) = ", root->index);
+  }
+  ret += lp_value_print(&root->value, out);
+  return ret;
+}
+
+/**
+ * Compute the bounds of the cell in the variable of the level, and add the
+ * polynomials that need to be sign-invariant over the lower levels. The
+ * variable must be unassigned in m.
+ */
+static
+void cell_level(cell_polynomials_t* P, size_t i, const lp_assignment_t* m, const lp_value_t* alpha, lp_cad_cell_level_t* level) {
+
+  cad_polynomial_list_t* polys = P->levels + i;
+  cad_square_free_basis(polys);
+
+  size_t j, k, size = polys->size;
+
+  // The reductums over the sample, 0 if no roots
+  lp_polynomial_t** reductums = calloc(size ? size : 1, sizeof(lp_polynomial_t*));
+
+  // The bounds (index into the polynomials)
+  int lower = -1, section = -1, upper = -1;
+  cell_roots_t bounds;
+  cell_roots_construct(&bounds);
+
+  for (j = 0; j < size; ++ j) {
+    const lp_polynomial_t* p = polys->list[j];
+    const lp_polynomial_context_t* ctx = lp_polynomial_get_context(p);
+
+    // Leading coefficients, until one doesn't vanish at the sample. If all
+    // vanish, p vanishes over the cell.
+    lp_polynomial_t c;
+    lp_polynomial_construct(&c, ctx);
+    int sgn = 0;
+    for (k = lp_polynomial_degree(p) + 1; k > 0 && !sgn; -- k) {
+      lp_polynomial_get_coefficient(&c, p, k - 1);
+      cell_polynomials_add(P, &c);
+      sgn = lp_polynomial_sgn(&c, m);
+    }
+    lp_polynomial_destruct(&c);
+    if (!sgn || k == 0) {
+      // Vanishes, or a non-zero constant over the cell
+      continue;
+    }
+
+    lp_polynomial_t* R = lp_polynomial_new(ctx);
+    lp_polynomial_reductum_m(R, p, m);
+    reductums[j] = R;
+
+    cell_roots_t roots;
+    cell_roots_construct(&roots);
+    cell_roots(&roots, R, m, alpha);
+
+    // Closest bounds, preferring lower degrees
+    size_t deg = lp_polynomial_degree(R);
+    if (roots.section.type != LP_VALUE_NONE) {
+      if (section < 0 || deg < lp_polynomial_degree(reductums[section])) {
+        section = j;
+        bounds.below = roots.below;
+      }
+    }
+    if (roots.lower.type != LP_VALUE_NONE) {
+      int cmp = lower < 0 ? 1 : lp_value_cmp(&roots.lower, &bounds.lower);
+      if (cmp > 0 || (cmp == 0 && deg < lp_polynomial_degree(reductums[lower]))) {
+        lower = j;
+        lp_value_swap(&roots.lower, &bounds.lower);
+        level->lower.index = roots.below - 1;
+      }
+    }
+    if (roots.upper.type != LP_VALUE_NONE) {
+      int cmp = upper < 0 ? -1 : lp_value_cmp(&roots.upper, &bounds.upper);
+      if (cmp < 0 || (cmp == 0 && deg < lp_polynomial_degree(reductums[upper]))) {
+        upper = j;
+        lp_value_swap(&roots.upper, &bounds.upper);
+        level->upper.index = roots.below + (roots.section.type != LP_VALUE_NONE);
+      }
+    }
+
+    cell_roots_destruct(&roots);
+  }
+
+  // Discriminants
+  for (j = 0; j < size; ++ j) {
+    if (reductums[j] && lp_polynomial_degree(reductums[j]) > 1) {
+      cell_polynomials_add_resultant(P, reductums[j], 0);
+    }
+  }
+
+  // Resultants with the bounds
+  level->is_section = section >= 0;
+  if (section >= 0) {
+    for (j = 0; j < size; ++ j) {
+      if (reductums[j] && (int) j != section) {
+        cell_polynomials_add_resultant(P, reductums[section], reductums[j]);
+      }
+    }
+    cad_root_construct(&level->lower, polys->list[section], bounds.below, alpha);
+    cad_root_construct(&level->upper, polys->list[section], bounds.below, alpha);
+  } else {
+    for (j = 0; j < size; ++ j) {
+      if (reductums[j] && lower >= 0 && (int) j != lower) {
+        cell_polynomials_add_resultant(P, reductums[lower], reductums[j]);
+      }
+      if (reductums[j] && upper >= 0 && (int) j != upper && (int) j != lower) {
+        cell_polynomials_add_resultant(P, reductums[upper], reductums[j]);
+      }
+    }
+    if (lower >= 0) {
+      cad_root_construct(&level->lower, polys->list[lower], level->lower.index, &bounds.lower);
+    } else {
+      cad_root_construct_infinity(&level->lower, LP_VALUE_MINUS_INFINITY);
+    }
+    if (upper >= 0) {
+      cad_root_construct(&level->upper, polys->list[upper], level->upper.index, &bounds.upper);
+    } else {
+      cad_root_construct_infinity(&level->upper, LP_VALUE_PLUS_INFINITY);
+    }
+  }
+
+  for (j = 0; j < size; ++ j) {
+    if (reductums[j]) {
+      lp_polynomial_delete(reductums[j]);
+    }
+  }
+  free(reductums);
+  cell_roots_destruct(&bounds);
+}
+
+lp_cad_cell_t* lp_cad_cell_new(const lp_polynomial_hash_set_t* polynomials, const lp_variable_order_t* order, const lp_assignment_t* m) {
+
+  STAT_INCR(cad, cell)
+
+  if (trace_is_enabled("cad")) {
+    tracef("cad_cell_new("); lp_polynomial_hash_set_print(polynomials, trace_out);
+    tracef(", "); lp_assignment_print(m, trace_out); tracef(")\n");
+  }
+
+  const lp_variable_list_t* vars = lp_variable_order_get_list(order);
+  size_t i, n = vars->list_size;
+
+  lp_cad_cell_t* cell = malloc(sizeof(lp_cad_cell_t));
+  cell->size = n;
+  cell->levels = malloc(sizeof(lp_cad_cell_level_t)*n);
+  lp_polynomial_hash_set_construct(&cell->projection);
+  cell->var_db = m->var_db;
+  lp_variable_db_attach((lp_variable_db_t*) cell->var_db);
+
+  cell_polynomials_t P;
+  P.vars = vars;
+  P.levels = malloc(sizeof(cad_polynomial_list_t)*(n ? n : 1));
+  for (i = 0; i < n; ++ i) {
+    cad_polynomial_list_construct(P.levels + i);
+  }
+  lp_polynomial_hash_set_construct(&P.added);
+
+  // The sample, we unassign the variables as we go down
+  lp_assignment_t sample;
+  lp_assignment_construct(&sample, m->var_db);
+  for (i = 0; i < n; ++ i) {
+    lp_variable_t x = vars->list[i];
+    assert(lp_assignment_get_value(m, x)->type != LP_VALUE_NONE);
+    lp_assignment_set_value(&sample, x, lp_assignment_get_value(m, x));
+  }
+
+  size_t data_size = polynomials->closed ? polynomials->size : polynomials->data_size;
+  for (i = 0; i < data_size; ++ i) {
+    if (polynomials->data[i]) {
+      cell_polynomials_add(&P, polynomials->data[i]);
+    }
+  }
+
+  lp_value_t alpha;
+  for (i = n; i > 0; -- i) {
+    lp_variable_t x = vars->list[i - 1];
+    lp_value_construct_copy(&alpha, lp_assignment_get_value(&sample, x));
+    lp_assignment_set_value(&sample, x, 0);
+    cell->levels[i - 1].x = x;
+    cell_level(&P, i - 1, &sample, &alpha, cell->levels + i - 1);
+    lp_value_destruct(&alpha);
+  }
+
+  for (i = 0; i < n; ++ i) {
+    size_t j;
+    for (j = 0; j < P.levels[i].size; ++ j) {
+      lp_polynomial_hash_set_insert(&cell->projection, P.levels[i].list[j]);
+    }
+    cad_polynomial_list_destruct(P.levels + i);
+  }
+  lp_polynomial_hash_set_close(&cell->projection);
+
+  free(P.levels);
+  lp_polynomial_hash_set_destruct(&P.added);
+  lp_assignment_destruct(&sample);
+
+  if (trace_is_enabled("cad")) {
+    tracef("cad_cell_new() => "); lp_cad_cell_print(cell, trace_out); tracef("\n");
+  }
+
+  return cell;
+}
+
+void lp_cad_cell_delete(lp_cad_cell_t* cell) {
+  size_t i;
+  for (i = 0; i < cell->size; ++ i) {
+    cad_root_destruct(&cell->levels[i].lower);
+    cad_root_destruct(&cell->levels[i].upper);
+  }
+  free(cell->levels);
+  lp_polynomial_hash_set_destruct(&cell->projection);
+  lp_variable_db_detach((lp_variable_db_t*) cell->var_db);
+  free(cell);
+}
+
+int lp_cad_cell_print(const lp_cad_cell_t* cell, FILE* out) {
+  int ret = 0;
+  size_t i;
+  ret += fprintf(out, "[");
+  for (i = 0; i < cell->size; ++ i) {
+    const lp_cad_cell_level_t* level = cell->levels + i;
+    const char* x = lp_variable_db_get_name(cell->var_db, level->x);
+    if (i) {
+      ret += fprintf(out, ", ");
+    }
+    if (level->is_section) {
+      ret += fprintf(out, "%s = ", x);
+      ret += cad_root_print(&level->lower, out);
+    } else {
+      ret += cad_root_print(&level->lower, out);
+      ret += fprintf(out, " < %s < ", x);
+      ret += cad_root_print(&level->upper, out);
+    }
+  }
+  ret += fprintf(out, "]");
+  return ret;
+}
@@ -0,0 +1,288 @@
+/**
+ * Copyright 2015, SRI International.
+ *
+ * This file is part of LibPoly.
+ *
+ * LibPoly is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LibPoly is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with LibPoly.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cad.h>
+#include <polynomial.h>
+#include <polynomial_context.h>
+#include <polynomial_hash_set.h>
+#include <assignment.h>
+#include <variable_order.h>
+#include <variable_list.h>
+#include <upolynomial.h>
+#include <algebraic_number.h>
+
+#include "cad/projection.h"
+#include "number/algebraic_number.h"
+#include "polynomial/polynomial.h"
+#include "polynomial/polynomial_context.h"
+
+#include "utils/thread_pool.h"
+#include "utils/debug_trace.h"
+#include "utils/statistics.h"
+
+#include <stdlib.h>
+#include <assert.h>
+
+STAT_DECLARE(int, cad, lift)
+
+/**
+ * Per-thread data. Root isolation changes the assignment and the variable
+ * order of the context while it runs, so each thread has its own, with its
+ * own copy of the polynomials.
+ */
+typedef struct {
+  /** Scratch copy of the polynomial context */
+  lp_polynomial_context_t* ctx;
+  /** The assignment of the sample being lifted */
+  lp_assignment_t m;
+  /** The polynomials of each level, in ctx */
+  cad_polynomial_list_t* levels;
+} lift_scratch_t;
+
+typedef struct {
+  /** Per-thread data */
+  lift_scratch_t* scratch;
+  /** Number of scratch entries */
+  size_t scratch_size;
+  /** The variable of the level being lifted */
+  lp_variable_t x;
+  /** The level being lifted */
+  size_t level;
+  /** The samples to lift */
+  lp_cad_sample_t** samples;
+  /** Number of samples to lift */
+  size_t samples_size;
+} lift_t;
+
+static
+void lift_sample_construct(lp_cad_sample_t* sample, lp_variable_t x, lp_cad_sample_t* parent) {
+  sample->x = x;
+  lp_value_construct_none(&sample->value);
+  sample->is_section = 0;
+  sample->parent = parent;
+  sample->children = 0;
+  sample->children_size = 0;
+}
+
+static
+void lift_sample_destruct(lp_cad_sample_t* sample) {
+  size_t i;
+  for (i = 0; i < sample->children_size; ++ i) {
+    lift_sample_destruct(sample->children + i);
+  }
+  free(sample->children);
+  lp_value_destruct(&sample->value);
+}
+
+/**
+ * Roots from root isolation share a root set, which they update when
+ * refined. Since the siblings can be lifted by different threads, we give each
+ * root its own polynomial.
+ */
+static
+void lift_value_detach(lp_value_t* v) {
+  if (v->type == LP_VALUE_ALGEBRAIC && lp_algebraic_number_has_root_set(&v->value.a)) {
+    lp_algebraic_number_t a;
+    lp_algebraic_number_construct(&a, lp_upolynomial_construct_copy(v->value.a.f), &v->value.a.I);
+    lp_algebraic_number_swap(&a, &v->value.a);
+    lp_algebraic_number_destruct(&a);
+  }
+}
+
+/** Lift one sample, only touches the sample and the scratch of the thread */
+static
+void lift_job_run(size_t job, size_t thread, void* data) {
+  lift_t* lift = (lift_t*) data;
+  lp_cad_sample_t* sample = lift->samples[job];
+  lift_scratch_t* scratch = lift->scratch + thread;
+
+  assert(thread < lift->scratch_size);
+
+  lp_value_t* roots = 0;
+  size_t i, roots_size = 0;
+
+  cad_polynomial_list_t* polys = scratch->levels ? scratch->levels + lift->level : 0;
+  if (polys && polys->size) {
+
+    // Assignment of the sample
+    const lp_cad_sample_t* s;
+    for (s = sample; s->parent; s = s->parent) {
+      lp_assignment_set_value(&scratch->m, s->x, &s->value);
+    }
+
+    // Roots of all polynomials
+    size_t capacity = 0;
+    for (i = 0; i < polys->size; ++ i) {
+      capacity += lp_polynomial_degree(polys->list[i]);
+    }
+    roots = malloc(sizeof(lp_value_t)*capacity);
+    for (i = 0; i < polys->size; ++ i) {
+      size_t size = 0;
+      lp_polynomial_roots_isolate(polys->list[i], &scratch->m, roots + roots_size, &size);
+      roots_size += size;
+    }
+
+    // Sort and remove duplicates
+    qsort(roots, roots_size, sizeof(lp_value_t), lp_value_cmp_void);
+    size_t to_keep = 0;
+    for (i = 0; i < roots_size; ++ i) {
+      if (to_keep > 0 && lp_value_cmp(roots + to_keep - 1, roots + i) == 0) {
+        lp_value_destruct(roots + i);
+      } else {
+        roots[to_keep ++] = roots[i];
+      }
+    }
+    roots_size = to_keep;
+  }
+
+  // Sectors and sections
+  lp_value_t minus_inf, plus_inf;
+  lp_value_construct(&minus_inf, LP_VALUE_MINUS_INFINITY, 0);
+  lp_value_construct(&plus_inf, LP_VALUE_PLUS_INFINITY, 0);
+  sample->children_size = 2*roots_size + 1;
+  sample->children = malloc(sizeof(lp_cad_sample_t)*sample->children_size);
+  for (i = 0; i < sample->children_size; ++ i) {
+    lp_cad_sample_t* child = sample->children + i;
+    lift_sample_construct(child, lift->x, sample);
+    if (i % 2) {
+      child->is_section = 1;
+      lp_value_destruct(&child->value);
+      lp_value_construct_copy(&child->value, roots + i/2);
+      lift_value_detach(&child->value);
+    } else {
+      const lp_value_t* lower = i ? roots + i/2 - 1 : &minus_inf;
+      const lp_value_t* upper = i/2 < roots_size ? roots + i/2 : &plus_inf;
+      lp_value_destruct(&child->value);
+      lp_value_construct_zero(&child->value);
+      lp_value_get_value_between(lower, 1, upper, 1, &child->value);
+    }
+  }
+  lp_value_destruct(&minus_inf);
+  lp_value_destruct(&plus_inf);
+
+  for (i = 0; i < roots_size; ++ i) {
+    lp_value_destruct(roots + i);
+  }
+  free(roots);
+}
+
+lp_cad_sample_t* lp_cad_lift(const lp_polynomial_hash_set_t* polynomials, const lp_variable_order_t* order) {
+
+  STAT_INCR(cad, lift)
+
+  if (trace_is_enabled("cad")) {
+    tracef("cad_lift("); lp_polynomial_hash_set_print(polynomials, trace_out); tracef(")\n");
+  }
+
+  const lp_variable_list_t* vars = lp_variable_order_get_list(order);
+  size_t i, j, k, n = vars->list_size;
+
+  lp_cad_sample_t* root = malloc(sizeof(lp_cad_sample_t));
+  lift_sample_construct(root, lp_variable_null, 0);
+
+  // The polynomials, cleaned up here as they might be reordered
+  const lp_polynomial_context_t* ctx = 0;
+  size_t data_size = polynomials->closed ? polynomials->size : polynomials->data_size;
+  for (i = 0; i < data_size; ++ i) {
+    const lp_polynomial_t* p = polynomials->data[i];
+    if (p && !lp_polynomial_is_constant(p)) {
+      lp_polynomial_top_variable(p);
+      ctx = lp_polynomial_get_context(p);
+    }
+  }
+
+  // Per-thread data, all attaching to shared objects is done here
+  lift_t lift;
+  lift.scratch_size = thread_pool_threads;
+  lift.scratch = malloc(sizeof(lift_scratch_t)*lift.scratch_size);
+  for (k = 0; k < lift.scratch_size; ++ k) {
+    lift_scratch_t* scratch = lift.scratch + k;
+    scratch->ctx = 0;
+    scratch->levels = 0;
+    if (!ctx) {
+      continue;
+    }
+    scratch->ctx = lp_polynomial_context_new_scratch(ctx);
+    lp_assignment_construct(&scratch->m, ctx->var_db);
+    scratch->levels = malloc(sizeof(cad_polynomial_list_t)*(n ? n : 1));
+    for (j = 0; j < n; ++ j) {
+      cad_polynomial_list_construct(scratch->levels + j);
+    }
+    for (i = 0; i < data_size; ++ i) {
+      const lp_polynomial_t* p = polynomials->data[i];
+      if (p && !lp_polynomial_is_constant(p)) {
+        int level = lp_variable_list_index(vars, lp_polynomial_top_variable(p));
+        assert(level >= 0);
+        cad_polynomial_list_push(scratch->levels + level, lp_polynomial_new_from_coefficient(scratch->ctx, &p->data));
+      }
+    }
+  }
+
+  // Lift level by level, all samples of the level in parallel
+  lift.samples = malloc(sizeof(lp_cad_sample_t*));
+  lift.samples[0] = root;
+  lift.samples_size = 1;
+  for (lift.level = 0; lift.level < n; ++ lift.level) {
+    lift.x = vars->list[lift.level];
+    TRACE("cad", "cad_lift(): lifting %zu samples\n", lift.samples_size);
+    thread_pool_run(lift.samples_size, lift_job_run, &lift);
+
+    // Next level, in order
+    size_t next_size = 0;
+    for (i = 0; i < lift.samples_size; ++ i) {
+      next_size += lift.samples[i]->children_size;
+    }
+    lp_cad_sample_t** next = malloc(sizeof(lp_cad_sample_t*)*next_size);
+    for (i = 0, k = 0; i < lift.samples_size; ++ i) {
+      for (j = 0; j < lift.samples[i]->children_size; ++ j) {
+        next[k ++] = lift.samples[i]->children + j;
+      }
+    }
+    free(lift.samples);
+    lift.samples = next;
+    lift.samples_size = next_size;
+  }
+  free(lift.samples);
+
+  for (k = 0; k < lift.scratch_size; ++ k) {
+    lift_scratch_t* scratch = lift.scratch + k;
+    if (scratch->ctx) {
+      for (j = 0; j < n; ++ j) {
+        cad_polynomial_list_destruct(scratch->levels + j);
+      }
+      free(scratch->levels);
+      lp_assignment_destruct(&scratch->m);
+      lp_polynomial_context_detach(scratch->ctx);
+    }
+  }
+  free(lift.scratch);
+
+  return root;
+}
+
+void lp_cad_sample_delete(lp_cad_sample_t* root) {
+  lift_sample_destruct(root);
+  free(root);
+}
+
+void lp_cad_sample_get_assignment(const lp_cad_sample_t* sample, lp_assignment_t* m) {
+  for (; sample->parent; sample = sample->parent) {
+    lp_assignment_set_value(m, sample->x, &sample->value);
+  }
+}
@@ -0,0 +1,381 @@
+/**
+ * Copyright 2015, SRI International.
+ *
+ * This file is part of LibPoly.
+ *
+ * LibPoly is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LibPoly is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with LibPoly.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cad.h>
+#include <polynomial.h>
+#include <polynomial_hash_set.h>
+
+#include "cad/projection.h"
+#include "polynomial/polynomial.h"
+
+#include "utils/thread_pool.h"
+#include "utils/debug_trace.h"
+#include "utils/statistics.h"
+
+#include <stdlib.h>
+#include <assert.h>
+
+STAT_DECLARE(int, cad, project)
+STAT_DECLARE(int, cad, project_basis_splits)
+
+void cad_polynomial_list_construct(cad_polynomial_list_t* list) {
+  list->list = 0;
+  list->size = 0;
+  list->capacity = 0;
+}
+
+void cad_polynomial_list_destruct(cad_polynomial_list_t* list) {
+  size_t i;
+  for (i = 0; i < list->size; ++ i) {
+    lp_polynomial_delete(list->list[i]);
+  }
+  free(list->list);
+}
+
+void cad_polynomial_list_push(cad_polynomial_list_t* list, lp_polynomial_t* p) {
+  if (list->size == list->capacity) {
+    list->capacity = list->capacity ? 2*list->capacity : 10;
+    list->list = realloc(list->list, sizeof(lp_polynomial_t*)*list->capacity);
+  }
+  list->list[list->size ++] = p;
+}
+
+void cad_add_factors(cad_polynomial_list_t* list, const lp_polynomial_t* p) {
+  if (lp_polynomial_is_constant(p)) {
+    return;
+  }
+
+  lp_polynomial_t** factors = 0;
+  size_t* multiplicities = 0;
+  size_t i, size = 0;
+  lp_polynomial_factor_square_free(p, &factors, &multiplicities, &size);
+
+  for (i = 0; i < size; ++ i) {
+    lp_polynomial_t* f = factors[i];
+    if (lp_polynomial_is_constant(f)) {
+      lp_polynomial_delete(f);
+    } else {
+      if (lp_polynomial_lc_sgn(f) < 0) {
+        lp_polynomial_neg(f, f);
+      }
+      cad_polynomial_list_push(list, f);
+    }
+  }
+
+  free(factors);
+  free(multiplicities);
+}
+
+typedef enum {
+  /** Square-free factors of f */
+  PROJECTION_FACTOR,
+  /** Square-free factors of res(f, f') */
+  PROJECTION_DISCRIMINANT,
+  /** Square-free factors of res(f, g) */
+  PROJECTION_RESULTANT
+} projection_job_type_t;
+
+typedef struct {
+  projection_job_type_t type;
+  const lp_polynomial_t* f;
+  const lp_polynomial_t* g;
+  /** The result (primitive square-free factors) */
+  cad_polynomial_list_t factors;
+} projection_job_t;
+
+typedef struct {
+  projection_job_t* jobs;
+  size_t size;
+  size_t capacity;
+} projection_jobs_t;
+
+static
+void projection_jobs_construct(projection_jobs_t* jobs) {
+  jobs->jobs = 0;
+  jobs->size = 0;
+  jobs->capacity = 0;
+}
+
+static
+void projection_jobs_destruct(projection_jobs_t* jobs) {
+  size_t i;
+  for (i = 0; i < jobs->size; ++ i) {
+    cad_polynomial_list_destruct(&jobs->jobs[i].factors);
+  }
+  free(jobs->jobs);
+}
+
+static
+void projection_jobs_add(projection_jobs_t* jobs, projection_job_type_t type, const lp_polynomial_t* f, const lp_polynomial_t* g) {
+  if (jobs->size == jobs->capacity) {
+    jobs->capacity = jobs->capacity ? 2*jobs->capacity : 10;
+    jobs->jobs = realloc(jobs->jobs, sizeof(projection_job_t)*jobs->capacity);
+  }
+  projection_job_t* job = jobs->jobs + jobs->size ++;
+  job->type = type;
+  job->f = f;
+  job->g = g;
+  cad_polynomial_list_construct(&job->factors);
+}
+
+static
+void projection_job_run(size_t i, size_t thread, void* data) {
+  (void) thread;
+  projection_job_t* job = ((projection_job_t*) data) + i;
+
+  if (job->type == PROJECTION_FACTOR) {
+    cad_add_factors(&job->factors, job->f);
+    return;
+  }
+
+  const lp_polynomial_context_t* ctx = lp_polynomial_get_context(job->f);
+  lp_polynomial_t res, f_d;
+  lp_polynomial_construct(&res, ctx);
+  if (job->type == PROJECTION_DISCRIMINANT) {
+    // The discriminant is res(f, f')/lc(f), but lc(f) is part of the
+    // projection anyhow so we don't bother dividing
+    lp_polynomial_construct(&f_d, ctx);
+    lp_polynomial_derivative(&f_d, job->f);
+    lp_polynomial_resultant(&res, job->f, &f_d);
+    lp_polynomial_destruct(&f_d);
+  } else {
+    lp_polynomial_resultant(&res, job->f, job->g);
+  }
+  cad_add_factors(&job->factors, &res);
+  lp_polynomial_destruct(&res);
+}
+
+/** Run all the jobs */
+static
+void projection_jobs_run(projection_jobs_t* jobs) {
+  TRACE("cad", "cad_project(): running %zu jobs\n", jobs->size);
+  thread_pool_run(jobs->size, projection_job_run, jobs->jobs);
+}
+
+/** Returns a new polynomial f/g (exact), with positive leading coefficient */
+static
+lp_polynomial_t* projection_div(const lp_polynomial_t* f, const lp_polynomial_t* g) {
+  lp_polynomial_t* result = lp_polynomial_new(lp_polynomial_get_context(f));
+  lp_polynomial_div(result, f, g);
+  if (lp_polynomial_lc_sgn(result) < 0) {
+    lp_polynomial_neg(result, result);
+  }
+  return result;
+}
+
+void cad_square_free_basis(cad_polynomial_list_t* polys) {
+
+  cad_polynomial_list_t basis;
+  cad_polynomial_list_construct(&basis);
+
+  while (polys->size) {
+    lp_polynomial_t* f = polys->list[-- polys->size];
+    const lp_polynomial_context_t* ctx = lp_polynomial_get_context(f);
+
+    lp_polynomial_t gcd;
+    lp_polynomial_construct(&gcd, ctx);
+
+    size_t i = 0;
+    while (i < basis.size && !lp_polynomial_is_constant(f)) {
+      lp_polynomial_t* g = basis.list[i];
+      lp_polynomial_gcd(&gcd, f, g);
+      if (lp_polynomial_is_constant(&gcd)) {
+        ++ i;
+        continue;
+      }
+
+      STAT_INCR(cad, project_basis_splits)
+
+      // Remove g from the basis, gcd and g/gcd go back to the work list
+      basis.list[i] = basis.list[-- basis.size];
+      cad_polynomial_list_push(polys, projection_div(g, &gcd));
+      if (lp_polynomial_lc_sgn(&gcd) < 0) {
+        lp_polynomial_neg(&gcd, &gcd);
+      }
+      cad_polynomial_list_push(polys, lp_polynomial_new_copy(&gcd));
+      lp_polynomial_delete(g);
+
+      // Continue with f/gcd
+      g = projection_div(f, &gcd);
+      lp_polynomial_delete(f);
+      f = g;
+    }
+
+    lp_polynomial_destruct(&gcd);
+
+    if (lp_polynomial_is_constant(f)) {
+      lp_polynomial_delete(f);
+    } else {
+      cad_polynomial_list_push(&basis, f);
+    }
+  }
+
+  cad_polynomial_list_t tmp = *polys;
+  *polys = basis;
+  cad_polynomial_list_destruct(&tmp);
+}
+
+/** Add the coefficients of f needed by the projection operator */
+static
+void projection_add_coefficients(lp_cad_projection_type_t type, const lp_polynomial_t* f, lp_polynomial_hash_set_t* coefficients) {
+
+  const lp_polynomial_context_t* ctx = lp_polynomial_get_context(f);
+  size_t deg = lp_polynomial_degree(f);
+
+  lp_polynomial_t c;
+  lp_polynomial_construct(&c, ctx);
+
+  size_t k;
+  switch (type) {
+  case LP_CAD_PROJECTION_MCCALLUM:
+    // All coefficients, but once one is constant the others don't matter
+    for (k = deg + 1; k > 0; -- k) {
+      lp_polynomial_get_coefficient(&c, f, k - 1);
+      if (lp_polynomial_is_constant(&c)) {
+        if (!lp_polynomial_is_zero(&c)) {
+          break;
+        }
+      } else {
+        lp_polynomial_hash_set_insert(coefficients, &c);
+      }
+    }
+    break;
+  case LP_CAD_PROJECTION_LAZARD:
+    // Leading and trailing (lowest non-zero) coefficient
+    for (k = 0; k <= deg; ++ k) {
+      lp_polynomial_get_coefficient(&c, f, k);
+      if (!lp_polynomial_is_zero(&c)) {
+        break;
+      }
+    }
+    if (!lp_polynomial_is_constant(&c)) {
+      lp_polynomial_hash_set_insert(coefficients, &c);
+    }
+    if (k < deg) {
+      lp_polynomial_get_coefficient(&c, f, deg);
+      if (!lp_polynomial_is_constant(&c)) {
+        lp_polynomial_hash_set_insert(coefficients, &c);
+      }
+    }
+    break;
+  }
+
+  lp_polynomial_destruct(&c);
+}
+
+/** Add the factors computed by the jobs to the set */
+static
+void projection_jobs_collect(projection_jobs_t* jobs, lp_variable_t x, cad_polynomial_list_t* level, lp_polynomial_hash_set_t* projection) {
+  lp_polynomial_hash_set_t level_set;
+  lp_polynomial_hash_set_construct(&level_set);
+  size_t i, j;
+  for (i = 0; i < jobs->size; ++ i) {
+    cad_polynomial_list_t* factors = &jobs->jobs[i].factors;
+    for (j = 0; j < factors->size; ++ j) {
+      lp_polynomial_t* f = factors->list[j];
+      if (level && lp_polynomial_top_variable(f) == x) {
+        if (lp_polynomial_hash_set_insert(&level_set, f)) {
+          cad_polynomial_list_push(level, f);
+          factors->list[j] = 0;
+        }
+      } else {
+        lp_polynomial_hash_set_insert(projection, f);
+      }
+      if (factors->list[j]) {
+        lp_polynomial_delete(f);
+      }
+    }
+    factors->size = 0;
+    cad_polynomial_list_destruct(factors);
+    cad_polynomial_list_construct(factors);
+  }
+  lp_polynomial_hash_set_destruct(&level_set);
+}
+
+void lp_cad_project(lp_cad_projection_type_t type, const lp_polynomial_hash_set_t* polynomials, lp_variable_t x,
+    lp_polynomial_hash_set_t* basis, lp_polynomial_hash_set_t* projection) {
+
+  STAT_INCR(cad, project)
+
+  if (trace_is_enabled("cad")) {
+    tracef("cad_project("); lp_polynomial_hash_set_print(polynomials, trace_out); tracef(")\n");
+  }
+
+  size_t i, j;
+  size_t data_size = polynomials->closed ? polynomials->size : polynomials->data_size;
+
+  // Square-free factors of the input
+  projection_jobs_t jobs;
+  projection_jobs_construct(&jobs);
+  for (i = 0; i < data_size; ++ i) {
+    const lp_polynomial_t* p = polynomials->data[i];
+    if (p) {
+      // Also reorders external polynomials, if needed, before going parallel
+      lp_polynomial_top_variable(p);
+      projection_jobs_add(&jobs, PROJECTION_FACTOR, p, 0);
+    }
+  }
+  projection_jobs_run(&jobs);
+
+  // Factors with top variable x go to the basis, others to the projection
+  cad_polynomial_list_t level;
+  cad_polynomial_list_construct(&level);
+  projection_jobs_collect(&jobs, x, &level, projection);
+  cad_square_free_basis(&level);
+  for (i = 0; i < level.size; ++ i) {
+    lp_polynomial_hash_set_insert(basis, level.list[i]);
+  }
+
+  // The projection operator: coefficients, discriminants and resultants
+  lp_polynomial_hash_set_t coefficients;
+  lp_polynomial_hash_set_construct(&coefficients);
+  for (i = 0; i < level.size; ++ i) {
+    projection_add_coefficients(type, level.list[i], &coefficients);
+  }
+  lp_polynomial_hash_set_close(&coefficients);
+
+  jobs.size = 0;
+  for (i = 0; i < coefficients.size; ++ i) {
+    projection_jobs_add(&jobs, PROJECTION_FACTOR, coefficients.data[i], 0);
+  }
+  for (i = 0; i < level.size; ++ i) {
+    if (lp_polynomial_degree(level.list[i]) > 1) {
+      projection_jobs_add(&jobs, PROJECTION_DISCRIMINANT, level.list[i], 0);
+    }
+  }
+  for (i = 0; i < level.size; ++ i) {
+    for (j = i + 1; j < level.size; ++ j) {
+      projection_jobs_add(&jobs, PROJECTION_RESULTANT, level.list[i], level.list[j]);
+    }
+  }
+  projection_jobs_run(&jobs);
+  projection_jobs_collect(&jobs, x, 0, projection);
+
+  projection_jobs_destruct(&jobs);
+  lp_polynomial_hash_set_destruct(&coefficients);
+  cad_polynomial_list_destruct(&level);
+
+  lp_polynomial_hash_set_close(basis);
+  lp_polynomial_hash_set_close(projection);
+
+  if (trace_is_enabled("cad")) {
+    tracef("cad_project() => "); lp_polynomial_hash_set_print(basis, trace_out);
+    tracef(", "); lp_polynomial_hash_set_print(projection, trace_out); tracef("\n");
+  }
+}
@@ -0,0 +1,51 @@
+/**
+ * Copyright 2015, SRI International.
+ *
+ * This file is part of LibPoly.
+ *
+ * LibPoly is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LibPoly is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with LibPoly.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <poly.h>
+
+/** A growable list of (owned) polynomials */
+typedef struct {
+  lp_polynomial_t** list;
+  size_t size;
+  size_t capacity;
+} cad_polynomial_list_t;
+
+void cad_polynomial_list_construct(cad_polynomial_list_t* list);
+
+/** Destruct the list, deleting all the polynomials */
+void cad_polynomial_list_destruct(cad_polynomial_list_t* list);
+
+/** Add p to the list, the list takes ownership */
+void cad_polynomial_list_push(cad_polynomial_list_t* list, lp_polynomial_t* p);
+
+/**
+ * Add the non-constant square-free factors of p to the list. The factors are
+ * primitive with positive leading coefficient.
+ */
+void cad_add_factors(cad_polynomial_list_t* list, const lp_polynomial_t* p);
+
+/**
+ * Refine the (primitive, square-free) polynomials into a set of pairwise
+ * coprime polynomials with the same roots: whenever two polynomials have a
+ * common factor, replace them with the factor and the cofactors. Polynomials
+ * might have their hash cached, so the results are always new polynomials.
+ */
+void cad_square_free_basis(cad_polynomial_list_t* polys);
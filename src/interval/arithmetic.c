@@ -202,6 +202,8 @@ int lp_value_add_approx(const lp_value_t* v1, const lp_value_t* v2, lp_value_t*
       lp_dyadic_rational_destruct(&add_dy);
       break;
     case LP_VALUE_ALGEBRAIC:
+      lp_algebraic_number_force_const(&v1->value.a);
+      lp_algebraic_number_force_const(&v2->value.a);
       if (v1->value.a.I.is_point && v2->value.a.I.is_point) {
         lp_dyadic_rational_construct(&add_dy);
         lp_dyadic_rational_add(&add_dy, &v1->value.a.I.a, &v2->value.a.I.a);
@@ -316,6 +318,7 @@ int lp_value_add_approx(const lp_value_t* v1, const lp_value_t* v2, lp_value_t*
       // we add them into (dy1 + v2, dy2 + v2)
 
       lp_value_t v1_lb, v1_ub;
+      lp_algebraic_number_force_const(&v1->value.a);
       const lp_dyadic_rational_t* a = &v1->value.a.I.a;
       const lp_dyadic_rational_t* b = v1->value.a.I.is_point ? a : &v1->value.a.I.b;
       lp_value_construct(&v1_lb, LP_VALUE_DYADIC_RATIONAL, a);
@@ -713,6 +716,8 @@ int lp_value_mul_approx(const lp_value_t* v1, const lp_value_t* v2, lp_value_t*
       lp_dyadic_rational_destruct(&mul_dy);
       break;
     case LP_VALUE_ALGEBRAIC:
+      lp_algebraic_number_force_const(&v1->value.a);
+      lp_algebraic_number_force_const(&v2->value.a);
       if (v1->value.a.I.is_point && v2->value.a.I.is_point) {
         lp_dyadic_rational_construct(&mul_dy);
         lp_dyadic_rational_mul(&mul_dy, &v1->value.a.I.a, &v2->value.a.I.a);
@@ -806,6 +811,7 @@ int lp_value_mul_approx(const lp_value_t* v1, const lp_value_t* v2, lp_value_t*
       // we add them into (dy1 * v2, dy2 * v2). if v2 is negative, we swap the bounds
 
       lp_value_t v1_lb, v1_ub;
+      lp_algebraic_number_force_const(&v1->value.a);
       const lp_dyadic_rational_t* a = &v1->value.a.I.a;
       const lp_dyadic_rational_t* b = v1->value.a.I.is_point ? a : &v1->value.a.I.b;
       lp_value_construct(&v1_lb, LP_VALUE_DYADIC_RATIONAL, a);
@@ -999,6 +1005,7 @@ int lp_value_pow_approx(const lp_value_t* v, unsigned n, lp_value_t* lb, lp_valu
     lp_dyadic_rational_destruct(&pow_dy);
     break;
   case LP_VALUE_ALGEBRAIC:
+    lp_algebraic_number_force_const(&v->value.a);
     if (v->value.a.I.is_point) {
       lp_dyadic_rational_construct(&pow_dy);
       dyadic_rational_pow(&pow_dy, &v->value.a.I.a, n);
@@ -0,0 +1,133 @@
+/**
+ * Copyright 2015, SRI International.
+ *
+ * This file is part of LibPoly.
+ *
+ * LibPoly is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LibPoly is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with LibPoly.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <float.h>
+
+/**
+ * Closed interval [a, b] with double end-points, used for fast approximate
+ * computation. All operations round outwards, so the result always contains
+ * the exact result. We don't change the rounding mode, instead each rounded
+ * result is moved away by more than the rounding error (2 ulps, or DBL_MIN
+ * around 0).
+ */
+typedef struct {
+  double a;
+  double b;
+} double_interval_t;
+
+/** Returns a double smaller than x, by more than any rounding error of x */
+static inline
+double double_round_down(double x) {
+  return x - (2*DBL_EPSILON*(x < 0 ? -x : x) + DBL_MIN);
+}
+
+/** Returns a double bigger than x, by more than any rounding error of x */
+static inline
+double double_round_up(double x) {
+  return x + (2*DBL_EPSILON*(x < 0 ? -x : x) + DBL_MIN);
+}
+
+/** Construct the exact point interval [x, x] */
+static inline
+void double_interval_construct_point(double_interval_t* I, double x) {
+  I->a = x;
+  I->b = x;
+}
+
+/** Construct the interval containing [a, b], where a and b are approximate */
+static inline
+void double_interval_construct_approx(double_interval_t* I, double a, double b) {
+  I->a = double_round_down(a);
+  I->b = double_round_up(b);
+}
+
+/** Returns true if the interval is finite (and not NaN) */
+static inline
+int double_interval_is_finite(const double_interval_t* I) {
+  return I->a >= -DBL_MAX && I->b <= DBL_MAX;
+}
+
+/** Returns the sign of the interval if it doesn't contain 0, otherwise 0 */
+static inline
+int double_interval_sgn(const double_interval_t* I) {
+  if (I->a > 0) {
+    return 1;
+  }
+  if (I->b < 0) {
+    return -1;
+  }
+  return 0;
+}
+
+/** S = I1 + I2 */
+static inline
+void double_interval_add(double_interval_t* S, const double_interval_t* I1, const double_interval_t* I2) {
+  double a = I1->a + I2->a;
+  double b = I1->b + I2->b;
+  S->a = double_round_down(a);
+  S->b = double_round_up(b);
+}
+
+/** P = I1 * I2 */
+static inline
+void double_interval_mul(double_interval_t* P, const double_interval_t* I1, const double_interval_t* I2) {
+  double aa = I1->a * I2->a;
+  double ab = I1->a * I2->b;
+  double ba = I1->b * I2->a;
+  double bb = I1->b * I2->b;
+  double min = aa, max = aa;
+  if (ab < min) { min = ab; }
+  if (ab > max) { max = ab; }
+  if (ba < min) { min = ba; }
+  if (ba > max) { max = ba; }
+  if (bb < min) { min = bb; }
+  if (bb > max) { max = bb; }
+  P->a = double_round_down(min);
+  P->b = double_round_up(max);
+}
+
+/** P = I^n */
+static inline
+void double_interval_pow(double_interval_t* P, const double_interval_t* I, unsigned n) {
+  double_interval_t result, base = *I;
+  double_interval_construct_point(&result, 1);
+  if (n % 2 == 0 && base.a < 0) {
+    // Even powers only depend on the absolute value
+    if (base.b > 0) {
+      base.b = -base.a > base.b ? -base.a : base.b;
+      base.a = 0;
+    } else {
+      double tmp = base.a;
+      base.a = -base.b;
+      base.b = -tmp;
+    }
+  }
+  while (n) {
+    if (n & 1) {
+      double_interval_mul(&result, &result, &base);
+    }
+    n >>= 1;
+    if (n) {
+      double_interval_mul(&base, &base, &base);
+    }
+  }
+  *P = result;
+}
@@ -19,31 +19,319 @@
 
 #include <interval.h>
 #include <upolynomial.h>
+#include <upolynomial_factors.h>
 #include <algebraic_number.h>
 #include <polynomial_context.h>
 #include <variable_db.h>
 
 #include "number/integer.h"
+#include "number/algebraic_number.h"
 #include "interval/arithmetic.h"
 #include "polynomial/coefficient.h"
 #include "polynomial/output.h"
 #include "upolynomial/output.h"
 
 #include "utils/debug_trace.h"
+#include "utils/statistics.h"
 
 #include <assert.h>
 
 static
 void lp_algebraic_number_refine_with_point(const lp_algebraic_number_t* a_const, const lp_dyadic_rational_t* q);
 
-void lp_algebraic_number_construct(lp_algebraic_number_t* a, lp_upolynomial_t* f, const lp_dyadic_interval_t* lr) {
+static
+int lp_algebraic_number_cmp_lazy(const lp_algebraic_number_t* a1, const lp_algebraic_number_t* a2);
+
+/** Lazy arithmetic expression over algebraic numbers */
+typedef struct lp_algebraic_expression_struct lp_algebraic_expression_t;
+
+/** Operations in the lazy expressions */
+typedef enum {
+  ALGEBRAIC_EXPRESSION_NUMBER,
+  ALGEBRAIC_EXPRESSION_ADD,
+  ALGEBRAIC_EXPRESSION_SUB,
+  ALGEBRAIC_EXPRESSION_MUL,
+  ALGEBRAIC_EXPRESSION_NEG,
+  ALGEBRAIC_EXPRESSION_POW
+} algebraic_expression_op_t;
+
+/**
+ * Node of a lazy expression. The nodes form a DAG with algebraic numbers at
+ * the leaves, and are shared using reference counting. Once the value of an
+ * operation node is computed, the node becomes a leaf with that value.
+ */
+struct lp_algebraic_expression_struct {
+  /** Reference count */
+  size_t ref_count;
+  /** The operation */
+  algebraic_expression_op_t op;
+  /** The exponent (for pow) */
+  unsigned n;
+  /** The arguments (the second one only for binary operations) */
+  lp_algebraic_expression_t* child[2];
+  /** The value (for leaves) */
+  lp_algebraic_number_t value;
+};
+
+static
+lp_algebraic_expression_t* algebraic_expression_attach(lp_algebraic_expression_t* e) {
+  e->ref_count ++;
+  return e;
+}
+
+static
+void algebraic_expression_detach(lp_algebraic_expression_t* e) {
+  assert(e->ref_count > 0);
+  e->ref_count --;
+  if (e->ref_count == 0) {
+    if (e->child[0]) {
+      algebraic_expression_detach(e->child[0]);
+    }
+    if (e->child[1]) {
+      algebraic_expression_detach(e->child[1]);
+    }
+    lp_algebraic_number_destruct(&e->value);
+    free(e);
+  }
+}
+
+static
+int algebraic_expression_approximate(lp_algebraic_expression_t* e, lp_dyadic_interval_t* I, int precision);
+
+/**
+ * State of the quadratic interval refinement: the interval is split into
+ * N = 2^k pieces, and the values of f at the end-points of the interval are
+ * kept for the next step.
+ */
+typedef struct {
+  /** log2(N), doubled on success and halved on failure */
+  unsigned k;
+  /** Whether the values at a and b are known */
+  int has_f_a, has_f_b;
+  /** The end-points of the known values */
+  lp_dyadic_rational_t a, b;
+  /** The values of f at a and b */
+  lp_dyadic_rational_t f_a, f_b;
+} algebraic_qir_t;
+
+static
+algebraic_qir_t* algebraic_qir_new(void) {
+  algebraic_qir_t* qir = malloc(sizeof(algebraic_qir_t));
+  qir->k = 2;
+  qir->has_f_a = 0;
+  qir->has_f_b = 0;
+  dyadic_rational_construct(&qir->a);
+  dyadic_rational_construct(&qir->b);
+  dyadic_rational_construct(&qir->f_a);
+  dyadic_rational_construct(&qir->f_b);
+  return qir;
+}
+
+static
+algebraic_qir_t* algebraic_qir_new_copy(const algebraic_qir_t* from) {
+  algebraic_qir_t* qir = malloc(sizeof(algebraic_qir_t));
+  qir->k = from->k;
+  qir->has_f_a = from->has_f_a;
+  qir->has_f_b = from->has_f_b;
+  dyadic_rational_construct_copy(&qir->a, &from->a);
+  dyadic_rational_construct_copy(&qir->b, &from->b);
+  dyadic_rational_construct_copy(&qir->f_a, &from->f_a);
+  dyadic_rational_construct_copy(&qir->f_b, &from->f_b);
+  return qir;
+}
+
+static
+void algebraic_qir_delete(algebraic_qir_t* qir) {
+  dyadic_rational_destruct(&qir->a);
+  dyadic_rational_destruct(&qir->b);
+  dyadic_rational_destruct(&qir->f_a);
+  dyadic_rational_destruct(&qir->f_b);
+  free(qir);
+}
+
+/**
+ * Internal state of an algebraic number, only allocated when the number needs
+ * it.
+ */
+struct lp_algebraic_number_state_struct {
+  /** The lazy expression (0 if the value is computed) */
+  lp_algebraic_expression_t* expr;
+  /** The root set of the number (0 if not a root from a set) */
+  lp_algebraic_root_set_t* root_set;
+  /** Index of the root in the root set */
+  size_t root_index;
+  /** The refinement state (0 if not refined with QIR yet) */
+  algebraic_qir_t* qir;
+};
+
+/** The lazy expression of a, or 0 */
+static inline
+lp_algebraic_expression_t* lp_algebraic_number_get_expr(const lp_algebraic_number_t* a) {
+  return a->state ? a->state->expr : 0;
+}
+
+/** The root set of a, or 0 */
+static inline
+lp_algebraic_root_set_t* lp_algebraic_number_get_root_set(const lp_algebraic_number_t* a) {
+  return a->state ? a->state->root_set : 0;
+}
+
+/** Get the state of a, allocating it if needed */
+static
+lp_algebraic_number_state_t* lp_algebraic_number_get_state(lp_algebraic_number_t* a) {
+  if (!a->state) {
+    a->state = malloc(sizeof(lp_algebraic_number_state_t));
+    a->state->expr = 0;
+    a->state->root_set = 0;
+    a->state->root_index = 0;
+    a->state->qir = 0;
+  }
+  return a->state;
+}
+
+/**
+ * Copy the state of a2 into a1 (a1 has no state). The reference to the root
+ * set is taken with the polynomial.
+ */
+static
+void lp_algebraic_number_state_construct_copy(lp_algebraic_number_t* a1, const lp_algebraic_number_t* a2) {
+  a1->state = 0;
+  if (a2->state) {
+    lp_algebraic_number_state_t* state = lp_algebraic_number_get_state(a1);
+    state->expr = a2->state->expr ? algebraic_expression_attach(a2->state->expr) : 0;
+    state->root_set = a2->state->root_set;
+    state->root_index = a2->state->root_index;
+    state->qir = a2->state->qir ? algebraic_qir_new_copy(a2->state->qir) : 0;
+  }
+}
+
+/** Release the state of a (the root set is released with the polynomial) */
+static
+void lp_algebraic_number_state_destruct(lp_algebraic_number_t* a) {
+  if (a->state) {
+    if (a->state->expr) {
+      algebraic_expression_detach(a->state->expr);
+    }
+    if (a->state->qir) {
+      algebraic_qir_delete(a->state->qir);
+    }
+    free(a->state);
+    a->state = 0;
+  }
+}
+
+/**
+ * The real roots of a square-free polynomial. The roots are indexed from the
+ * left, and the set keeps the best known isolating interval of each root so
+ * that the roots (and their copies) can reuse each other's refinements.
+ */
+struct lp_algebraic_root_set_struct {
+  /** Reference count */
+  size_t ref_count;
+  /** The square-free polynomial */
+  lp_upolynomial_t* f;
+  /** Number of real roots */
+  size_t size;
+  /** Best known isolating intervals (a point if not known yet) */
+  lp_dyadic_interval_t* I;
+  /** Signs of f at the left end-points of the intervals */
+  int* sgn_at_a;
+};
+
+lp_algebraic_root_set_t* lp_algebraic_root_set_new(lp_upolynomial_t* f, size_t size) {
   assert(f);
+  assert(lp_upolynomial_is_primitive(f));
+  assert(size <= lp_upolynomial_degree(f));
+
+  lp_algebraic_root_set_t* set = malloc(sizeof(lp_algebraic_root_set_t));
+  set->ref_count = 1;
+  set->f = f;
+  set->size = size;
+  set->I = malloc(sizeof(lp_dyadic_interval_t)*size);
+  set->sgn_at_a = malloc(sizeof(int)*size);
+  size_t i;
+  for (i = 0; i < size; ++ i) {
+    lp_dyadic_interval_construct_zero(set->I + i);
+    set->sgn_at_a[i] = 0;
+  }
+  return set;
+}
+
+void lp_algebraic_root_set_attach(lp_algebraic_root_set_t* set) {
+  set->ref_count ++;
+}
+
+void lp_algebraic_root_set_detach(lp_algebraic_root_set_t* set) {
+  assert(set->ref_count > 0);
+  set->ref_count --;
+  if (set->ref_count == 0) {
+    size_t i;
+    for (i = 0; i < set->size; ++ i) {
+      lp_dyadic_interval_destruct(set->I + i);
+    }
+    lp_upolynomial_delete(set->f);
+    free(set->I);
+    free(set->sgn_at_a);
+    free(set);
+  }
+}
+
+/**
+ * Exchange the interval of a root with its root set: take the interval of the
+ * set if it's smaller, and publish ours otherwise.
+ */
+static
+void lp_algebraic_number_root_set_sync(const lp_algebraic_number_t* a_const) {
+  lp_algebraic_number_t* a = (lp_algebraic_number_t*) a_const;
+  lp_algebraic_root_set_t* set = lp_algebraic_number_get_root_set(a);
+  if (!set) {
+    return;
+  }
+  assert(a->f == set->f);
+  assert(!a->I.is_point);
+  size_t i = a->state->root_index;
+  lp_dyadic_interval_t* J = set->I + i;
+  if (!J->is_point && lp_dyadic_interval_size(J) < lp_dyadic_interval_size(&a->I)) {
+    lp_dyadic_interval_assign(&a->I, J);
+    a->sgn_at_a = set->sgn_at_a[i];
+    a->sgn_at_b = -a->sgn_at_a;
+  } else if (J->is_point || lp_dyadic_interval_size(&a->I) < lp_dyadic_interval_size(J)) {
+    lp_dyadic_interval_assign(J, &a->I);
+    set->sgn_at_a[i] = a->sgn_at_a;
+  }
+}
+
+/**
+ * Release the defining polynomial of a (the number should be reset after). If
+ * the polynomial is from a root set, we just detach from the set.
+ */
+static inline
+void lp_algebraic_number_release_polynomial(lp_algebraic_number_t* a) {
+  lp_algebraic_root_set_t* set = lp_algebraic_number_get_root_set(a);
+  if (set) {
+    lp_algebraic_root_set_detach(set);
+    a->state->root_set = 0;
+    a->state->root_index = 0;
+  } else {
+    lp_upolynomial_delete(a->f);
+  }
+  // The refinement state has values of f
+  if (a->state && a->state->qir) {
+    algebraic_qir_delete(a->state->qir);
+    a->state->qir = 0;
+  }
+  a->f = 0;
+}
+
+/** Setup the interval (a->f is already set) and refine it to size < 1 */
+static
+void lp_algebraic_number_construct_interval(lp_algebraic_number_t* a, const lp_dyadic_interval_t* lr) {
+  const lp_upolynomial_t* f = a->f;
   // Zero should always constructed separately
   assert(lp_upolynomial_const_term(f));
   assert(lr->a_open && lr->b_open);
   assert(lp_upolynomial_is_primitive(f));
 
-  a->f = f;
   lp_dyadic_interval_construct_copy(&a->I, lr);
   a->sgn_at_a = lp_upolynomial_sgn_at_dyadic_rational(f, &a->I.a);
   a->sgn_at_b = lp_upolynomial_sgn_at_dyadic_rational(f, &a->I.b);
@@ -71,11 +359,34 @@ void lp_algebraic_number_construct(lp_algebraic_number_t* a, lp_upolynomial_t* f
   }
 }
 
+void lp_algebraic_number_construct(lp_algebraic_number_t* a, lp_upolynomial_t* f, const lp_dyadic_interval_t* lr) {
+  assert(f);
+  a->f = f;
+  a->state = 0;
+  lp_algebraic_number_construct_interval(a, lr);
+}
+
+void lp_algebraic_number_construct_root(lp_algebraic_number_t* a, lp_algebraic_root_set_t* set, size_t i, const lp_dyadic_interval_t* lr) {
+  assert(i < set->size);
+  lp_algebraic_root_set_attach(set);
+  a->f = set->f;
+  a->state = 0;
+  lp_algebraic_number_state_t* state = lp_algebraic_number_get_state(a);
+  state->root_set = set;
+  state->root_index = i;
+  lp_algebraic_number_construct_interval(a, lr);
+}
+
+int lp_algebraic_number_has_root_set(const lp_algebraic_number_t* a) {
+  return lp_algebraic_number_get_root_set(a) != 0;
+}
+
 void lp_algebraic_number_construct_zero(lp_algebraic_number_t* a) {
   a->f = 0;
   lp_dyadic_interval_construct_from_int(&a->I, 0, 0, 0, 0);
   a->sgn_at_a = 0;
   a->sgn_at_b = 0;
+  a->state = 0;
 }
 
 void lp_algebraic_number_construct_one(lp_algebraic_number_t* a) {
@@ -83,13 +394,22 @@ void lp_algebraic_number_construct_one(lp_algebraic_number_t* a) {
   lp_dyadic_interval_construct_from_int(&a->I, 1, 0, 1, 0);
   a->sgn_at_a = 0;
   a->sgn_at_b = 0;
+  a->state = 0;
 }
 
 void lp_algebraic_number_construct_copy(lp_algebraic_number_t* a1, const lp_algebraic_number_t* a2) {
-  a1->f = a2->f ? lp_upolynomial_construct_copy(a2->f) : 0;
+  lp_algebraic_root_set_t* set = lp_algebraic_number_get_root_set(a2);
+  if (set) {
+    // Roots share the polynomial with the set
+    lp_algebraic_root_set_attach(set);
+    a1->f = a2->f;
+  } else {
+    a1->f = a2->f ? lp_upolynomial_construct_copy(a2->f) : 0;
+  }
   lp_dyadic_interval_construct_copy(&a1->I, &a2->I);
   a1->sgn_at_a = a2->sgn_at_a;
   a1->sgn_at_b = a2->sgn_at_b;
+  lp_algebraic_number_state_construct_copy(a1, a2);
 }
 
 void lp_algebraic_number_construct_from_integer(lp_algebraic_number_t* a, const lp_integer_t* z) {
@@ -150,12 +470,14 @@ void lp_algebraic_number_construct_from_dyadic_rational(lp_algebraic_number_t* a
   lp_dyadic_interval_construct_point(&a->I, q);
   a->sgn_at_a = 0;
   a->sgn_at_b = 0;
+  a->state = 0;
 }
 
 void lp_algebraic_number_destruct(lp_algebraic_number_t* a) {
   if (a->f) {
-    lp_upolynomial_delete(a->f);
+    lp_algebraic_number_release_polynomial(a);
   }
+  lp_algebraic_number_state_destruct(a);
   lp_dyadic_interval_destruct(&a->I);
 }
 
@@ -174,7 +496,7 @@ void lp_algebraic_number_reduce_polynomial(const lp_algebraic_number_t* a, const
   assert(sgn_at_a * sgn_at_b < 0);
   assert(lp_upolynomial_is_primitive(f));
   lp_algebraic_number_t* a_nonconst = (lp_algebraic_number_t*) a;
-  lp_upolynomial_delete(a_nonconst->f);
+  lp_algebraic_number_release_polynomial(a_nonconst);
   a_nonconst->f = lp_upolynomial_construct_copy(f);
   a_nonconst->sgn_at_a = sgn_at_a;
   a_nonconst->sgn_at_b = sgn_at_b;
@@ -186,8 +508,7 @@ void lp_algebraic_number_collapse_to_point(const lp_algebraic_number_t* a_const,
   assert(lp_upolynomial_sgn_at_dyadic_rational(a_const->f, q) == 0);
   // We'll modify the number so unconst it
   lp_algebraic_number_t* a = (lp_algebraic_number_t*) a_const;
-  lp_upolynomial_delete(a->f);
-  a->f = 0;
+  lp_algebraic_number_release_polynomial(a);
   lp_dyadic_interval_collapse_to(&a->I, q);
   a->sgn_at_a = 0;
   a->sgn_at_b = 0;
@@ -217,10 +538,10 @@ void lp_algebraic_number_refine_with_point(const lp_algebraic_number_t* a_const,
  * reduced to point.
  */
 static inline
-int lp_algebraic_number_refine_const_internal(const lp_algebraic_number_t* a_const) {
+int lp_algebraic_number_bisect_const_internal(const lp_algebraic_number_t* a_const) {
 
   if (trace_is_enabled("algebraic_number")) {
-    tracef("algebraic_number_refine(");
+    tracef("algebraic_number_bisect(");
     lp_algebraic_number_print(a_const, trace_out);
     tracef(")\n");
   }
@@ -258,7 +579,7 @@ int lp_algebraic_number_refine_const_internal(const lp_algebraic_number_t* a_con
   lp_dyadic_interval_destruct(&I_right);
 
   if (trace_is_enabled("algebraic_number")) {
-    tracef("algebraic_number_refine() => ");
+    tracef("algebraic_number_bisect() => ");
     lp_algebraic_number_print(a_const, trace_out);
     tracef(", d = %d\n", result);
   }
@@ -266,19 +587,233 @@ int lp_algebraic_number_refine_const_internal(const lp_algebraic_number_t* a_con
   return result;
 }
 
+/** The refinement strategy */
+static
+lp_algebraic_number_refinement_t algebraic_number_refinement = LP_ALGEBRAIC_NUMBER_REFINE_QIR;
+
+void lp_algebraic_number_set_refinement(lp_algebraic_number_refinement_t refinement) {
+  algebraic_number_refinement = refinement;
+}
+
+/**
+ * Get the value of f at x into f_x, reusing the cached value at x_cached if
+ * the same point. The cache is updated to x.
+ */
+static
+void algebraic_qir_value(const lp_upolynomial_t* f, int* has_f_x, lp_dyadic_rational_t* x_cached, lp_dyadic_rational_t* f_x, const lp_dyadic_rational_t* x) {
+  if (!*has_f_x || dyadic_rational_cmp(x_cached, x) != 0) {
+    dyadic_rational_assign(x_cached, x);
+    lp_upolynomial_evaluate_at_dyadic_rational(f, x, f_x);
+    *has_f_x = 1;
+  }
+}
+
+/**
+ * Refine the interval (a, b) using one step of quadratic interval refinement
+ * (Abbott). The interval is split into N = 2^k pieces, and the secant through
+ * (a, f(a)) and (b, f(b)) predicts the piece containing the root. If the
+ * prediction is right we gain k bits with two evaluations and square N for the
+ * next step, otherwise we keep what we learned, take the square root of N,
+ * and bisect if we gained less than one bit. The values of f at the new
+ * end-points are kept with N in the state of the number. Returns 0 if reduced
+ * to point, 1 otherwise.
+ */
+STAT_DECLARE(int, algebraic_number, refine_qir)
+STAT_DECLARE(int, algebraic_number, refine_qir_success)
+
+static
+int lp_algebraic_number_qir_const_internal(const lp_algebraic_number_t* a_const) {
+
+  STAT_INCR(algebraic_number, refine_qir)
+
+  if (trace_is_enabled("algebraic_number")) {
+    tracef("algebraic_number_qir(");
+    lp_algebraic_number_print(a_const, trace_out);
+    tracef(")\n");
+  }
+
+  assert(a_const->f);
+  assert(!a_const->I.is_point);
+
+  // We'll modify the number so unconst it
+  lp_algebraic_number_t* a = (lp_algebraic_number_t*) a_const;
+
+  // The refinement state
+  lp_algebraic_number_state_t* state = lp_algebraic_number_get_state(a);
+  if (!state->qir) {
+    state->qir = algebraic_qir_new();
+  }
+  algebraic_qir_t* qir = state->qir;
+  unsigned k = qir->k;
+
+  // Values at the end-points (of opposite sign)
+  algebraic_qir_value(a->f, &qir->has_f_a, &qir->a, &qir->f_a, &a->I.a);
+  algebraic_qir_value(a->f, &qir->has_f_b, &qir->b, &qir->f_b, &a->I.b);
+
+  // Secant: j = round(N*f(a)/(f(a) - f(b))), in [0, N]
+  lp_rational_t ratio, tmp;
+  rational_construct_from_dyadic(&ratio, &qir->f_a);
+  rational_construct_from_dyadic(&tmp, &qir->f_b);
+  rational_sub(&tmp, &ratio, &tmp);
+  rational_div(&ratio, &ratio, &tmp);
+  rational_mul_2exp(&ratio, &ratio, k);
+  rational_assign_int(&tmp, 1, 2);
+  rational_add(&ratio, &ratio, &tmp);
+  lp_integer_t j;
+  integer_construct(&j);
+  integer_div_Z(&j, rational_get_num_ref(&ratio), rational_get_den_ref(&ratio));
+
+  // The step w/N and the predicted point m = a + j*w/N
+  lp_dyadic_rational_t step, m, m_next, f_m, f_m_next;
+  dyadic_rational_construct(&step);
+  dyadic_rational_sub(&step, &a->I.b, &a->I.a);
+  dyadic_rational_div_2exp(&step, &step, k);
+  dyadic_rational_construct_from_integer(&m, &j);
+  dyadic_rational_mul(&m, &m, &step);
+  dyadic_rational_add(&m, &a->I.a, &m);
+  dyadic_rational_construct(&m_next);
+  dyadic_rational_construct(&f_m);
+  dyadic_rational_construct(&f_m_next);
+
+  int result = 1;
+  int success = 0;
+
+  // Size before, to check progress
+  int size = lp_dyadic_interval_size(&a->I);
+
+  // Value at m (known at the end-points)
+  if (dyadic_rational_cmp(&m, &a->I.a) == 0) {
+    dyadic_rational_assign(&f_m, &qir->f_a);
+  } else if (dyadic_rational_cmp(&m, &a->I.b) == 0) {
+    dyadic_rational_assign(&f_m, &qir->f_b);
+  } else {
+    lp_upolynomial_evaluate_at_dyadic_rational(a->f, &m, &f_m);
+  }
+  int sgn_at_m = dyadic_rational_sgn(&f_m);
+
+  if (sgn_at_m == 0) {
+    lp_algebraic_number_collapse_to_point(a, &m);
+    result = 0;
+  } else if (sgn_at_m == a->sgn_at_a) {
+    // Root in (m, b), check (m, m + w/N)
+    dyadic_rational_add(&m_next, &m, &step);
+    lp_upolynomial_evaluate_at_dyadic_rational(a->f, &m_next, &f_m_next);
+    int sgn_at_m_next = dyadic_rational_sgn(&f_m_next);
+    if (sgn_at_m_next == 0) {
+      lp_algebraic_number_collapse_to_point(a, &m_next);
+      result = 0;
+    } else if (sgn_at_m_next != a->sgn_at_a) {
+      if (dyadic_rational_cmp(&m, &a->I.a) != 0) {
+        lp_dyadic_interval_set_a(&a->I, &m, 1);
+      }
+      lp_dyadic_interval_set_b(&a->I, &m_next, 1);
+      dyadic_rational_swap(&qir->a, &m);
+      dyadic_rational_swap(&qir->f_a, &f_m);
+      dyadic_rational_swap(&qir->b, &m_next);
+      dyadic_rational_swap(&qir->f_b, &f_m_next);
+      success = 1;
+      STAT_INCR(algebraic_number, refine_qir_success)
+    } else {
+      lp_dyadic_interval_set_a(&a->I, &m_next, 1);
+      dyadic_rational_swap(&qir->a, &m_next);
+      dyadic_rational_swap(&qir->f_a, &f_m_next);
+    }
+  } else {
+    // Root in (a, m), check (m - w/N, m)
+    dyadic_rational_sub(&m_next, &m, &step);
+    lp_upolynomial_evaluate_at_dyadic_rational(a->f, &m_next, &f_m_next);
+    int sgn_at_m_next = dyadic_rational_sgn(&f_m_next);
+    if (sgn_at_m_next == 0) {
+      lp_algebraic_number_collapse_to_point(a, &m_next);
+      result = 0;
+    } else if (sgn_at_m_next == a->sgn_at_a) {
+      if (dyadic_rational_cmp(&m, &a->I.b) != 0) {
+        lp_dyadic_interval_set_b(&a->I, &m, 1);
+      }
+      lp_dyadic_interval_set_a(&a->I, &m_next, 1);
+      dyadic_rational_swap(&qir->a, &m_next);
+      dyadic_rational_swap(&qir->f_a, &f_m_next);
+      dyadic_rational_swap(&qir->b, &m);
+      dyadic_rational_swap(&qir->f_b, &f_m);
+      success = 1;
+      STAT_INCR(algebraic_number, refine_qir_success)
+    } else {
+      lp_dyadic_interval_set_b(&a->I, &m_next, 1);
+      dyadic_rational_swap(&qir->b, &m_next);
+      dyadic_rational_swap(&qir->f_b, &f_m_next);
+    }
+  }
+
+  if (result) {
+    if (success) {
+      // N = N^2
+      qir->k = 2*k;
+    } else {
+      // N = sqrt(N), and make sure we gained at least one bit
+      qir->k = k > 2 ? k/2 : 2;
+      if (lp_dyadic_interval_size(&a->I) >= size) {
+        result = lp_algebraic_number_bisect_const_internal(a) != 0;
+      }
+    }
+  }
+
+  // Remove temps
+  dyadic_rational_destruct(&step);
+  dyadic_rational_destruct(&m);
+  dyadic_rational_destruct(&m_next);
+  dyadic_rational_destruct(&f_m);
+  dyadic_rational_destruct(&f_m_next);
+  rational_destruct(&ratio);
+  rational_destruct(&tmp);
+  integer_destruct(&j);
+
+  if (trace_is_enabled("algebraic_number")) {
+    tracef("algebraic_number_qir() => ");
+    lp_algebraic_number_print(a_const, trace_out);
+    tracef(", success = %d, N = 2^%u\n", success, k);
+  }
+
+  return result;
+}
+
+/**
+ * Refine the interval with the selected strategy. Returns 0 if reduced to
+ * point. Roots of a root set start from the best interval of the set, and
+ * publish the result back to it.
+ */
+static inline
+int lp_algebraic_number_refine_const_internal(const lp_algebraic_number_t* a_const) {
+  int result;
+  lp_algebraic_number_root_set_sync(a_const);
+  switch (algebraic_number_refinement) {
+  case LP_ALGEBRAIC_NUMBER_REFINE_BISECTION:
+    result = lp_algebraic_number_bisect_const_internal(a_const);
+    break;
+  case LP_ALGEBRAIC_NUMBER_REFINE_QIR:
+  default:
+    result = lp_algebraic_number_qir_const_internal(a_const);
+    break;
+  }
+  lp_algebraic_number_root_set_sync(a_const);
+  return result;
+}
+
 void lp_algebraic_number_refine(lp_algebraic_number_t* a) {
+  lp_algebraic_number_force(a);
   if (a->f) {
     lp_algebraic_number_refine_const_internal(a);
   }
 }
 
 void lp_algebraic_number_refine_const(const lp_algebraic_number_t* a) {
+  lp_algebraic_number_force_const(a);
   if (a->f) {
     lp_algebraic_number_refine_const_internal(a);
   }
 }
 
 void lp_algebraic_number_restore_interval(lp_algebraic_number_t* a, const lp_dyadic_interval_t* I) {
+  assert(!lp_algebraic_number_get_expr(a));
   lp_dyadic_interval_assign(&a->I, I);
 }
 
@@ -295,11 +830,28 @@ int lp_algebraic_number_sgn(const lp_algebraic_number_t* a) {
   return sgn;
 }
 
+STAT_DECLARE(int, algebraic_number, cmp_root_set)
+
 /**
  * The "proper" algebraic number is always a1.
  */
 int lp_algebraic_number_cmp(const lp_algebraic_number_t* a1, const lp_algebraic_number_t* a2) {
 
+  if (lp_algebraic_number_get_expr(a1) || lp_algebraic_number_get_expr(a2)) {
+    return lp_algebraic_number_cmp_lazy(a1, a2);
+  }
+
+  // Roots of the same polynomial are ordered by their index
+  lp_algebraic_root_set_t* set = lp_algebraic_number_get_root_set(a1);
+  if (set && set == lp_algebraic_number_get_root_set(a2)) {
+    STAT_INCR(algebraic_number, cmp_root_set)
+    size_t i1 = a1->state->root_index, i2 = a2->state->root_index;
+    if (i1 == i2) {
+      return 0;
+    }
+    return i1 < i2 ? -1 : 1;
+  }
+
   if (trace_is_enabled("algebraic_number")) {
     tracef("algebraic_number_cmp(");
     lp_algebraic_number_print(a1, trace_out);
@@ -357,12 +909,13 @@ int lp_algebraic_number_cmp(const lp_algebraic_number_t* a1, const lp_algebraic_
       lp_algebraic_number_reduce_polynomial(a2, gcd, sgn_at_a, sgn_at_b);
       equal = 1;
     } else {
-      // We're not equal, so bisect away
+      // We're not equal, so bisect away (both intervals must be split at the
+      // same points, so we always bisect here)
       int d1 = 1, d2 = 1;
       while (d1 == d2 && d1 && d2) {
         // They become different when bisection goes different ways
-        d1 = lp_algebraic_number_refine_const_internal(a1);
-        d2 = lp_algebraic_number_refine_const_internal(a2);
+        d1 = lp_algebraic_number_bisect_const_internal(a1);
+        d2 = lp_algebraic_number_bisect_const_internal(a2);
       }
     }
     lp_upolynomial_delete(gcd);
@@ -410,6 +963,13 @@ int lp_algebraic_number_cmp_void(const void* a1, const void* a2) {
 }
 
 int lp_algebraic_number_cmp_integer(const lp_algebraic_number_t* a1, const lp_integer_t* a2) {
+  if (lp_algebraic_number_get_expr(a1)) {
+    lp_algebraic_number_t a2_number;
+    lp_algebraic_number_construct_from_integer(&a2_number, a2);
+    int cmp = lp_algebraic_number_cmp_lazy(a1, &a2_number);
+    lp_algebraic_number_destruct(&a2_number);
+    return cmp;
+  }
   if (a1->f) {
     assert(!a1->I.is_point);
     // Easy check, compare to the dyadic interval
@@ -436,6 +996,13 @@ int lp_algebraic_number_cmp_integer(const lp_algebraic_number_t* a1, const lp_in
 }
 
 int lp_algebraic_number_cmp_dyadic_rational(const lp_algebraic_number_t* a1, const lp_dyadic_rational_t* a2) {
+  if (lp_algebraic_number_get_expr(a1)) {
+    lp_algebraic_number_t a2_number;
+    lp_algebraic_number_construct_from_dyadic_rational(&a2_number, a2);
+    int cmp = lp_algebraic_number_cmp_lazy(a1, &a2_number);
+    lp_algebraic_number_destruct(&a2_number);
+    return cmp;
+  }
   if (a1->f) {
     assert(!a1->I.is_point);
     // Easy check, compare to the dyadic interval
@@ -462,6 +1029,13 @@ int lp_algebraic_number_cmp_dyadic_rational(const lp_algebraic_number_t* a1, con
 }
 
 int lp_algebraic_number_cmp_rational(const lp_algebraic_number_t* a1, const lp_rational_t* a2) {
+  if (lp_algebraic_number_get_expr(a1)) {
+    lp_algebraic_number_t a2_number;
+    lp_algebraic_number_construct_from_rational(&a2_number, a2);
+    int cmp = lp_algebraic_number_cmp_lazy(a1, &a2_number);
+    lp_algebraic_number_destruct(&a2_number);
+    return cmp;
+  }
   if (a1->f) {
     assert(!a1->I.is_point);
     // Easy check, compare to the dyadic interval
@@ -488,6 +1062,7 @@ int lp_algebraic_number_cmp_rational(const lp_algebraic_number_t* a1, const lp_r
 
 
 int lp_algebraic_number_print(const lp_algebraic_number_t* a, FILE* out) {
+  lp_algebraic_number_force_const(a);
   if (a->f == 0) {
     return dyadic_rational_print(&a->I.a, out);
   } else {
@@ -512,6 +1087,19 @@ char* lp_algebraic_number_to_string(const lp_algebraic_number_t* a) {
 
 double lp_algebraic_number_to_double(const lp_algebraic_number_t* a_const) {
 
+  // If lazy, try to approximate the expression
+  if (lp_algebraic_number_get_expr(a_const)) {
+    lp_dyadic_interval_t I;
+    lp_dyadic_interval_construct_zero(&I);
+    int approximated = algebraic_expression_approximate(lp_algebraic_number_get_expr(a_const), &I, 100);
+    double result = dyadic_rational_to_double(&I.a);
+    lp_dyadic_interval_destruct(&I);
+    if (approximated) {
+      return result;
+    }
+    lp_algebraic_number_force_const(a_const);
+  }
+
   // If a point, just return it's double
   if (a_const->f == 0) {
     return dyadic_rational_to_double(&a_const->I.a);
@@ -522,20 +1110,12 @@ double lp_algebraic_number_to_double(const lp_algebraic_number_t* a_const) {
   lp_algebraic_number_construct_copy(&a, a_const);
 
   // Refine the number until we get the desired precision
-  lp_dyadic_rational_t interval_size;
-  dyadic_rational_construct(&interval_size);
-  dyadic_rational_sub(&interval_size, &a.I.b, &a.I.a);
-  if (interval_size.n < 100) {
-    int iterations = 100 - interval_size.n;
-    while (a.f && iterations > 0) {
-      lp_algebraic_number_refine_const_internal(&a);
-      iterations --;
-    }
+  while (a.f && lp_dyadic_interval_size(&a.I) > -100) {
+    lp_algebraic_number_refine_const_internal(&a);
   }
 
   double result = dyadic_rational_to_double(&a.I.a);
 
-  dyadic_rational_destruct(&interval_size);
   lp_algebraic_number_destruct(&a);
 
   return result;
@@ -545,6 +1125,23 @@ void lp_algebraic_number_to_rational(const lp_algebraic_number_t* a_const, lp_ra
 
   lp_rational_t tmp;
 
+  // If lazy, try to approximate the expression
+  if (lp_algebraic_number_get_expr(a_const)) {
+    lp_dyadic_interval_t I;
+    lp_dyadic_interval_construct_zero(&I);
+    int approximated = algebraic_expression_approximate(lp_algebraic_number_get_expr(a_const), &I, 100);
+    if (approximated) {
+      rational_construct_from_dyadic(&tmp, &I.a);
+      rational_swap(q, &tmp);
+      rational_destruct(&tmp);
+    }
+    lp_dyadic_interval_destruct(&I);
+    if (approximated) {
+      return;
+    }
+    lp_algebraic_number_force_const(a_const);
+  }
+
   // If a point, just return it's double
   if (a_const->f == 0) {
     rational_construct_from_dyadic(&tmp, &a_const->I.a);
@@ -558,22 +1155,14 @@ void lp_algebraic_number_to_rational(const lp_algebraic_number_t* a_const, lp_ra
   lp_algebraic_number_construct_copy(&a, a_const);
 
   // Refine the number until we get the desired precision
-  lp_dyadic_rational_t interval_size;
-  dyadic_rational_construct(&interval_size);
-  dyadic_rational_sub(&interval_size, &a.I.b, &a.I.a);
-  if (interval_size.n < 100) {
-    int iterations = 100 - interval_size.n;
-    while (a.f && iterations > 0) {
-      lp_algebraic_number_refine_const_internal(&a);
-      iterations --;
-    }
+  while (a.f && lp_dyadic_interval_size(&a.I) > -100) {
+    lp_algebraic_number_refine_const_internal(&a);
   }
 
   rational_construct_from_dyadic(&tmp, &a.I.a);
   rational_swap(q, &tmp);
   rational_destruct(&tmp);
 
-  dyadic_rational_destruct(&interval_size);
   lp_algebraic_number_destruct(&a);
 }
 
@@ -631,29 +1220,83 @@ void filter_roots(lp_algebraic_number_t* roots, size_t* roots_size, const lp_dya
   *roots_size = to_keep;
 }
 
+/** Minimal degree of the resultant to consider factoring it */
+#define ALGEBRAIC_NUMBER_FACTOR_MIN_DEGREE 3
+
+STAT_DECLARE(int, algebraic_number, op_factor)
+STAT_DECLARE(int, algebraic_number, op_factor_skipped)
+STAT_DECLARE(int, algebraic_number, op_factor_reduced)
+
+/**
+ * Isolate the roots of f. If factor is true, the roots are isolated for each
+ * irreducible factor of f, so that they are defined by their minimal
+ * polynomials (otherwise they are defined by the square-free factors).
+ */
+static
+void lp_algebraic_number_op_roots_isolate(const lp_upolynomial_t* f, int factor, lp_algebraic_number_t* roots, size_t* roots_size) {
+
+  if (!factor || lp_upolynomial_degree(f) < ALGEBRAIC_NUMBER_FACTOR_MIN_DEGREE) {
+    STAT_INCR(algebraic_number, op_factor_skipped)
+    lp_upolynomial_roots_isolate(f, roots, roots_size);
+    return;
+  }
+
+  STAT_INCR(algebraic_number, op_factor)
+
+  // Factor the square-free factors (these also have x separated)
+  lp_upolynomial_factors_t* sq_free_factors = lp_upolynomial_factor_square_free(f);
+
+  // Irreducible factors don't share roots, so just collect them all
+  size_t i, j, multiplicity, factor_roots_size;
+  *roots_size = 0;
+  for (i = 0; i < lp_upolynomial_factors_size(sq_free_factors); ++ i) {
+    lp_upolynomial_t* f_i = lp_upolynomial_factors_get_factor(sq_free_factors, i, &multiplicity);
+    if (lp_upolynomial_degree(f_i) < ALGEBRAIC_NUMBER_FACTOR_MIN_DEGREE || !lp_upolynomial_const_term(f_i)) {
+      lp_upolynomial_roots_isolate(f_i, roots + *roots_size, &factor_roots_size);
+      *roots_size += factor_roots_size;
+      continue;
+    }
+    lp_upolynomial_factors_t* factors = lp_upolynomial_factor(f_i);
+    if (trace_is_enabled("algebraic_number")) {
+      tracef("factors = "); lp_upolynomial_factors_print(factors, trace_out); tracef("\n");
+    }
+    for (j = 0; j < lp_upolynomial_factors_size(factors); ++ j) {
+      lp_upolynomial_t* f_ij = lp_upolynomial_factors_get_factor(factors, j, &multiplicity);
+      lp_upolynomial_roots_isolate(f_ij, roots + *roots_size, &factor_roots_size);
+      *roots_size += factor_roots_size;
+    }
+    if (lp_upolynomial_factors_size(factors) > 1) {
+      STAT_INCR(algebraic_number, op_factor_reduced)
+    }
+    lp_upolynomial_factors_destruct(factors, 1);
+  }
+  assert(*roots_size <= lp_upolynomial_degree(f));
+
+  lp_upolynomial_factors_destruct(sq_free_factors, 1);
+}
+
 /** Function type called on coefficient traversal (such as r - (x + y)) */
 typedef void (*construct_op_polynomial_f) (coefficient_t* op, void* data);
 
 /** Function type called on interval operations (such as I = I1 + I2) */
 typedef void (*interval_op_f) (lp_dyadic_interval_t* I, const lp_dyadic_interval_t* I1, const lp_dyadic_interval_t* I2, void* data);
 
-/** Compute the operation */
+/** Function type computing the result polynomial directly (such as the composed sum) */
+typedef lp_upolynomial_t* (*composed_op_f) (const lp_upolynomial_t* f, const lp_upolynomial_t* g);
+
+STAT_DECLARE(int, algebraic_number, op_composed)
+STAT_DECLARE(int, algebraic_number, op_resultant)
+
+/** Compute the polynomial of the operation as the resultant of the op polynomial */
 static
-void lp_algebraic_number_op(
-    lp_algebraic_number_t* op, const lp_algebraic_number_t* a, const lp_algebraic_number_t* b,
+lp_upolynomial_t* lp_algebraic_number_op_resultant(
+    const lp_algebraic_number_t* a, const lp_algebraic_number_t* b,
     construct_op_polynomial_f construct_op,
-    interval_op_f interval_op,
     void* data)
 {
   const lp_polynomial_context_t* ctx = lp_algebraic_pctx();
 
-  if (trace_is_enabled("algebraic_number")) {
-    tracef("a = "); lp_algebraic_number_print(a, trace_out); tracef("\n");
-    if (b) {
-      tracef("b = "); lp_algebraic_number_print(b, trace_out); tracef("\n");
-    }
-    tracef("op = "); lp_algebraic_number_print(op, trace_out); tracef("\n");
-  }
+  STAT_INCR(algebraic_number, op_resultant)
 
   coefficient_t f_a;
   if (a->f) {
@@ -717,14 +1360,60 @@ void lp_algebraic_number_op(
   // Resultant polynomial captures the result
   lp_upolynomial_t* f = coefficient_to_univariate(ctx, &f_r);
 
+  // Remove temps
+  coefficient_destruct(&f_a);
+  if (b) {
+    coefficient_destruct(&f_b);
+  }
+  coefficient_destruct(&f_r);
+
+  return f;
+}
+
+/**
+ * Compute the operation. If composed_op is given, and both operands have
+ * defining polynomials, the result polynomial is computed with it directly,
+ * otherwise it is obtained as a resultant.
+ */
+static
+void lp_algebraic_number_op(
+    lp_algebraic_number_t* op, const lp_algebraic_number_t* a, const lp_algebraic_number_t* b,
+    construct_op_polynomial_f construct_op,
+    composed_op_f composed_op,
+    interval_op_f interval_op,
+    void* data)
+{
+  if (trace_is_enabled("algebraic_number")) {
+    tracef("a = "); lp_algebraic_number_print(a, trace_out); tracef("\n");
+    if (b) {
+      tracef("b = "); lp_algebraic_number_print(b, trace_out); tracef("\n");
+    }
+    tracef("op = "); lp_algebraic_number_print(op, trace_out); tracef("\n");
+  }
+
+  lp_upolynomial_t* f;
+  if (composed_op && a->f && b && b->f) {
+    STAT_INCR(algebraic_number, op_composed)
+    f = composed_op(a->f, b->f);
+  } else {
+    f = lp_algebraic_number_op_resultant(a, b, construct_op, data);
+  }
+
   if (trace_is_enabled("algebraic_number")) {
     tracef("f = "); lp_upolynomial_print(f, trace_out);
   }
 
+  // The resultant is a transformation of the operand polynomial if the degree
+  // didn't grow (e.g. a + q, q rational), otherwise it is usually reducible,
+  // so we factor it to keep the polynomials minimal
+  size_t a_deg = a->f ? lp_upolynomial_degree(a->f) : 1;
+  size_t b_deg = b && b->f ? lp_upolynomial_degree(b->f) : 1;
+  int factor = lp_upolynomial_degree(f) > (a_deg > b_deg ? a_deg : b_deg);
+
   // Get the roots of f
   size_t f_roots_size = 0;
   lp_algebraic_number_t* f_roots = malloc(sizeof(lp_algebraic_number_t)*lp_upolynomial_degree(f));
-  lp_upolynomial_roots_isolate(f, f_roots, &f_roots_size);
+  lp_algebraic_number_op_roots_isolate(f, factor, f_roots, &f_roots_size);
   lp_upolynomial_delete(f);
 
   // Interval for the result
@@ -785,11 +1474,6 @@ void lp_algebraic_number_op(
   }
 
   // Remove temps
-  coefficient_destruct(&f_a);
-  if (b) {
-    coefficient_destruct(&f_b);
-  }
-  coefficient_destruct(&f_r);
   lp_dyadic_interval_destruct(&I);
   free(f_roots);
 }
@@ -819,45 +1503,9 @@ void lp_algebraic_number_add_interval_op(lp_dyadic_interval_t* I, const lp_dyadi
   dyadic_interval_add(I, I1, I2);
 }
 
-lp_upolynomial_t* lp_upolynomial_shift(const lp_upolynomial_t* poly, const lp_integer_t* shift_num, unsigned long shift_den_exp) {
-  lp_integer_t shift_den;
-  lp_integer_construct_from_int(lp_Z, &shift_den, -1);
-  lp_integer_mul_pow2(lp_Z, &shift_den, &shift_den, shift_den_exp);
-  lp_integer_t multcoeffs[2] = { *shift_num, shift_den };
-  lp_upolynomial_t* basemult = lp_upolynomial_construct(lp_Z, 1, multcoeffs);
-  lp_upolynomial_t* curmult = lp_upolynomial_construct_copy(basemult);
-
-  lp_integer_t coeffs[lp_upolynomial_degree(poly) + 1];
-  for (size_t i = 0; i <= lp_upolynomial_degree(poly); ++i) {
-    lp_integer_construct(&coeffs[i]);
-  }
-  lp_upolynomial_unpack(poly, coeffs);
-
-  lp_upolynomial_t* out = lp_upolynomial_construct(lp_Z, 0, coeffs);
-  
-  for (size_t i = 1; i <= lp_upolynomial_degree(poly); ++i) {
-    lp_upolynomial_t* cur = lp_upolynomial_mul_c(curmult, &coeffs[i]);
-    
-    lp_upolynomial_t* tout = lp_upolynomial_add(out, cur);
-    lp_upolynomial_t* tcurmult = lp_upolynomial_mul(curmult, basemult);
-    lp_upolynomial_delete(cur);
-    lp_upolynomial_delete(curmult);
-    lp_upolynomial_delete(out);
-    out = tout;
-    curmult = tcurmult;
-  }
-  for (size_t i = 0; i <= lp_upolynomial_degree(poly); ++i) {
-    lp_integer_destruct(&coeffs[i]);
-  }
-  lp_integer_destruct(&shift_den);
-
-  lp_upolynomial_delete(basemult);
-  lp_upolynomial_delete(curmult);
-  return out;
-}
-
-void lp_algebraic_number_add(lp_algebraic_number_t* sum, const lp_algebraic_number_t* a, const lp_algebraic_number_t* b) {
-  lp_algebraic_number_op(sum, a, b, lp_algebraic_number_add_construct_op, lp_algebraic_number_add_interval_op, 0);
+static
+void lp_algebraic_number_add_eager(lp_algebraic_number_t* sum, const lp_algebraic_number_t* a, const lp_algebraic_number_t* b) {
+  lp_algebraic_number_op(sum, a, b, lp_algebraic_number_add_construct_op, lp_upolynomial_composed_sum, lp_algebraic_number_add_interval_op, 0);
 }
 
 void lp_algebraic_number_sub_construct_op(coefficient_t* f_r, void* data) {
@@ -883,11 +1531,22 @@ void lp_algebraic_number_sub_interval_op(lp_dyadic_interval_t* I, const lp_dyadi
   dyadic_interval_sub(I, I1, I2);
 }
 
-void lp_algebraic_number_sub(lp_algebraic_number_t* sub, const lp_algebraic_number_t* a, const lp_algebraic_number_t* b) {
-  lp_algebraic_number_op(sub, a, b, lp_algebraic_number_sub_construct_op, lp_algebraic_number_sub_interval_op, 0);
+/** Composed difference: roots a - b are the roots a + c of f and c of g(-x) */
+static
+lp_upolynomial_t* lp_algebraic_number_composed_difference(const lp_upolynomial_t* f, const lp_upolynomial_t* g) {
+  lp_upolynomial_t* g_neg = lp_upolynomial_subst_x_neg(g);
+  lp_upolynomial_t* result = lp_upolynomial_composed_sum(f, g_neg);
+  lp_upolynomial_delete(g_neg);
+  return result;
 }
 
-void lp_algebraic_number_neg(lp_algebraic_number_t* neg, const lp_algebraic_number_t* a) {
+static
+void lp_algebraic_number_sub_eager(lp_algebraic_number_t* sub, const lp_algebraic_number_t* a, const lp_algebraic_number_t* b) {
+  lp_algebraic_number_op(sub, a, b, lp_algebraic_number_sub_construct_op, lp_algebraic_number_composed_difference, lp_algebraic_number_sub_interval_op, 0);
+}
+
+static
+void lp_algebraic_number_neg_eager(lp_algebraic_number_t* neg, const lp_algebraic_number_t* a) {
   lp_upolynomial_t* f_neg_x = 0;
 
   if (a->f) {
@@ -931,13 +1590,14 @@ void lp_algebraic_number_mul_interval_op(lp_dyadic_interval_t* I, const lp_dyadi
   dyadic_interval_mul(I, I1, I2);
 }
 
-void lp_algebraic_number_mul(lp_algebraic_number_t* mul, const lp_algebraic_number_t* a, const lp_algebraic_number_t* b) {
+static
+void lp_algebraic_number_mul_eager(lp_algebraic_number_t* mul, const lp_algebraic_number_t* a, const lp_algebraic_number_t* b) {
   // Special case, when one is zero
   if (lp_algebraic_number_sgn(a) == 0 || lp_algebraic_number_sgn(b) == 0) {
     lp_algebraic_number_destruct(mul);
     lp_algebraic_number_construct_zero(mul);
   } else {
-    lp_algebraic_number_op(mul, a, b, lp_algebraic_number_mul_construct_op, lp_algebraic_number_mul_interval_op, 0);
+    lp_algebraic_number_op(mul, a, b, lp_algebraic_number_mul_construct_op, lp_upolynomial_composed_product, lp_algebraic_number_mul_interval_op, 0);
   }
 }
 
@@ -964,6 +1624,8 @@ void lp_algebraic_number_inv(lp_algebraic_number_t* inv, const lp_algebraic_numb
 
   assert(lp_algebraic_number_sgn(a) != 0);
 
+  lp_algebraic_number_force_const(a);
+
   if (trace_is_enabled("algebraic_number")) {
     tracef("a = "); lp_algebraic_number_print(a, trace_out); tracef("\n");
   }
@@ -1097,7 +1759,8 @@ void lp_algebraic_number_pow_interval_op(lp_dyadic_interval_t* I, const lp_dyadi
   dyadic_interval_pow(I, I1, n);
 }
 
-void lp_algebraic_number_pow(lp_algebraic_number_t* pow, const lp_algebraic_number_t* a, unsigned n) {
+static
+void lp_algebraic_number_pow_eager(lp_algebraic_number_t* pow, const lp_algebraic_number_t* a, unsigned n) {
   if (n == 0) {
     // special case x^0 == 1
     lp_integer_t one;
@@ -1108,11 +1771,341 @@ void lp_algebraic_number_pow(lp_algebraic_number_t* pow, const lp_algebraic_numb
     lp_algebraic_number_destruct(&result);
     lp_integer_destruct(&one);
   } else {
-    lp_algebraic_number_op(pow, a, 0, lp_algebraic_number_pow_construct_op, lp_algebraic_number_pow_interval_op, &n);
+    lp_algebraic_number_op(pow, a, 0, lp_algebraic_number_pow_construct_op, 0, lp_algebraic_number_pow_interval_op, &n);
+  }
+}
+
+/** Precision (in bits) up to which we try to decide signs of lazy numbers */
+#define ALGEBRAIC_EXPRESSION_SGN_PRECISION 64
+
+/** Whether to record the arithmetic operations lazily */
+static
+int algebraic_number_lazy = 1;
+
+void lp_algebraic_number_set_lazy(int lazy) {
+  algebraic_number_lazy = lazy;
+}
+
+int lp_algebraic_number_is_lazy(const lp_algebraic_number_t* a) {
+  return lp_algebraic_number_get_expr(a) != 0;
+}
+
+STAT_DECLARE(int, algebraic_number, lazy_op)
+STAT_DECLARE(int, algebraic_number, lazy_force)
+STAT_DECLARE(int, algebraic_number, lazy_cmp)
+STAT_DECLARE(int, algebraic_number, lazy_cmp_decided)
+
+/** Leaf with the value of a (or the expression of a, if lazy) */
+static
+lp_algebraic_expression_t* algebraic_expression_new_number(const lp_algebraic_number_t* a) {
+  if (lp_algebraic_number_get_expr(a)) {
+    return algebraic_expression_attach(lp_algebraic_number_get_expr(a));
+  }
+  lp_algebraic_expression_t* e = malloc(sizeof(lp_algebraic_expression_t));
+  e->ref_count = 1;
+  e->op = ALGEBRAIC_EXPRESSION_NUMBER;
+  e->n = 0;
+  e->child[0] = 0;
+  e->child[1] = 0;
+  lp_algebraic_number_construct_copy(&e->value, a);
+  return e;
+}
+
+/** Operation node (takes over the references of the children) */
+static
+lp_algebraic_expression_t* algebraic_expression_new_op(algebraic_expression_op_t op, lp_algebraic_expression_t* e1, lp_algebraic_expression_t* e2, unsigned n) {
+  lp_algebraic_expression_t* e = malloc(sizeof(lp_algebraic_expression_t));
+  e->ref_count = 1;
+  e->op = op;
+  e->n = n;
+  e->child[0] = e1;
+  e->child[1] = e2;
+  lp_algebraic_number_construct_zero(&e->value);
+  return e;
+}
+
+/** Compute the interval I enclosing the value of the expression */
+static
+void algebraic_expression_interval(const lp_algebraic_expression_t* e, lp_dyadic_interval_t* I) {
+
+  if (e->op == ALGEBRAIC_EXPRESSION_NUMBER) {
+    lp_dyadic_interval_assign(I, &e->value.I);
+    return;
+  }
+
+  lp_dyadic_interval_t I1, I2;
+  lp_dyadic_interval_construct_zero(&I1);
+  lp_dyadic_interval_construct_zero(&I2);
+
+  algebraic_expression_interval(e->child[0], &I1);
+  if (e->child[1]) {
+    algebraic_expression_interval(e->child[1], &I2);
+  }
+
+  switch (e->op) {
+  case ALGEBRAIC_EXPRESSION_ADD:
+    dyadic_interval_add(I, &I1, &I2);
+    break;
+  case ALGEBRAIC_EXPRESSION_SUB:
+    dyadic_interval_sub(I, &I1, &I2);
+    break;
+  case ALGEBRAIC_EXPRESSION_MUL:
+    dyadic_interval_mul(I, &I1, &I2);
+    break;
+  case ALGEBRAIC_EXPRESSION_NEG:
+    dyadic_interval_neg(I, &I1);
+    break;
+  case ALGEBRAIC_EXPRESSION_POW:
+    dyadic_interval_pow(I, &I1, e->n);
+    break;
+  default:
+    assert(0);
+  }
+
+  lp_dyadic_interval_destruct(&I1);
+  lp_dyadic_interval_destruct(&I2);
+}
+
+/** Refine all the leaves of the expression. Returns 0 if all are points. */
+static
+int algebraic_expression_refine(lp_algebraic_expression_t* e) {
+  if (e->op == ALGEBRAIC_EXPRESSION_NUMBER) {
+    if (e->value.f) {
+      lp_algebraic_number_refine_const_internal(&e->value);
+      return 1;
+    } else {
+      return 0;
+    }
+  }
+  int refined = algebraic_expression_refine(e->child[0]);
+  if (e->child[1]) {
+    refined = algebraic_expression_refine(e->child[1]) || refined;
+  }
+  return refined;
+}
+
+/**
+ * Refine the expression until the enclosure I is smaller than 2^-precision.
+ * Returns 0 if this is not possible.
+ */
+static
+int algebraic_expression_approximate(lp_algebraic_expression_t* e, lp_dyadic_interval_t* I, int precision) {
+  for (;;) {
+    algebraic_expression_interval(e, I);
+    if (lp_dyadic_interval_size(I) < -precision) {
+      return 1;
+    }
+    if (!algebraic_expression_refine(e)) {
+      return 0;
+    }
+  }
+}
+
+/**
+ * Get the sign of the expression by refining the enclosure until it excludes
+ * 0, or until it is smaller than 2^-precision. Returns 0 if the sign is not
+ * decided this way.
+ */
+static
+int algebraic_expression_sgn(lp_algebraic_expression_t* e, int* sgn, int precision) {
+
+  lp_integer_t zero;
+  integer_construct_from_int(lp_Z, &zero, 0);
+  lp_dyadic_interval_t I;
+  lp_dyadic_interval_construct_zero(&I);
+
+  int decided = 0;
+  for (;;) {
+    algebraic_expression_interval(e, &I);
+    int cmp = lp_dyadic_interval_cmp_integer(&I, &zero);
+    if (cmp != 0 || I.is_point) {
+      *sgn = cmp;
+      decided = 1;
+      break;
+    }
+    if (lp_dyadic_interval_size(&I) < -precision) {
+      break;
+    }
+    if (!algebraic_expression_refine(e)) {
+      break;
+    }
+  }
+
+  lp_dyadic_interval_destruct(&I);
+  integer_destruct(&zero);
+
+  return decided;
+}
+
+/** Compute the value of the expression, turning it into a leaf */
+static
+void algebraic_expression_force(lp_algebraic_expression_t* e) {
+
+  if (e->op == ALGEBRAIC_EXPRESSION_NUMBER) {
+    return;
+  }
+
+  STAT_INCR(algebraic_number, lazy_force)
+
+  algebraic_expression_force(e->child[0]);
+  if (e->child[1]) {
+    algebraic_expression_force(e->child[1]);
+  }
+
+  const lp_algebraic_number_t* a = &e->child[0]->value;
+  const lp_algebraic_number_t* b = e->child[1] ? &e->child[1]->value : 0;
+  switch (e->op) {
+  case ALGEBRAIC_EXPRESSION_ADD:
+    lp_algebraic_number_add_eager(&e->value, a, b);
+    break;
+  case ALGEBRAIC_EXPRESSION_SUB:
+    lp_algebraic_number_sub_eager(&e->value, a, b);
+    break;
+  case ALGEBRAIC_EXPRESSION_MUL:
+    lp_algebraic_number_mul_eager(&e->value, a, b);
+    break;
+  case ALGEBRAIC_EXPRESSION_NEG:
+    lp_algebraic_number_neg_eager(&e->value, a);
+    break;
+  case ALGEBRAIC_EXPRESSION_POW:
+    lp_algebraic_number_pow_eager(&e->value, a, e->n);
+    break;
+  default:
+    assert(0);
+  }
+
+  // The value is known, so we don't need the arguments anymore
+  algebraic_expression_detach(e->child[0]);
+  if (e->child[1]) {
+    algebraic_expression_detach(e->child[1]);
+  }
+  e->child[0] = 0;
+  e->child[1] = 0;
+  e->op = ALGEBRAIC_EXPRESSION_NUMBER;
+
+  if (trace_is_enabled("algebraic_number")) {
+    tracef("algebraic_expression_force() => ");
+    lp_algebraic_number_print(&e->value, trace_out);
+    tracef("\n");
+  }
+}
+
+void lp_algebraic_number_force(lp_algebraic_number_t* a) {
+  if (lp_algebraic_number_get_expr(a)) {
+    lp_algebraic_expression_t* e = algebraic_expression_attach(lp_algebraic_number_get_expr(a));
+    algebraic_expression_force(e);
+    lp_algebraic_number_destruct(a);
+    lp_algebraic_number_construct_copy(a, &e->value);
+    algebraic_expression_detach(e);
+  }
+}
+
+void lp_algebraic_number_force_const(const lp_algebraic_number_t* a) {
+  lp_algebraic_number_force((lp_algebraic_number_t*) a);
+}
+
+/** Set op to be the lazy result of the operation on a and b */
+static
+void lp_algebraic_number_op_lazy(lp_algebraic_number_t* op, algebraic_expression_op_t type, const lp_algebraic_number_t* a, const lp_algebraic_number_t* b, unsigned n) {
+  STAT_INCR(algebraic_number, lazy_op)
+  lp_algebraic_expression_t* e1 = algebraic_expression_new_number(a);
+  lp_algebraic_expression_t* e2 = b ? algebraic_expression_new_number(b) : 0;
+  lp_algebraic_number_t result;
+  lp_algebraic_number_construct_zero(&result);
+  lp_algebraic_number_get_state(&result)->expr = algebraic_expression_new_op(type, e1, e2, n);
+  lp_algebraic_number_swap(op, &result);
+  lp_algebraic_number_destruct(&result);
+}
+
+/** Returns true if the number is a known dyadic rational */
+static inline
+int lp_algebraic_number_is_point(const lp_algebraic_number_t* a) {
+  return lp_algebraic_number_get_expr(a) == 0 && a->f == 0;
+}
+
+/**
+ * Compare the numbers when one of them is lazy. We first try to decide the
+ * sign of a1 - a2 with intervals, and only compute the values if this fails.
+ */
+static
+int lp_algebraic_number_cmp_lazy(const lp_algebraic_number_t* a1, const lp_algebraic_number_t* a2) {
+
+  STAT_INCR(algebraic_number, lazy_cmp)
+
+  int sgn = 0;
+  lp_algebraic_expression_t* e1 = algebraic_expression_new_number(a1);
+  lp_algebraic_expression_t* e2 = algebraic_expression_new_number(a2);
+  lp_algebraic_expression_t* e = algebraic_expression_new_op(ALGEBRAIC_EXPRESSION_SUB, e1, e2, 0);
+  int decided = algebraic_expression_sgn(e, &sgn, ALGEBRAIC_EXPRESSION_SGN_PRECISION);
+  algebraic_expression_detach(e);
+
+  if (decided) {
+    STAT_INCR(algebraic_number, lazy_cmp_decided)
+    return sgn;
+  }
+
+  // Too close to decide, compute the values
+  lp_algebraic_number_force_const(a1);
+  lp_algebraic_number_force_const(a2);
+  return lp_algebraic_number_cmp(a1, a2);
+}
+
+void lp_algebraic_number_add(lp_algebraic_number_t* sum, const lp_algebraic_number_t* a, const lp_algebraic_number_t* b) {
+  if (algebraic_number_lazy && !(lp_algebraic_number_is_point(a) && lp_algebraic_number_is_point(b))) {
+    lp_algebraic_number_op_lazy(sum, ALGEBRAIC_EXPRESSION_ADD, a, b, 0);
+  } else {
+    lp_algebraic_number_force_const(a);
+    lp_algebraic_number_force_const(b);
+    lp_algebraic_number_add_eager(sum, a, b);
+  }
+}
+
+void lp_algebraic_number_sub(lp_algebraic_number_t* sub, const lp_algebraic_number_t* a, const lp_algebraic_number_t* b) {
+  if (algebraic_number_lazy && !(lp_algebraic_number_is_point(a) && lp_algebraic_number_is_point(b))) {
+    lp_algebraic_number_op_lazy(sub, ALGEBRAIC_EXPRESSION_SUB, a, b, 0);
+  } else {
+    lp_algebraic_number_force_const(a);
+    lp_algebraic_number_force_const(b);
+    lp_algebraic_number_sub_eager(sub, a, b);
+  }
+}
+
+void lp_algebraic_number_neg(lp_algebraic_number_t* neg, const lp_algebraic_number_t* a) {
+  // Negation is cheap, so we only keep it lazy if a is lazy
+  if (algebraic_number_lazy && lp_algebraic_number_get_expr(a)) {
+    lp_algebraic_number_op_lazy(neg, ALGEBRAIC_EXPRESSION_NEG, a, 0, 0);
+  } else {
+    lp_algebraic_number_force_const(a);
+    lp_algebraic_number_neg_eager(neg, a);
+  }
+}
+
+void lp_algebraic_number_mul(lp_algebraic_number_t* mul, const lp_algebraic_number_t* a, const lp_algebraic_number_t* b) {
+  int a_zero = lp_algebraic_number_is_point(a) && dyadic_rational_sgn(&a->I.a) == 0;
+  int b_zero = lp_algebraic_number_is_point(b) && dyadic_rational_sgn(&b->I.a) == 0;
+  if (a_zero || b_zero) {
+    lp_algebraic_number_destruct(mul);
+    lp_algebraic_number_construct_zero(mul);
+  } else if (algebraic_number_lazy && !(lp_algebraic_number_is_point(a) && lp_algebraic_number_is_point(b))) {
+    lp_algebraic_number_op_lazy(mul, ALGEBRAIC_EXPRESSION_MUL, a, b, 0);
+  } else {
+    lp_algebraic_number_force_const(a);
+    lp_algebraic_number_force_const(b);
+    lp_algebraic_number_mul_eager(mul, a, b);
+  }
+}
+
+void lp_algebraic_number_pow(lp_algebraic_number_t* pow, const lp_algebraic_number_t* a, unsigned n) {
+  if (algebraic_number_lazy && n > 0 && !lp_algebraic_number_is_point(a)) {
+    lp_algebraic_number_op_lazy(pow, ALGEBRAIC_EXPRESSION_POW, a, 0, n);
+  } else {
+    lp_algebraic_number_force_const(a);
+    lp_algebraic_number_pow_eager(pow, a, n);
   }
 }
 
 void lp_algebraic_number_get_dyadic_midpoint(const lp_algebraic_number_t* a, lp_dyadic_rational_t* q) {
+  lp_algebraic_number_force_const(a);
   if (a->I.is_point) {
     lp_dyadic_rational_assign(q, &a->I.a);
   } else {
@@ -1135,6 +2128,7 @@ void lp_algebraic_number_get_rational_midpoint(const lp_algebraic_number_t* a, l
 }
 
 int lp_algebraic_number_is_rational(const lp_algebraic_number_t* a) {
+  lp_algebraic_number_force_const(a);
   if (lp_dyadic_interval_is_point(&a->I)) {
     // If a point, we're (dyadic) rational
     return 1;
@@ -1147,6 +2141,7 @@ int lp_algebraic_number_is_rational(const lp_algebraic_number_t* a) {
 }
 
 int lp_algebraic_number_is_integer(const lp_algebraic_number_t* a) {
+  lp_algebraic_number_force_const(a);
   if (lp_dyadic_interval_is_point(&a->I)) {
     // If a point, we're (dyadic) rational
     return lp_dyadic_rational_is_integer(&a->I.a);
@@ -1156,6 +2151,7 @@ int lp_algebraic_number_is_integer(const lp_algebraic_number_t* a) {
 }
 
 void lp_algebraic_number_ceiling(const lp_algebraic_number_t* a, lp_integer_t* a_ceiling) {
+  lp_algebraic_number_force_const(a);
   if (lp_dyadic_interval_is_point(&a->I)) {
     dyadic_rational_ceiling_int(&a->I.a, a_ceiling);
   } else {
@@ -1164,11 +2160,14 @@ void lp_algebraic_number_ceiling(const lp_algebraic_number_t* a, lp_integer_t* a
 }
 
 void lp_algebraic_number_floor(const lp_algebraic_number_t* a, lp_integer_t* a_floor) {
+  lp_algebraic_number_force_const(a);
   dyadic_rational_floor_int(&a->I.a, a_floor);
 }
 
 size_t lp_algebraic_number_hash_approx(const lp_algebraic_number_t* a, unsigned precision) {
 
+  lp_algebraic_number_force_const(a);
+
   if (lp_algebraic_number_is_integer(a)) {
     return integer_hash(&a->I.a.a);
   }
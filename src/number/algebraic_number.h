@@ -0,0 +1,52 @@
+/**
+ * Copyright 2015, SRI International.
+ *
+ * This file is part of LibPoly.
+ *
+ * LibPoly is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LibPoly is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with LibPoly.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algebraic_number.h>
+
+/**
+ * Real roots of a square-free polynomial, shared among the root numbers. The
+ * sharing is not thread-safe: the roots refine the intervals of the set in
+ * place, and attach to it with a plain reference count, so the roots of one
+ * set must only be used by one thread at a time.
+ */
+typedef struct lp_algebraic_root_set_struct lp_algebraic_root_set_t;
+
+/**
+ * Create a new root set for the square-free polynomial f with the given number
+ * of real roots. The set takes over the reference of f, and the returned set
+ * is attached once.
+ */
+lp_algebraic_root_set_t* lp_algebraic_root_set_new(lp_upolynomial_t* f, size_t size);
+
+/** Attach to the root set */
+void lp_algebraic_root_set_attach(lp_algebraic_root_set_t* set);
+
+/** Detach from the root set (deleted when no references are left) */
+void lp_algebraic_root_set_detach(lp_algebraic_root_set_t* set);
+
+/**
+ * Construct the algebraic number as the i-th real root of the root set, given
+ * its isolating interval. The number attaches to the set.
+ */
+void lp_algebraic_number_construct_root(lp_algebraic_number_t* a, lp_algebraic_root_set_t* set, size_t i, const lp_dyadic_interval_t* I);
+
+/** Returns true if a is a root from a root set (and shares its polynomial) */
+int lp_algebraic_number_has_root_set(const lp_algebraic_number_t* a);
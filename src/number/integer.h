@@ -350,6 +350,12 @@ void integer_sqrt_rem_Z(lp_integer_t* sqrt, lp_integer_t* rem, const lp_integer_
   mpz_sqrtrem(sqrt, rem, a);
 }
 
+/** Floor of the n-th root of a >= 0, returns true if exact */
+static inline
+int integer_root_Z(lp_integer_t* root, const lp_integer_t* a, unsigned n) {
+  return mpz_root(root, a, n);
+}
+
 static inline
 void integer_add_mul(const lp_int_ring_t* K, lp_integer_t* sum_product, const lp_integer_t* a, const lp_integer_t* b) {
   assert(integer_in_ring(K, sum_product) && integer_in_ring(K, a) && integer_in_ring(K, b));
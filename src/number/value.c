@@ -178,8 +178,6 @@ void lp_value_delete(lp_value_t* v) {
 #define LP_VALUE_APPROX_MIN_MAGNITUDE -20
 
 void lp_value_approx(const lp_value_t* v, lp_rational_interval_t* out) {
-  int size;
-
   lp_rational_interval_t approx;
 
   switch (v->type) {
@@ -209,11 +207,11 @@ void lp_value_approx(const lp_value_t* v, lp_rational_interval_t* out) {
       lp_rational_interval_construct_point(&approx, &v_rat);
       rational_destruct(&v_rat);
     } else {
-      // Make sure we're below the given size
-      size = lp_dyadic_interval_size(&v->value.a.I);
-      while (size > LP_VALUE_APPROX_MIN_MAGNITUDE) {
-        size --;
-        lp_algebraic_number_refine_const(&v->value.a);
+      // Make sure we're below the given size (a refinement can gain many bits)
+      const lp_algebraic_number_t* a = &v->value.a;
+      lp_algebraic_number_force_const(a);
+      while (!a->I.is_point && lp_dyadic_interval_size(&a->I) > LP_VALUE_APPROX_MIN_MAGNITUDE) {
+        lp_algebraic_number_refine_const(a);
       }
       lp_rational_interval_construct_from_dyadic_interval(&approx, &v->value.a.I);
     }
@@ -488,6 +486,7 @@ void lp_value_get_rational(const lp_value_t* v, lp_rational_t* q) {
     rational_assign(q, &v->value.q);
     return;
   case LP_VALUE_ALGEBRAIC:
+    lp_algebraic_number_force_const(&v->value.a);
     if (lp_dyadic_interval_is_point(&v->value.a.I)) {
       // It's a point value, so we just get it
       lp_rational_construct_from_dyadic(&result, lp_dyadic_interval_get_point(&v->value.a.I));
@@ -529,6 +528,7 @@ void lp_value_get_num(const lp_value_t* v, lp_integer_t* num) {
     rational_get_num(&v->value.q, num);
     break;
   case LP_VALUE_ALGEBRAIC:
+    lp_algebraic_number_force_const(&v->value.a);
     if (lp_dyadic_interval_is_point(&v->value.a.I)) {
       // It's a point value, so we just get it
       dyadic_rational_get_num(lp_dyadic_interval_get_point(&v->value.a.I), num);
@@ -570,6 +570,7 @@ void lp_value_get_den(const lp_value_t* v, lp_integer_t* den) {
     rational_get_den(&v->value.q, den);
     break;
   case LP_VALUE_ALGEBRAIC:
+    lp_algebraic_number_force_const(&v->value.a);
     if (lp_dyadic_interval_is_point(&v->value.a.I)) {
       // It's a point value, so we just get it
       dyadic_rational_get_den(lp_dyadic_interval_get_point(&v->value.a.I), den);
@@ -1251,8 +1252,8 @@ void lp_value_neg(lp_value_t* neg, const lp_value_t* a) {
 void lp_value_mul(lp_value_t* mul, const lp_value_t* a, const lp_value_t* b) {
 
   lp_value_t a_new, b_new;
-  const lp_value_t *a_to_use;
-  const lp_value_t *b_to_use;
+  const lp_value_t *a_to_use = 0;
+  const lp_value_t *b_to_use = 0;
 
   // Check for infinities
   if (lp_value_is_infinity(a) || lp_value_is_infinity(b)) {
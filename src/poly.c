@@ -22,6 +22,9 @@
 #include "utils/statistics.h"
 #include "utils/debug_trace.h"
 #include "utils/output.h"
+#include "utils/thread_pool.h"
+
+#include "polynomial/coefficient.h"
 
 void lp_trace_enable(const char* tag) {
   trace_enable(tag);
@@ -43,6 +46,14 @@ void lp_set_output_language(lp_output_language_t lang) {
   set_output_language(lang);
 }
 
+void lp_set_sgn_refinement_budget(unsigned bits) {
+  coefficient_sgn_set_refinement_budget(bits);
+}
+
+void lp_set_threads(unsigned threads) {
+  thread_pool_set_threads(threads);
+}
+
 void lp_set_upolynomial_var_symbol(const char* x) {
   set_upolynomial_var_symbol(x);
 }
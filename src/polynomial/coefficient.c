@@ -34,18 +34,25 @@
 #include "number/rational.h"
 #include "number/value.h"
 #include "interval/arithmetic.h"
+#include "interval/double_interval.h"
 
 #include "variable/variable_order.h"
 #include "polynomial/polynomial_context.h"
 #include "polynomial/polynomial_vector.h"
+#include "polynomial/polynomial_packed.h"
 
 #include <assignment.h>
 
+#include "utils/assignment.h"
 #include "utils/debug_trace.h"
 #include "utils/statistics.h"
 
 #include <assert.h>
 
+#ifdef LIBPOLY_THREADS
+#include <pthread.h>
+#endif
+
 static
 void coefficient_resolve_algebraic(const lp_polynomial_context_t* ctx, const coefficient_t* A, const lp_assignment_t* m, coefficient_t* A_alg);
 
@@ -81,6 +88,16 @@ void algebraic_interval_restore(const lp_variable_list_t* var_list, lp_dyadic_in
   free(cache);
 }
 
+static
+void algebraic_interval_forget(const lp_variable_list_t* var_list, lp_dyadic_interval_t* cache) {
+  // Keep the current intervals, and destroy the temps
+  size_t i;
+  for (i = 0; i < var_list->list_size; ++ i) {
+    lp_dyadic_interval_destruct(cache + i);
+  }
+  free(cache);
+}
+
 
 /**
  * Make sure that the coefficient has the given capacity for the given variable.
@@ -189,7 +206,7 @@ STAT_DECLARE(int, coefficient, construt_linear)
 
 void coefficient_construct_linear(const lp_polynomial_context_t* ctx, coefficient_t* C, const lp_integer_t* a, const lp_integer_t* b, lp_variable_t x) {
   TRACE("coefficient::internal", "coefficient_construct_simple()\n");
-  STAT_INCR(coefficient, coefficient_construct_linear)
+  STAT_INCR(coefficient, construt_linear)
 
   assert(integer_sgn(lp_Z, a) != 0);
 
@@ -358,7 +375,7 @@ const coefficient_t* coefficient_lc_safe(const lp_polynomial_context_t* ctx, con
     if (VAR(C) == x) {
       return COEFF(C, SIZE(C) - 1);
     } else {
-      assert(lp_variable_order_cmp(ctx->var_order, x, VAR(C)) > 0);
+      assert(variable_order_cmp(ctx->var_order, x, VAR(C)) > 0);
       return C;
     }
   default:
@@ -521,7 +538,7 @@ size_t coefficient_degree_safe(const lp_polynomial_context_t* ctx, const coeffic
     if (VAR(C) == x) {
       return SIZE(C) - 1;
     } else {
-      assert(lp_variable_order_cmp(ctx->var_order, x, VAR(C)) > 0);
+      assert(variable_order_cmp(ctx->var_order, x, VAR(C)) > 0);
       return 0;
     }
     break;
@@ -556,14 +573,28 @@ const coefficient_t* coefficient_get_coefficient(const coefficient_t* C, size_t
 }
 
 static coefficient_t zero;
+
+static void zero_init(void) {
+  zero.type = COEFFICIENT_NUMERIC;
+  integer_construct(&zero.value.num);
+}
+
+#ifdef LIBPOLY_THREADS
+static pthread_once_t zero_once = PTHREAD_ONCE_INIT;
+#else
 static int zero_initialized = 0;
+#endif
 
 static const coefficient_t* get_zero() {
+#ifdef LIBPOLY_THREADS
+  // Can be called concurrently from the thread pool
+  pthread_once(&zero_once, zero_init);
+#else
   if (!zero_initialized) {
     zero_initialized = 1;
-    zero.type = COEFFICIENT_NUMERIC;
-    integer_construct(&zero.value.num);
+    zero_init();
   }
+#endif
   return &zero;
 }
 
@@ -684,6 +715,111 @@ void coefficient_value_approx(const lp_polynomial_context_t* ctx, const coeffici
 }
 
 
+/** Get a double interval containing the integer */
+static
+void double_interval_construct_from_integer(double_interval_t* I, const lp_integer_t* z) {
+  double z_double = integer_to_double(z);
+  if (integer_bits(z) <= DBL_MANT_DIG) {
+    // Exact
+    double_interval_construct_point(I, z_double);
+  } else {
+    double_interval_construct_approx(I, z_double, z_double);
+  }
+}
+
+/** Get a double interval containing the value, returns 0 if not possible */
+static
+int double_interval_construct_from_value(double_interval_t* I, const lp_value_t* v) {
+  double a, b;
+  const lp_dyadic_interval_t* v_I;
+  switch (v->type) {
+  case LP_VALUE_INTEGER:
+    double_interval_construct_from_integer(I, &v->value.z);
+    break;
+  case LP_VALUE_DYADIC_RATIONAL:
+    a = lp_dyadic_rational_to_double(&v->value.dy_q);
+    double_interval_construct_approx(I, a, a);
+    break;
+  case LP_VALUE_RATIONAL:
+    a = lp_rational_to_double(&v->value.q);
+    double_interval_construct_approx(I, a, a);
+    break;
+  case LP_VALUE_ALGEBRAIC:
+    v_I = &v->value.a.I;
+    a = lp_dyadic_rational_to_double(&v_I->a);
+    b = v_I->is_point ? a : lp_dyadic_rational_to_double(&v_I->b);
+    double_interval_construct_approx(I, a, b);
+    break;
+  default:
+    return 0;
+  }
+  return double_interval_is_finite(I);
+}
+
+/**
+ * Approximate the value of the coefficient with double intervals. Returns 0
+ * if the approximation is not usable (overflow).
+ */
+static
+int coefficient_value_approx_double(const lp_polynomial_context_t* ctx, const coefficient_t* C, const lp_assignment_t* m, double_interval_t* value) {
+
+  size_t i;
+  double_interval_t result, tmp1, tmp2, x_value;
+
+  if (C->type == COEFFICIENT_NUMERIC) {
+    double_interval_construct_from_integer(value, &C->value.num);
+    return double_interval_is_finite(value);
+  }
+
+  if (!double_interval_construct_from_value(&x_value, lp_assignment_get_value(m, VAR(C)))) {
+    return 0;
+  }
+
+  // Compute with powers, same as coefficient_value_approx()
+  double_interval_construct_point(&result, 0);
+  for (i = 0; i < SIZE(C); ++ i) {
+    if (!coefficient_is_zero(ctx, COEFF(C, i))) {
+      if (!coefficient_value_approx_double(ctx, COEFF(C, i), m, &tmp1)) {
+        return 0;
+      }
+      double_interval_pow(&tmp2, &x_value, i);
+      double_interval_mul(&tmp2, &tmp2, &tmp1);
+      double_interval_add(&result, &result, &tmp2);
+    }
+  }
+
+  *value = result;
+  return double_interval_is_finite(value);
+}
+
+STAT_DECLARE(int, coefficient, sgn_double)
+STAT_DECLARE(int, coefficient, sgn_double_decided)
+
+/**
+ * Try to get the sign of C in m by evaluating with double intervals. Returns
+ * the sign if the interval doesn't contain 0, and 0 otherwise.
+ */
+static
+int coefficient_sgn_double(const lp_polynomial_context_t* ctx, const coefficient_t* C, const lp_assignment_t* m) {
+  STAT_INCR(coefficient, sgn_double)
+
+  double_interval_t value;
+  int sgn = 0;
+
+  if (coefficient_value_approx_double(ctx, C, m, &value)) {
+    sgn = double_interval_sgn(&value);
+    if (trace_is_enabled("coefficient::sgn")) {
+      tracef("coefficient_sgn(): double approx => [%g, %g]\n", value.a, value.b);
+    }
+  }
+
+  if (sgn) {
+    STAT_INCR(coefficient, sgn_double_decided)
+  }
+
+  return sgn;
+}
+
 /**
  * C is an univariate polynomial C(x), we compute a bound L = 1/2^k such that
  * any root of C(x) that is not zero is outside of [L, -L].
@@ -749,9 +885,109 @@ int coefficient_is_assigned(const lp_polynomial_context_t* ctx, const coefficien
   return 1;
 }
 
+unsigned coefficient_sgn_refinement_budget = 64;
+
+void coefficient_sgn_set_refinement_budget(unsigned bits) {
+  coefficient_sgn_refinement_budget = bits;
+}
+
+STAT_DECLARE(int, coefficient, sgn_refine)
+STAT_DECLARE(int, coefficient, sgn_refine_decided)
+
+/**
+ * Refine the algebraic values of the variables of C, doubling the precision
+ * each round (up to the refinement budget), until the approximation of the
+ * value of C doesn't contain 0. If the sign is decided the refined intervals
+ * are kept, otherwise they are restored. Returns true if the final
+ * approximation in value doesn't contain 0 (or is a point).
+ */
+static
+int coefficient_value_approx_refine(const lp_polynomial_context_t* ctx, const coefficient_t* C, const lp_assignment_t* m, lp_rational_interval_t* value) {
+
+  size_t i;
+  unsigned precision;
+  int decided = 0;
+
+  if (coefficient_sgn_refinement_budget == 0) {
+    return 0;
+  }
+
+  lp_variable_list_t vars;
+  lp_variable_list_construct(&vars);
+  coefficient_get_variables(C, &vars);
+
+  // Only worth it if there are algebraic values to refine
+  int* original_size = malloc(sizeof(int)*vars.list_size);
+  int has_algebraic = 0;
+  for (i = 0; i < vars.list_size; ++ i) {
+    const lp_value_t* x_i_value = lp_assignment_get_value(m, vars.list[i]);
+    if (x_i_value->type == LP_VALUE_ALGEBRAIC && !x_i_value->value.a.I.is_point) {
+      original_size[i] = lp_dyadic_interval_size(&x_i_value->value.a.I);
+      has_algebraic = 1;
+    }
+  }
+
+  if (has_algebraic) {
+
+    STAT_INCR(coefficient, sgn_refine)
+
+    lp_dyadic_interval_t* interval_cache = algebraic_interval_remember(&vars, m);
+
+    unsigned budget = coefficient_sgn_refinement_budget;
+    for (precision = budget < 4 ? budget : 4; !decided; precision = precision > budget/2 ? budget : 2*precision) {
+
+      // Refine all the values to the given precision
+      for (i = 0; i < vars.list_size; ++ i) {
+        const lp_value_t* x_i_value = lp_assignment_get_value(m, vars.list[i]);
+        if (x_i_value->type == LP_VALUE_ALGEBRAIC) {
+          const lp_algebraic_number_t* a = &x_i_value->value.a;
+          while (!a->I.is_point && (long) lp_dyadic_interval_size(&a->I) > (long) original_size[i] - (long) precision) {
+            lp_algebraic_number_refine_const(a);
+          }
+        }
+      }
+
+      // Approximate again
+      coefficient_value_approx(ctx, C, m, value);
+
+      if (trace_is_enabled("coefficient::sgn")) {
+        tracef("coefficient_sgn(): refined %u bits => ", precision); lp_rational_interval_print(value, trace_out); tracef("\n");
+      }
+
+      if (value->is_point || !lp_rational_interval_contains_zero(value)) {
+        decided = 1;
+      } else if (precision == budget) {
+        break;
+      }
+    }
+
+    if (decided) {
+      algebraic_interval_forget(&vars, interval_cache);
+    } else {
+      algebraic_interval_restore(&vars, interval_cache, m);
+    }
+  }
+
+  if (decided) {
+    STAT_INCR(coefficient, sgn_refine_decided)
+  }
+
+  free(original_size);
+  lp_variable_list_destruct(&vars);
+
+  return decided;
+}
+
 STAT_DECLARE(int, coefficient, sgn)
+STAT_DECLARE(int, coefficient, sgn_rational)
+STAT_DECLARE(int, coefficient, sgn_interval)
+STAT_DECLARE(int, coefficient, sgn_resultant)
 
 int coefficient_sgn(const lp_polynomial_context_t* ctx, const coefficient_t* C, const lp_assignment_t* m) {
+  return coefficient_sgn_cached(ctx, C, m, 0);
+}
+
+int coefficient_sgn_cached(const lp_polynomial_context_t* ctx, const coefficient_t* C, const lp_assignment_t* m, coefficient_eval_cache_t* cache) {
 
   if (trace_is_enabled("coefficient::sgn")) {
     tracef("coefficient_sgn("); coefficient_print(ctx, C, trace_out); tracef(")\n");
@@ -768,6 +1004,11 @@ int coefficient_sgn(const lp_polynomial_context_t* ctx, const coefficient_t* C,
     if (trace_is_enabled("coefficient::sgn")) {
       tracef("coefficient_sgn(): constant => %d\n", sgn);
     }
+  } else if ((sgn = coefficient_sgn_double(ctx, C, m))) {
+    // Decided by the double interval approximation
+    if (trace_is_enabled("coefficient::sgn")) {
+      tracef("coefficient_sgn(): double interval is good => %d\n", sgn);
+    }
   } else {
     assert(C->type == COEFFICIENT_POLYNOMIAL);
 
@@ -780,7 +1021,7 @@ int coefficient_sgn(const lp_polynomial_context_t* ctx, const coefficient_t* C,
     coefficient_construct(ctx, &C_rat);
     lp_integer_t multiplier;
     integer_construct(&multiplier);
-    coefficient_evaluate_rationals(ctx, C, m, &C_rat, &multiplier);
+    coefficient_evaluate_rationals_cached(ctx, C, m, cache, &C_rat, &multiplier);
 
     if (trace_is_enabled("coefficient::sgn")) {
       tracef("coefficient_sgn(): C_rat = "); coefficient_print(ctx, &C_rat, trace_out); tracef("\n");
@@ -788,6 +1029,7 @@ int coefficient_sgn(const lp_polynomial_context_t* ctx, const coefficient_t* C,
 
     // If constant, we're done
     if (C_rat.type == COEFFICIENT_NUMERIC) {
+      STAT_INCR(coefficient, sgn_rational)
       // val(C) = C_rat/multiplier with multiplier positive
       sgn = integer_sgn(lp_Z, &C_rat.value.num);
       if (trace_is_enabled("coefficient::sgn")) {
@@ -811,13 +1053,22 @@ int coefficient_sgn(const lp_polynomial_context_t* ctx, const coefficient_t* C,
       }
 
       if (C_rat_approx.is_point || !lp_rational_interval_contains_zero(&C_rat_approx)) {
+        STAT_INCR(coefficient, sgn_interval)
         // Safe to give the sign based on the interval bound
         sgn = lp_rational_interval_sgn(&C_rat_approx);
         if (trace_is_enabled("coefficient::sgn")) {
           tracef("coefficient_sgn(): interval is good => %d\n", sgn);
         }
+      } else if (coefficient_value_approx_refine(ctx, &C_rat, m, &C_rat_approx)) {
+        // The values were just not precise enough
+        sgn = lp_rational_interval_sgn(&C_rat_approx);
+        if (trace_is_enabled("coefficient::sgn")) {
+          tracef("coefficient_sgn(): refined interval is good => %d\n", sgn);
+        }
       } else {
 
+        STAT_INCR(coefficient, sgn_resultant)
+
         //
         // At this point the value is most likely 0.
         //
@@ -1073,7 +1324,7 @@ int coefficient_in_order(const lp_polynomial_context_t* ctx, const coefficient_t
     for (i = 0; i < SIZE(C); ++ i) {
       const coefficient_t* C_i = COEFF(C, i);
       if (C_i->type == COEFFICIENT_POLYNOMIAL) {
-        if (lp_variable_order_cmp(ctx->var_order, VAR(C), VAR(C_i)) <= 0) {
+        if (variable_order_cmp(ctx->var_order, VAR(C), VAR(C_i)) <= 0) {
           // Top variable must be bigger than others
           return 0;
         } else if (!coefficient_in_order(ctx, C_i)) {
@@ -1106,7 +1357,7 @@ int coefficient_cmp_general(const lp_polynomial_context_t* ctx, const coefficien
     return 1;
   } else {
     // Both are polynomials, compare the variable
-    int var_cmp = lp_variable_order_cmp(ctx->var_order, VAR(C1), VAR(C2));
+    int var_cmp = variable_order_cmp(ctx->var_order, VAR(C1), VAR(C2));
     if (var_cmp == 0) {
       if (compare_values) {
         // If the variables are the same, compare lexicographically
@@ -1218,7 +1469,7 @@ void coefficient_add_ordered_monomial(const lp_polynomial_context_t* ctx, lp_mon
     lp_variable_t x = m->p[0].x;
     unsigned d = m->p[0].d;
     // Compare the variables
-    if (C->type == COEFFICIENT_NUMERIC || lp_variable_order_cmp(ctx->var_order, x, VAR(C)) >= 0) {
+    if (C->type == COEFFICIENT_NUMERIC || variable_order_cmp(ctx->var_order, x, VAR(C)) >= 0) {
       coefficient_ensure_capacity(ctx, C, x, d+1);
       // Now, add the monomial to the right place
       m->p ++;
@@ -1265,6 +1516,12 @@ void coefficient_order(const lp_polynomial_context_t* ctx, coefficient_t* C) {
     tracef("C = "); coefficient_print(ctx, C, trace_out); tracef("\n");
   }
 
+  // Larger polynomials are sorted in bulk
+  if (coefficient_order_packed(ctx, C)) {
+    assert(coefficient_is_normalized(ctx, C));
+    return;
+  }
+
   // The coefficient we are building
   coefficient_t result;
   coefficient_construct(ctx, &result);
@@ -1832,6 +2089,33 @@ void coefficient_derivative(const lp_polynomial_context_t* ctx, coefficient_t* C
   assert(coefficient_is_normalized(ctx, C_d));
 }
 
+void coefficient_derivative_var(const lp_polynomial_context_t* ctx, coefficient_t* C_d, const coefficient_t* C, lp_variable_t x) {
+
+  if (C->type == COEFFICIENT_POLYNOMIAL && VAR(C) == x) {
+    coefficient_derivative(ctx, C_d, C);
+    return;
+  }
+
+  size_t i;
+  coefficient_t result;
+
+  if (C->type == COEFFICIENT_NUMERIC || variable_order_cmp(ctx->var_order, x, VAR(C)) > 0) {
+    // No x in C
+    coefficient_construct(ctx, &result);
+  } else {
+    coefficient_construct_rec(ctx, &result, VAR(C), SIZE(C));
+    for (i = 0; i < SIZE(C); ++ i) {
+      coefficient_derivative_var(ctx, COEFF(&result, i), COEFF(C, i), x);
+    }
+    coefficient_normalize(ctx, &result);
+  }
+
+  coefficient_swap(C_d, &result);
+  coefficient_destruct(&result);
+
+  assert(coefficient_is_normalized(ctx, C_d));
+}
+
 void coefficient_div_degrees(const lp_polynomial_context_t* ctx, coefficient_t* C, size_t p) {
   if (C->type == COEFFICIENT_POLYNOMIAL) {
     size_t i;
@@ -2538,7 +2822,7 @@ coefficient_ensure_capacity(const lp_polynomial_context_t* ctx, coefficient_t* C
     break;
   case COEFFICIENT_POLYNOMIAL:
     if (x != VAR(C)) {
-      assert(lp_variable_order_cmp(ctx->var_order, x, VAR(C)) > 0);
+      assert(variable_order_cmp(ctx->var_order, x, VAR(C)) > 0);
       // Same as for constants above
       coefficient_construct_rec(ctx, &tmp, x, capacity);
       coefficient_swap(COEFF(&tmp, 0), C);
@@ -2558,13 +2842,127 @@ coefficient_ensure_capacity(const lp_polynomial_context_t* ctx, coefficient_t* C
   }
 }
 
+/**
+ * Sum up the evaluated coefficients b[i]/m[i] of x^i into C_out/multiplier,
+ * substituting the value of x if rational. The b[i] are overwritten.
+ */
+static
+void coefficient_evaluate_rationals_sum(const lp_polynomial_context_t* ctx, lp_variable_t x, const lp_value_t* x_value, size_t size, coefficient_t* b, const lp_integer_t* m, coefficient_t* C_out, lp_integer_t* multiplier) {
+
+  size_t i;
+
+  // Temp for the result
+  coefficient_t result;
+
+  // Check if the value is rational and we can substitute it
+  if (!lp_value_is_rational(x_value))
+  {
+    // We can not substitute so
+    //
+    //   C = a_n * x^n + ... + a_1 * x + a_0
+    //
+    // We substitute in all a_n obtaining a_k = b_n / m_k, m = lcm(m_1, ..., m_n)
+    //
+    //   m * c = sum     b_k * x^k * m / m_k
+
+    coefficient_construct_rec(ctx, &result, x, size);
+
+    // Compute the lcm of the m's
+    lp_integer_assign(lp_Z, multiplier, m);
+    for (i = 1; i < size; ++ i) {
+      integer_lcm_Z(multiplier, multiplier, m + i);
+    }
+
+    // Sum up
+    lp_integer_t tmp;
+    integer_construct(&tmp);
+    for (i = 0; i < size; ++ i) {
+      // m / m_k
+      integer_div_exact(lp_Z, &tmp, multiplier, m + i);
+      // b_i = b_i * R
+      coefficient_mul_integer(ctx, COEFF(&result, i), b + i, &tmp);
+    }
+    integer_destruct(&tmp);
+
+  } else {
+
+    coefficient_construct(ctx, &result);
+
+    // We have a value value = p/q
+    lp_integer_t p, q;
+    integer_construct(&p);
+    integer_construct(&q);
+    lp_value_get_num(x_value, &p);
+    lp_value_get_den(x_value, &q);
+
+    // If we can substitute then
+    //
+    //   C = a_n * (p/q)^n + ... + a_1 * (p/q) + a_0
+    //
+    // We substitute in all a_n obtaining a_k = b_n / m_k and get
+    //
+    //   q^n * C = b_n * (p^n/m_n) + ... + b_1 * (p*q^n-1/m_1) + b_0 * q^n/m_0
+    //
+    // We get the m = lcm(m_1, ..., m_n) and get
+    //
+    //   q^n * m * c = sum     b_k * p^k * q^(n-k) * m / m_k
+
+    // Compute the lcm of the m's
+    lp_integer_t m_lcm;
+    lp_integer_construct_copy(lp_Z, &m_lcm, m);
+    for (i = 1; i < size; ++ i) {
+      integer_lcm_Z(&m_lcm, &m_lcm, m + i);
+    }
+
+    // The powers
+    lp_integer_t p_power, q_power;
+    integer_construct_from_int(lp_Z, &p_power, 1);
+    integer_construct(&q_power);
+    integer_pow(lp_Z, &q_power, &q, size-1);
+
+    // Set the multiplier
+    integer_mul(lp_Z, multiplier, &q_power, &m_lcm);
+
+    // Sum up
+    lp_integer_t R;
+    integer_construct(&R);
+    for (i = 0; i < size; ++ i) {
+      if (i) {
+        // Update powers
+        integer_mul(lp_Z, &p_power, &p_power, &p);
+        integer_div_exact(lp_Z, &q_power, &q_power, &q);
+      }
+      // R = p^i * q^(n-i) * m / m_k
+      integer_div_exact(lp_Z, &R, &m_lcm, m + i);
+      integer_mul(lp_Z, &R, &R, &p_power);
+      integer_mul(lp_Z, &R, &R, &q_power);
+      // b_i = b_i * R
+      coefficient_mul_integer(ctx, b + i, b + i, &R);
+      // Add it
+      coefficient_add(ctx, &result, &result, b + i);
+    }
+    integer_destruct(&R);
+
+    // Remove the temps
+    integer_destruct(&m_lcm);
+    integer_destruct(&p);
+    integer_destruct(&q);
+    integer_destruct(&p_power);
+    integer_destruct(&q_power);
+  }
+
+  // Finish up
+  coefficient_normalize(ctx, &result);
+  coefficient_swap(&result, C_out);
+  coefficient_destruct(&result);
+}
+
 void coefficient_evaluate_rationals(const lp_polynomial_context_t* ctx, const coefficient_t* C, const lp_assignment_t* M, coefficient_t* C_out, lp_integer_t* multiplier) {
 
   assert(multiplier);
   assert(ctx->K == lp_Z);
 
   size_t i;
-  lp_variable_t x;
 
   // Start wit multiplier 1
   integer_assign_int(lp_Z, multiplier, 1);
@@ -2575,150 +2973,138 @@ void coefficient_evaluate_rationals(const lp_polynomial_context_t* ctx, const co
   } else {
     assert(C->type == COEFFICIENT_POLYNOMIAL);
 
-    // Temp for the result
-    coefficient_t result;
-
     // Get the variable and it's value, if any
-    x = VAR(C);
+    lp_variable_t x = VAR(C);
     const lp_value_t* x_value = lp_assignment_get_value(M, x);
 
     // The degree of the polynomial
     size_t size = SIZE(C);
 
-    // Check if the value is rational and we can substitute it
-    if (!lp_value_is_rational(x_value))
-    {
-      // We can not substitute so
-      //
-      //   C = a_n * x^n + ... + a_1 * x + a_0
-      //
-      // We substitute in all a_n obtaining a_k = b_n / m_k, m = lcm(m_1, ..., m_n)
-      //
-      //   m * c = sum     b_k * x^k * m / m_k
-
-      coefficient_construct_rec(ctx, &result, x, size);
-
-      // Compute the evaluation of the coefficients
-      lp_integer_t* m = malloc(sizeof(coefficient_t)*size);
-      for (i = 0; i < size; ++ i) {
-        integer_construct(m + i);
-        coefficient_evaluate_rationals(ctx, COEFF(C, i), M, COEFF(&result, i), m + i);
-      }
-
-      // Compute the lcm of the m's
-      lp_integer_assign(lp_Z, multiplier, m);
-      for (i = 1; i < size; ++ i) {
-        integer_lcm_Z(multiplier, multiplier, m + i);
-      }
+    // Compute the evaluation of the coefficients
+    coefficient_t* b = malloc(sizeof(coefficient_t)*size);
+    lp_integer_t* m = malloc(sizeof(lp_integer_t)*size);
+    for (i = 0; i < size; ++ i) {
+      coefficient_construct(ctx, b + i);
+      integer_construct(m + i);
+      coefficient_evaluate_rationals(ctx, COEFF(C, i), M, b + i, m + i);
+    }
 
-      // Sum up
-      lp_integer_t tmp;
-      integer_construct(&tmp);
-      for (i = 0; i < size; ++ i) {
-        // m / m_k
-        integer_div_exact(lp_Z, &tmp, multiplier, m + i);
-        // b_i = b_i * R
-        coefficient_mul_integer(ctx, COEFF(&result, i), COEFF(&result, i), &tmp);
-      }
-      integer_destruct(&tmp);
+    // Substitute x
+    coefficient_evaluate_rationals_sum(ctx, x, x_value, size, b, m, C_out, multiplier);
 
-      // Remove the temps
-      for (i = 0; i < size; ++ i) {
-        integer_destruct(m + i);
-      }
-      free(m);
+    // Remove the temps
+    for (i = 0; i < size; ++ i) {
+      coefficient_destruct(b + i);
+      integer_destruct(m + i);
+    }
+    free(b);
+    free(m);
+  }
 
-    } else {
+  assert(integer_sgn(lp_Z, multiplier) > 0);
 
-      coefficient_construct(ctx, &result);
+}
 
-      // We have a value value = p/q
-      lp_integer_t p, q;
-      integer_construct(&p);
-      integer_construct(&q);
-      lp_value_get_num(x_value, &p);
-      lp_value_get_den(x_value, &q);
-
-      // If we can substitute then
-      //
-      //   C = a_n * (p/q)^n + ... + a_1 * (p/q) + a_0
-      //
-      // We substitute in all a_n obtaining a_k = b_n / m_k and get
-      //
-      //   q^n * C = b_n * (p^n/m_n) + ... + b_1 * (p*q^n-1/m_1) + b_0 * q^n/m_0
-      //
-      // We get the m = lcm(m_1, ..., m_n) and get
-      //
-      //   q^n * m * c = sum     b_k * p^k * q^(n-k) * m / m_k
-
-
-      // Compute the evaluation of the coefficients
-      coefficient_t* b = malloc(sizeof(coefficient_t)*size);
-      lp_integer_t* m = malloc(sizeof(lp_integer_t)*size);
-      for (i = 0; i < size; ++ i) {
-        coefficient_construct(ctx, b + i);
-        integer_construct(m + i);
-        coefficient_evaluate_rationals(ctx, COEFF(C, i), M, b + i, m + i);
-      }
+coefficient_eval_cache_t* coefficient_eval_cache_new(void) {
+  coefficient_eval_cache_t* cache = malloc(sizeof(coefficient_eval_cache_t));
+  cache->M = 0;
+  cache->M_id = 0;
+  cache->timestamp = 0;
+  cache->x = lp_variable_null;
+  lp_variable_list_construct(&cache->vars);
+  cache->size = 0;
+  cache->b = 0;
+  cache->m = 0;
+  return cache;
+}
 
-      // Compute the lcm of the m's
-      lp_integer_t m_lcm;
-      lp_integer_construct_copy(lp_Z, &m_lcm, m);
-      for (i = 1; i < size; ++ i) {
-        integer_lcm_Z(&m_lcm, &m_lcm, m + i);
-      }
+static
+void coefficient_eval_cache_clear(coefficient_eval_cache_t* cache) {
+  size_t i;
+  for (i = 0; i < cache->size; ++ i) {
+    coefficient_destruct(cache->b + i);
+    integer_destruct(cache->m + i);
+  }
+  free(cache->b);
+  free(cache->m);
+  cache->b = 0;
+  cache->m = 0;
+  cache->size = 0;
+  cache->M = 0;
+  while (cache->vars.list_size) {
+    lp_variable_list_pop(&cache->vars);
+  }
+}
 
-      // The powers
-      lp_integer_t p_power, q_power;
-      integer_construct_from_int(lp_Z, &p_power, 1);
-      integer_construct(&q_power);
-      integer_pow(lp_Z, &q_power, &q, size-1);
-
-      // Set the multiplier
-      integer_mul(lp_Z, multiplier, &q_power, &m_lcm);
-
-      // Sum up
-      lp_integer_t R;
-      integer_construct(&R);
-      for (i = 0; i < size; ++ i) {
-        if (i) {
-          // Update powers
-          integer_mul(lp_Z, &p_power, &p_power, &p);
-          integer_div_exact(lp_Z, &q_power, &q_power, &q);
-        }
-        // R = p^i * q^(n-i) * m / m_k
-        integer_div_exact(lp_Z, &R, &m_lcm, m + i);
-        integer_mul(lp_Z, &R, &R, &p_power);
-        integer_mul(lp_Z, &R, &R, &q_power);
-        // b_i = b_i * R
-        coefficient_mul_integer(ctx, b + i, b + i, &R);
-        // Add it
-        coefficient_add(ctx, &result, &result, b + i);
-      }
-      integer_destruct(&R);
+void coefficient_eval_cache_delete(coefficient_eval_cache_t* cache) {
+  coefficient_eval_cache_clear(cache);
+  lp_variable_list_destruct(&cache->vars);
+  free(cache);
+}
 
-      // Remove the temps
-      for (i = 0; i < size; ++ i) {
-        coefficient_destruct(b + i);
-        integer_destruct(m + i);
-      }
-      free(b);
-      free(m);
-      integer_destruct(&m_lcm);
-      integer_destruct(&p);
-      integer_destruct(&q);
-      integer_destruct(&p_power);
-      integer_destruct(&q_power);
+/** Check if the cached evaluation of the coefficients of C is still good in M */
+static
+int coefficient_eval_cache_valid(const coefficient_eval_cache_t* cache, const coefficient_t* C, const lp_assignment_t* M) {
+  if (cache->M != M || cache->M_id != M->id || cache->x != VAR(C) || cache->size != SIZE(C)) {
+    return 0;
+  }
+  size_t i;
+  for (i = 0; i < cache->vars.list_size; ++ i) {
+    if (lp_assignment_get_timestamp(M, cache->vars.list[i]) > cache->timestamp) {
+      return 0;
     }
+  }
+  return 1;
+}
 
-    // Finish up
-    coefficient_normalize(ctx, &result);
-    coefficient_swap(&result, C_out);
-    coefficient_destruct(&result);
+STAT_DECLARE(int, coefficient, evaluate_rationals_cached)
+STAT_DECLARE(int, coefficient, evaluate_rationals_cache_hit)
+
+void coefficient_evaluate_rationals_cached(const lp_polynomial_context_t* ctx, const coefficient_t* C, const lp_assignment_t* M, coefficient_eval_cache_t* cache, coefficient_t* C_out, lp_integer_t* multiplier) {
+
+  if (!cache || C->type == COEFFICIENT_NUMERIC) {
+    coefficient_evaluate_rationals(ctx, C, M, C_out, multiplier);
+    return;
   }
 
-  assert(integer_sgn(lp_Z, multiplier) > 0);
+  STAT_INCR(coefficient, evaluate_rationals_cached)
+
+  size_t i, size = SIZE(C);
+  lp_variable_t x = VAR(C);
 
+  if (coefficient_eval_cache_valid(cache, C, M)) {
+    STAT_INCR(coefficient, evaluate_rationals_cache_hit)
+  } else {
+    // Evaluate the coefficients again
+    coefficient_eval_cache_clear(cache);
+    cache->M = M;
+    cache->M_id = M->id;
+    cache->timestamp = M->timestamp;
+    cache->x = x;
+    cache->size = size;
+    cache->b = malloc(sizeof(coefficient_t)*size);
+    cache->m = malloc(sizeof(lp_integer_t)*size);
+    for (i = 0; i < size; ++ i) {
+      coefficient_construct(ctx, cache->b + i);
+      integer_construct(cache->m + i);
+      coefficient_evaluate_rationals(ctx, COEFF(C, i), M, cache->b + i, cache->m + i);
+      coefficient_get_variables(COEFF(C, i), &cache->vars);
+    }
+  }
+
+  // Substitute x into a copy of the coefficients (C_out might be C)
+  const lp_value_t* x_value = lp_assignment_get_value(M, x);
+  coefficient_t* b = malloc(sizeof(coefficient_t)*size);
+  for (i = 0; i < size; ++ i) {
+    coefficient_construct_copy(ctx, b + i, cache->b + i);
+  }
+  coefficient_evaluate_rationals_sum(ctx, x, x_value, size, b, cache->m, C_out, multiplier);
+  for (i = 0; i < size; ++ i) {
+    coefficient_destruct(b + i);
+  }
+  free(b);
+
+  assert(integer_sgn(lp_Z, multiplier) > 0);
 }
 
 void coefficient_get_variables(const coefficient_t* C, lp_variable_list_t* vars) {
@@ -2979,7 +3365,7 @@ void coefficient_roots_isolate(const lp_polynomial_context_t* ctx, const coeffic
 
             // Set the value
             assert(lp_assignment_get_value(M, y)->type == LP_VALUE_NONE);
-            lp_assignment_set_value((lp_assignment_t*) M, y, lc_value);
+            assignment_swap_value((lp_assignment_t*) M, y, lc_value);
             lp_variable_order_push((lp_variable_order_t*) ctx->var_order, y);
 
             // Make B = y*x^k + ...
@@ -3006,7 +3392,7 @@ void coefficient_roots_isolate(const lp_polynomial_context_t* ctx, const coeffic
             }
 
             // Undo local stuff
-            lp_assignment_set_value((lp_assignment_t*) M, y, 0);
+            assignment_swap_value((lp_assignment_t*) M, y, lc_value);
             assert(y == lp_variable_order_top(ctx->var_order));
             lp_variable_order_pop((lp_variable_order_t*) ctx->var_order);
             lp_polynomial_context_release_temp_variable(ctx, y);
@@ -3049,7 +3435,7 @@ void coefficient_roots_isolate(const lp_polynomial_context_t* ctx, const coeffic
             assert(lp_assignment_get_value(M, x)->type == LP_VALUE_NONE);
             lp_value_t x_value;
             lp_value_construct(&x_value, LP_VALUE_ALGEBRAIC, algebraic_roots + i);
-            lp_assignment_set_value((lp_assignment_t*) M, x, &x_value);
+            assignment_swap_value((lp_assignment_t*) M, x, &x_value);
 
             if (trace_is_enabled("coefficient::roots")) {
               tracef("coefficient_roots_isolate(): checking root: ");
@@ -3065,7 +3451,7 @@ void coefficient_roots_isolate(const lp_polynomial_context_t* ctx, const coeffic
               to_keep++;
             }
             // Remove the value
-            lp_assignment_set_value((lp_assignment_t*) M, x, 0);
+            assignment_swap_value((lp_assignment_t*) M, x, &x_value);
             lp_value_destruct(&x_value);
           }
           // Destruct the bad roots
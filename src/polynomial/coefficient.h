@@ -22,6 +22,7 @@
 #include <polynomial_context.h>
 #include <monomial.h>
 #include <assignment.h>
+#include <variable_list.h>
 
 #include "number/integer.h"
 
@@ -35,6 +36,7 @@ typedef enum {
 
 typedef struct polynomial_rec_struct polynomial_rec_t;
 typedef struct coefficient_struct coefficient_t;
+typedef struct coefficient_eval_cache_struct coefficient_eval_cache_t;
 
 /** Recursive nodes in the tree representation of the polynomial */
 struct polynomial_rec_struct {
@@ -92,6 +94,9 @@ void coefficient_construct_from_int(const lp_polynomial_context_t* ctx, coeffici
 /** Construct a coefficient from integer */
 void coefficient_construct_from_integer(const lp_polynomial_context_t* ctx, coefficient_t* C, const lp_integer_t* C_integer);
 
+/** Construct a polynomial coefficient over x with the given capacity (all coefficients 0) */
+void coefficient_construct_rec(const lp_polynomial_context_t* ctx, coefficient_t* C, lp_variable_t x, size_t capacity);
+
 /** Construct from a univariate polynomial */
 void coefficient_construct_from_univariate(const lp_polynomial_context_t* ctx, coefficient_t* C, const lp_upolynomial_t* p, lp_variable_t x);
 
@@ -185,9 +190,25 @@ int coefficient_is_minus_one(const lp_polynomial_context_t* ctx, const coefficie
 /** Returns true if all variables of C are assigned */
 int coefficient_is_assigned(const lp_polynomial_context_t* ctx, const coefficient_t* C, const lp_assignment_t* m);
 
+/**
+ * Precision (in bits) up to which coefficient_sgn() refines the algebraic
+ * values before computing the sign with resultants (0 to disable).
+ */
+extern
+unsigned coefficient_sgn_refinement_budget;
+
+/** Set the refinement budget of coefficient_sgn() */
+void coefficient_sgn_set_refinement_budget(unsigned bits);
+
 /** Returns the sign of the coefficient in the model */
 int coefficient_sgn(const lp_polynomial_context_t* ctx, const coefficient_t* C, const lp_assignment_t* m);
 
+/**
+ * Returns the sign of the coefficient in the model, memoizing the rational
+ * evaluation in the cache (see coefficient_evaluate_rationals_cached()).
+ */
+int coefficient_sgn_cached(const lp_polynomial_context_t* ctx, const coefficient_t* C, const lp_assignment_t* m, coefficient_eval_cache_t* cache);
+
 /** Returns the interval approximation of the value of the polynomial */
 void coefficient_interval_value(const lp_polynomial_context_t* ctx, const coefficient_t* C, const lp_interval_assignment_t* m, lp_interval_t* result);
 
@@ -302,6 +323,9 @@ void coefficient_divrem(const lp_polynomial_context_t* ctx, coefficient_t* D, co
 /** Computes the derivative of the coefficient (in the main variable) */
 void coefficient_derivative(const lp_polynomial_context_t* ctx, coefficient_t* C_d, const coefficient_t* C);
 
+/** Computes the partial derivative of the coefficient in x */
+void coefficient_derivative_var(const lp_polynomial_context_t* ctx, coefficient_t* C_d, const coefficient_t* C, lp_variable_t x);
+
 /**
  * Compute the resultant of C1 and C2 over their (common) top variable.
  */
@@ -344,6 +368,44 @@ void coefficient_add_monomial(const lp_polynomial_context_t* ctx, coefficient_t*
  */
 void coefficient_evaluate_rationals(const lp_polynomial_context_t* ctx, const coefficient_t* C, const lp_assignment_t* M, coefficient_t* C_out, lp_integer_t* multiplier);
 
+/**
+ * Memoized rational evaluation of the coefficients of the top variable of a
+ * polynomial. The i-th coefficient evaluates to b[i]/m[i]. The evaluation
+ * stays valid as long as no variable of the coefficients changes in M (by the
+ * assignment timestamps).
+ */
+struct coefficient_eval_cache_struct {
+  /** The assignment of the evaluation, and its id */
+  const lp_assignment_t* M;
+  size_t M_id;
+  /** Timestamp of M at evaluation */
+  size_t timestamp;
+  /** The top variable */
+  lp_variable_t x;
+  /** Variables of the coefficients */
+  lp_variable_list_t vars;
+  /** Number of coefficients */
+  size_t size;
+  /** Evaluated coefficients */
+  coefficient_t* b;
+  /** Their multipliers */
+  lp_integer_t* m;
+};
+
+/** Allocate an empty cache */
+coefficient_eval_cache_t* coefficient_eval_cache_new(void);
+
+/** Delete the cache */
+void coefficient_eval_cache_delete(coefficient_eval_cache_t* cache);
+
+/**
+ * Same as coefficient_evaluate_rationals(), but the evaluation of the
+ * coefficients of the top variable is memoized in the cache (if not 0). If
+ * only the value of the top variable changes between calls, only the top
+ * level is recomputed. The cache should only be used with the same C.
+ */
+void coefficient_evaluate_rationals_cached(const lp_polynomial_context_t* ctx, const coefficient_t* C, const lp_assignment_t* M, coefficient_eval_cache_t* cache, coefficient_t* C_out, lp_integer_t* multiplier);
+
 /**
  * Get the variables of the coefficient.
  */
@@ -21,6 +21,7 @@
 
 #include "polynomial/gcd.h"
 #include "polynomial/output.h"
+#include "polynomial/polynomial_packed.h"
 
 #include "utils/debug_trace.h"
 #include "utils/statistics.h"
@@ -175,7 +176,7 @@ void coefficient_factor_square_free_pp(const lp_polynomial_context_t* ctx, const
       // L = f/P
       coefficient_t L;
       coefficient_construct(ctx, &L);
-      coefficient_div(ctx, &L, C, &P);
+      coefficient_div_exact(ctx, &L, C, &P);
       if (trace_is_enabled("factorization")) {
         tracef("L = "); coefficient_print(ctx, &L, trace_out); tracef("\n");
       }
@@ -191,7 +192,7 @@ void coefficient_factor_square_free_pp(const lp_polynomial_context_t* ctx, const
         }
         // O = L / R (it can be constant if there is no factor of power k)
         if (coefficient_cmp(ctx, &L, &R)) {
-          coefficient_div(ctx, &O, &L, &R);
+          coefficient_div_exact(ctx, &O, &L, &R);
           if (trace_is_enabled("factorization")) {
             tracef("O = "); coefficient_print(ctx, &O, trace_out); tracef("\n");
           }
@@ -199,7 +200,7 @@ void coefficient_factor_square_free_pp(const lp_polynomial_context_t* ctx, const
           coefficient_factors_add(ctx, factors, &O, k);
         }
         // P = P / R
-        coefficient_div(ctx, &P, &P, &R);
+        coefficient_div_exact(ctx, &P, &P, &R);
         if (trace_is_enabled("factorization")) {
           tracef("P = "); coefficient_print(ctx, &P, trace_out); tracef("\n");
         }
@@ -22,6 +22,7 @@
 
 #include "polynomial/gcd.h"
 #include "polynomial/output.h"
+#include "polynomial/polynomial_packed.h"
 #include "polynomial/polynomial_vector.h"
 
 #include "upolynomial/upolynomial.h"
@@ -93,8 +94,8 @@ void coefficient_gcd_monomial_extract(const lp_polynomial_context_t* ctx, coeffi
   coefficient_construct(ctx, &Q_gcd);
   coefficient_add_ordered_monomial(ctx, &m_P_gcd, &P_gcd);
   coefficient_add_ordered_monomial(ctx, &m_Q_gcd, &Q_gcd);
-  coefficient_div(ctx, P, P, &P_gcd);
-  coefficient_div(ctx, Q, Q, &Q_gcd);
+  coefficient_div_exact(ctx, P, P, &P_gcd);
+  coefficient_div_exact(ctx, Q, Q, &Q_gcd);
   coefficient_destruct(&P_gcd);
   coefficient_destruct(&Q_gcd);
 
@@ -313,9 +314,9 @@ void coefficient_gcd_pp_subresultant(const lp_polynomial_context_t* ctx, coeffic
         // P = Q
         coefficient_swap(P, Q);
         // Q = R/g*(h^delta)
-        coefficient_div(ctx, &tmp1, &R, &g);
+        coefficient_div_exact(ctx, &tmp1, &R, &g);
         coefficient_pow(ctx, &tmp2, &h, delta);
-        coefficient_div(ctx, Q, &tmp1, &tmp2);
+        coefficient_div_exact(ctx, Q, &tmp1, &tmp2);
         // g = lc(P)
         coefficient_assign(ctx, &g, coefficient_lc(P));
         // h = h^(1-delta)*g^delta
@@ -328,7 +329,7 @@ void coefficient_gcd_pp_subresultant(const lp_polynomial_context_t* ctx, coeffic
           // h = g^delta/h^(delta-1))
           coefficient_pow(ctx, &tmp1, &g, delta);
           coefficient_pow(ctx, &tmp2, &h, delta-1);
-          coefficient_div(ctx, &h, &tmp1, &tmp2);
+          coefficient_div_exact(ctx, &h, &tmp1, &tmp2);
         }
       } else {
         assert(cmp_type > 0);
@@ -502,10 +503,10 @@ void coefficient_lcm(const lp_polynomial_context_t* ctx, coefficient_t* lcm, con
       coefficient_mul(ctx, lcm, C1, C2);
     } else {
       if (coefficient_cmp_type(ctx, C1, C2) <= 0) {
-        coefficient_div(ctx, lcm, C1, &gcd);
+        coefficient_div_exact(ctx, lcm, C1, &gcd);
         coefficient_mul(ctx, lcm, lcm, C2);
       } else {
-        coefficient_div(ctx, lcm, C2, &gcd);
+        coefficient_div_exact(ctx, lcm, C2, &gcd);
         coefficient_mul(ctx, lcm, lcm, C1);
       }
     }
@@ -617,7 +618,7 @@ void coefficient_pp_cont(const lp_polynomial_context_t* ctx, coefficient_t* pp,
 
     if (pp) {
       // Now compute the pp
-      coefficient_div(ctx, pp, C, &gcd);
+      coefficient_div_exact(ctx, pp, C, &gcd);
       assert(coefficient_is_normalized(ctx, pp));
     }
     if (cont) {
@@ -833,9 +834,9 @@ lp_polynomial_vector_t* coefficient_mgcd_pp_subresultant(const lp_polynomial_con
       // P = Q
       coefficient_swap(&P, &Q);
       // Q = R/g*(h^delta)
-      coefficient_div(ctx, &tmp1, &R, &g);
+      coefficient_div_exact(ctx, &tmp1, &R, &g);
       coefficient_pow(ctx, &tmp2, &h, delta);
-      coefficient_div(ctx, &Q, &tmp1, &tmp2);
+      coefficient_div_exact(ctx, &Q, &tmp1, &tmp2);
       // g = lc(P)
       coefficient_assign(ctx, &g, coefficient_lc(&P));
       // h = h^(1-delta)*g^delta
@@ -848,7 +849,7 @@ lp_polynomial_vector_t* coefficient_mgcd_pp_subresultant(const lp_polynomial_con
         // h = g^delta/h^(delta-1))
         coefficient_pow(ctx, &tmp1, &g, delta);
         coefficient_pow(ctx, &tmp2, &h, delta-1);
-        coefficient_div(ctx, &h, &tmp1, &tmp2);
+        coefficient_div_exact(ctx, &h, &tmp1, &tmp2);
       }
     } else {
       assert(cmp_type > 0);
@@ -0,0 +1,934 @@
+/**
+ * Copyright 2015, SRI International.
+ *
+ * This file is part of LibPoly.
+ *
+ * LibPoly is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LibPoly is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with LibPoly.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <interval_propagator.h>
+#include <polynomial.h>
+#include <assignment.h>
+#include <interval.h>
+#include <variable_list.h>
+#include <variable_db.h>
+
+#include "polynomial/polynomial.h"
+#include "polynomial/coefficient.h"
+
+#include "number/integer.h"
+#include "number/rational.h"
+#include "number/value.h"
+
+#include "utils/debug_trace.h"
+#include "utils/statistics.h"
+
+#include <stdlib.h>
+#include <assert.h>
+
+STAT_DECLARE(int, interval_propagator, run)
+STAT_DECLARE(int, interval_propagator, revise)
+STAT_DECLARE(int, interval_propagator, narrow)
+STAT_DECLARE(int, interval_propagator, conflict)
+STAT_DECLARE(int, interval_propagator, newton)
+
+/** Bits of precision for roots that are not rational */
+#define PROPAGATOR_ROOT_PRECISION 16
+
+typedef struct {
+  /** The polynomial (external copy) */
+  lp_polynomial_t* A;
+  /** The sign condition (already negated if needed) */
+  lp_sign_condition_t sgn_condition;
+  /** The variables of A */
+  lp_variable_list_t vars;
+  /** Clock of the assignment after the last revision (0 if never revised) */
+  size_t timestamp;
+  /** Is the constraint in the worklist */
+  int in_queue;
+} propagator_constraint_t;
+
+typedef struct {
+  /** Indices of the constraints */
+  size_t* list;
+  /** Size of the list */
+  size_t size;
+  /** Capacity of the list */
+  size_t capacity;
+} propagator_watch_list_t;
+
+struct lp_interval_propagator_struct {
+  /** The constraints */
+  propagator_constraint_t* constraints;
+  /** Number of constraints */
+  size_t size;
+  /** Capacity of the constraints (and of the worklist) */
+  size_t capacity;
+  /** Constraints to wake up when the interval of a variable changes */
+  propagator_watch_list_t* watches;
+  /** Size of the watches (indexed by variable) */
+  size_t watches_size;
+  /** The worklist (circular, each constraint at most once) */
+  size_t* queue;
+  /** First element of the worklist */
+  size_t queue_head;
+  /** Number of elements in the worklist */
+  size_t queue_size;
+  /** The constraint in conflict */
+  size_t conflict;
+  /** Revisions done by the last run */
+  size_t revisions;
+};
+
+lp_interval_propagator_t* lp_interval_propagator_new(void) {
+  lp_interval_propagator_t* P = malloc(sizeof(lp_interval_propagator_t));
+  P->constraints = 0;
+  P->size = 0;
+  P->capacity = 0;
+  P->watches = 0;
+  P->watches_size = 0;
+  P->queue = 0;
+  P->queue_head = 0;
+  P->queue_size = 0;
+  P->conflict = 0;
+  P->revisions = 0;
+  return P;
+}
+
+void lp_interval_propagator_delete(lp_interval_propagator_t* P) {
+  size_t i;
+  for (i = 0; i < P->size; ++ i) {
+    lp_polynomial_delete(P->constraints[i].A);
+    lp_variable_list_destruct(&P->constraints[i].vars);
+  }
+  for (i = 0; i < P->watches_size; ++ i) {
+    free(P->watches[i].list);
+  }
+  free(P->constraints);
+  free(P->watches);
+  free(P->queue);
+  free(P);
+}
+
+size_t lp_interval_propagator_add(lp_interval_propagator_t* P, const lp_polynomial_t* A, lp_sign_condition_t sgn_condition, int negated) {
+
+  assert(P->queue_size == 0);
+
+  if (P->size == P->capacity) {
+    P->capacity = P->capacity ? 2*P->capacity : 8;
+    P->constraints = realloc(P->constraints, sizeof(propagator_constraint_t)*P->capacity);
+    P->queue = realloc(P->queue, sizeof(size_t)*P->capacity);
+  }
+
+  size_t index = P->size ++;
+  propagator_constraint_t* c = P->constraints + index;
+  c->A = lp_polynomial_new_copy(A);
+  lp_polynomial_set_external(c->A);
+  c->sgn_condition = negated ? lp_sign_condition_negate(sgn_condition) : sgn_condition;
+  lp_variable_list_construct(&c->vars);
+  lp_polynomial_get_variables(A, &c->vars);
+  c->timestamp = 0;
+  c->in_queue = 0;
+
+  // Watch all the variables
+  size_t i;
+  for (i = 0; i < c->vars.list_size; ++ i) {
+    lp_variable_t x = c->vars.list[i];
+    if (x >= P->watches_size) {
+      size_t new_size = 2*x + 1;
+      P->watches = realloc(P->watches, sizeof(propagator_watch_list_t)*new_size);
+      for (; P->watches_size < new_size; ++ P->watches_size) {
+        propagator_watch_list_t* w = P->watches + P->watches_size;
+        w->list = 0;
+        w->size = 0;
+        w->capacity = 0;
+      }
+    }
+    propagator_watch_list_t* w = P->watches + x;
+    if (w->size == w->capacity) {
+      w->capacity = w->capacity ? 2*w->capacity : 4;
+      w->list = realloc(w->list, sizeof(size_t)*w->capacity);
+    }
+    w->list[w->size ++] = index;
+  }
+
+  return index;
+}
+
+size_t lp_interval_propagator_size(const lp_interval_propagator_t* P) {
+  return P->size;
+}
+
+size_t lp_interval_propagator_get_conflict(const lp_interval_propagator_t* P) {
+  return P->conflict;
+}
+
+size_t lp_interval_propagator_get_revisions(const lp_interval_propagator_t* P) {
+  return P->revisions;
+}
+
+static
+void propagator_enqueue(lp_interval_propagator_t* P, size_t i) {
+  if (!P->constraints[i].in_queue) {
+    assert(P->queue_size < P->capacity);
+    P->queue[(P->queue_head + P->queue_size ++) % P->capacity] = i;
+    P->constraints[i].in_queue = 1;
+  }
+}
+
+static
+size_t propagator_dequeue(lp_interval_propagator_t* P) {
+  assert(P->queue_size > 0);
+  size_t i = P->queue[P->queue_head];
+  P->queue_head = (P->queue_head + 1) % P->capacity;
+  P->queue_size --;
+  P->constraints[i].in_queue = 0;
+  return i;
+}
+
+static inline
+const lp_value_t* propagator_interval_b(const lp_interval_t* I) {
+  return I->is_point ? &I->a : &I->b;
+}
+
+/** Replace the algebraic end-points of I with the bounds of their isolating intervals */
+static
+void propagator_interval_rationalize(lp_interval_t* I) {
+  lp_value_t tmp;
+  if (I->a.type == LP_VALUE_ALGEBRAIC) {
+    const lp_algebraic_number_t* a = &I->a.value.a;
+    lp_algebraic_number_force_const(a);
+    if (!a->I.is_point) {
+      if (I->is_point) {
+        // (l, u) around the point
+        lp_value_construct(&I->b, LP_VALUE_DYADIC_RATIONAL, &a->I.b);
+        I->is_point = 0;
+        I->a_open = I->b_open = 1;
+      }
+    }
+    lp_value_construct(&tmp, LP_VALUE_DYADIC_RATIONAL, &a->I.a);
+    lp_value_swap(&tmp, &I->a);
+    lp_value_destruct(&tmp);
+  }
+  if (!I->is_point && I->b.type == LP_VALUE_ALGEBRAIC) {
+    const lp_algebraic_number_t* b = &I->b.value.a;
+    lp_algebraic_number_force_const(b);
+    lp_value_construct(&tmp, LP_VALUE_DYADIC_RATIONAL, b->I.is_point ? &b->I.a : &b->I.b);
+    lp_value_swap(&tmp, &I->b);
+    lp_value_destruct(&tmp);
+  }
+}
+
+/** N = -I */
+static
+void propagator_interval_neg(lp_interval_t* N, const lp_interval_t* I) {
+  lp_value_t a, b;
+  lp_value_construct_none(&a);
+  lp_value_construct_none(&b);
+  lp_value_neg(&a, propagator_interval_b(I));
+  lp_value_neg(&b, &I->a);
+  lp_interval_t result;
+  lp_interval_construct(&result, &a, I->b_open, &b, I->a_open);
+  lp_interval_swap(N, &result);
+  lp_interval_destruct(&result);
+  lp_value_destruct(&a);
+  lp_value_destruct(&b);
+}
+
+/** S = I1 - I2 */
+static
+void propagator_interval_sub(lp_interval_t* S, const lp_interval_t* I1, const lp_interval_t* I2) {
+  lp_interval_t neg;
+  lp_interval_construct_zero(&neg);
+  propagator_interval_neg(&neg, I2);
+  lp_interval_add(S, I1, &neg);
+  lp_interval_destruct(&neg);
+}
+
+/** inv = 1/v, where v is an end-point of an interval of sign sgn (1/0 is infinity) */
+static
+void propagator_value_inv(lp_value_t* inv, const lp_value_t* v, int sgn) {
+  if (lp_value_sgn(v) == 0) {
+    lp_value_assign_raw(inv, sgn > 0 ? LP_VALUE_PLUS_INFINITY : LP_VALUE_MINUS_INFINITY, 0);
+  } else {
+    lp_value_inv(inv, v);
+  }
+}
+
+/** Q = I/D, where D doesn't contain 0 */
+static
+void propagator_interval_div(lp_interval_t* Q, const lp_interval_t* I, const lp_interval_t* D) {
+  int sgn = lp_interval_sgn(D);
+  assert(sgn != 0);
+
+  // 1/[a, b] = [1/b, 1/a], with 1/inf = 0 and 1/0 = inf (both open)
+  lp_value_t inv_a, inv_b;
+  lp_value_construct_none(&inv_a);
+  lp_value_construct_none(&inv_b);
+  propagator_value_inv(&inv_a, &D->a, sgn);
+  propagator_value_inv(&inv_b, propagator_interval_b(D), sgn);
+  lp_interval_t D_inv;
+  lp_interval_construct(&D_inv, &inv_b, D->b_open, &inv_a, D->a_open);
+  lp_interval_mul(Q, I, &D_inv);
+  lp_interval_destruct(&D_inv);
+  lp_value_destruct(&inv_a);
+  lp_value_destruct(&inv_b);
+}
+
+/**
+ * Approximate the k-th root of v (v >= 0 if k is even), rounding down or up.
+ * Returns true if the root is exact.
+ */
+static
+int propagator_value_root(const lp_value_t* v, unsigned k, int round_up, lp_value_t* root) {
+
+  if (k == 1 || lp_value_is_infinity(v)) {
+    lp_value_assign(root, v);
+    return 1;
+  }
+
+  if (lp_value_sgn(v) < 0) {
+    // Odd root of a negative number
+    assert(k % 2);
+    lp_value_t v_neg;
+    lp_value_construct_none(&v_neg);
+    lp_value_neg(&v_neg, v);
+    int exact = propagator_value_root(&v_neg, k, !round_up, root);
+    lp_value_neg(root, root);
+    lp_value_destruct(&v_neg);
+    return exact;
+  }
+
+  // v = p/q => root(v) = root(p q^(k-1) 2^(nk)) / q 2^n
+  lp_rational_t q;
+  lp_integer_t num, den, tmp;
+  rational_construct(&q);
+  integer_construct(&num);
+  integer_construct(&den);
+  integer_construct(&tmp);
+  lp_value_get_rational(v, &q);
+  rational_get_num(&q, &num);
+  rational_get_den(&q, &den);
+  integer_pow(lp_Z, &tmp, &den, k - 1);
+  integer_mul(lp_Z, &num, &num, &tmp);
+  integer_mul_pow2(lp_Z, &num, &num, PROPAGATOR_ROOT_PRECISION*k);
+  integer_mul_pow2(lp_Z, &den, &den, PROPAGATOR_ROOT_PRECISION);
+  int exact = integer_root_Z(&tmp, &num, k);
+  if (!exact && round_up) {
+    integer_inc(lp_Z, &tmp);
+  }
+  rational_destruct(&q);
+  rational_construct_from_div(&q, &tmp, &den);
+  lp_value_assign_raw(root, LP_VALUE_RATIONAL, &q);
+
+  rational_destruct(&q);
+  integer_destruct(&num);
+  integer_destruct(&den);
+  integer_destruct(&tmp);
+
+  return exact;
+}
+
+/** Narrow the interval of x in M to I. Returns 0 if the intersection is empty. */
+static
+int propagator_narrow(lp_interval_assignment_t* M, lp_variable_t x, const lp_interval_t* I) {
+  int ok = 1;
+  lp_interval_t P;
+  lp_interval_construct_full(&P);
+  switch (lp_interval_cmp_with_intersect(lp_interval_assignment_get_interval(M, x), I, &P)) {
+  case LP_INTERVAL_CMP_LT_NO_INTERSECT:
+  case LP_INTERVAL_CMP_GT_NO_INTERSECT:
+    ok = 0;
+    break;
+  case LP_INTERVAL_CMP_EQ:
+  case LP_INTERVAL_CMP_LT_WITH_INTERSECT_I1:
+  case LP_INTERVAL_CMP_GEQ_WITH_INTERSECT_I1:
+    // Already in I
+    break;
+  default:
+    STAT_INCR(interval_propagator, narrow)
+    if (trace_is_enabled("interval_propagator")) {
+      tracef("interval_propagator: %s -> ", lp_variable_db_get_name(M->var_db, x));
+      lp_interval_print(&P, trace_out);
+      tracef("\n");
+    }
+    lp_interval_assignment_set_interval(M, x, &P);
+    break;
+  }
+  lp_interval_destruct(&P);
+  return ok;
+}
+
+/**
+ * Narrow the interval of x in M to the values with x^k in I. The interval of
+ * x (rationalized) is passed in x_I. Returns 0 if there are no such values.
+ */
+static
+int propagator_narrow_root(lp_interval_assignment_t* M, lp_variable_t x, const lp_interval_t* x_I, const lp_interval_t* I, unsigned k) {
+
+  if (k == 1) {
+    return propagator_narrow(M, x, I);
+  }
+
+  const lp_value_t* a = &I->a;
+  const lp_value_t* b = propagator_interval_b(I);
+
+  int ok = 1;
+  lp_value_t lb, ub, neg_lb, neg_ub;
+  lp_value_construct_none(&lb);
+  lp_value_construct_none(&ub);
+  lp_value_construct_none(&neg_lb);
+  lp_value_construct_none(&neg_ub);
+  lp_interval_t J;
+  lp_interval_construct_full(&J);
+
+  if (k % 2) {
+    // Odd powers are monotonic
+    int a_exact = propagator_value_root(a, k, 0, &lb);
+    int b_exact = propagator_value_root(b, k, 1, &ub);
+    lp_interval_destruct(&J);
+    lp_interval_construct(&J, &lb, I->a_open && a_exact, &ub, I->b_open && b_exact);
+  } else {
+    int b_sgn = lp_value_sgn(b);
+    if (b_sgn < 0 || (b_sgn == 0 && I->b_open)) {
+      // Even powers are non-negative
+      ok = 0;
+    } else {
+      int b_exact = propagator_value_root(b, k, 1, &ub);
+      int ub_open = I->b_open && b_exact;
+      lp_value_neg(&neg_ub, &ub);
+      lp_interval_destruct(&J);
+      if (lp_value_sgn(a) <= 0) {
+        // x in [-ub, ub]
+        lp_interval_construct(&J, &neg_ub, ub_open, &ub, ub_open);
+      } else {
+        // x in [-ub, -lb] or [lb, ub], keep the ones that meet the interval of x
+        int a_exact = propagator_value_root(a, k, 0, &lb);
+        int lb_open = I->a_open && a_exact;
+        lp_value_neg(&neg_lb, &lb);
+        lp_interval_t J_pos, J_neg;
+        lp_interval_construct(&J_pos, &lb, lb_open, &ub, ub_open);
+        lp_interval_construct(&J_neg, &neg_ub, ub_open, &neg_lb, lb_open);
+        lp_interval_cmp_t cmp_pos = lp_interval_cmp(x_I, &J_pos);
+        lp_interval_cmp_t cmp_neg = lp_interval_cmp(x_I, &J_neg);
+        int pos = cmp_pos != LP_INTERVAL_CMP_LT_NO_INTERSECT && cmp_pos != LP_INTERVAL_CMP_GT_NO_INTERSECT;
+        int neg = cmp_neg != LP_INTERVAL_CMP_LT_NO_INTERSECT && cmp_neg != LP_INTERVAL_CMP_GT_NO_INTERSECT;
+        if (pos && neg) {
+          lp_interval_construct(&J, &neg_ub, ub_open, &ub, ub_open);
+        } else if (pos) {
+          lp_interval_construct_copy(&J, &J_pos);
+        } else if (neg) {
+          lp_interval_construct_copy(&J, &J_neg);
+        } else {
+          lp_interval_construct_full(&J);
+          ok = 0;
+        }
+        lp_interval_destruct(&J_pos);
+        lp_interval_destruct(&J_neg);
+      }
+    }
+  }
+
+  if (ok) {
+    ok = propagator_narrow(M, x, &J);
+  }
+
+  lp_interval_destruct(&J);
+  lp_value_destruct(&lb);
+  lp_value_destruct(&ub);
+  lp_value_destruct(&neg_lb);
+  lp_value_destruct(&neg_ub);
+
+  return ok;
+}
+
+/**
+ * Revise C in T: evaluate the terms of C = sum c_k x^k over M (forward), and
+ * project T back onto x and onto the coefficients c_k (backward), narrowing
+ * the intervals in M. Returns 0 if C has no values in T.
+ */
+static
+int propagator_revise(const lp_polynomial_context_t* ctx, const coefficient_t* C, const lp_interval_t* T, lp_interval_assignment_t* M) {
+
+  if (C->type == COEFFICIENT_NUMERIC) {
+    lp_value_t c;
+    lp_value_construct(&c, LP_VALUE_INTEGER, &C->value.num);
+    int ok = lp_interval_contains(T, &c);
+    lp_value_destruct(&c);
+    return ok;
+  }
+
+  lp_variable_t x = VAR(C);
+  size_t k, n = SIZE(C);
+
+  lp_interval_t x_I;
+  lp_interval_construct_copy(&x_I, lp_interval_assignment_get_interval(M, x));
+  propagator_interval_rationalize(&x_I);
+
+  // Forward: the powers of x, the coefficients, the terms and the sums of
+  // the first k terms
+  lp_interval_t* x_pow = malloc(sizeof(lp_interval_t)*n);
+  lp_interval_t* c = malloc(sizeof(lp_interval_t)*n);
+  lp_interval_t* t = malloc(sizeof(lp_interval_t)*n);
+  lp_interval_t* sum = malloc(sizeof(lp_interval_t)*(n + 1));
+  lp_interval_construct_zero(sum);
+  for (k = 0; k < n; ++ k) {
+    lp_interval_construct_zero(x_pow + k);
+    lp_interval_construct_zero(c + k);
+    lp_interval_construct_zero(t + k);
+    lp_interval_construct_zero(sum + k + 1);
+    if (!coefficient_is_zero(ctx, COEFF(C, k))) {
+      coefficient_interval_value(ctx, COEFF(C, k), M, c + k);
+      propagator_interval_rationalize(c + k);
+      lp_interval_pow(x_pow + k, &x_I, k);
+      lp_interval_mul(t + k, c + k, x_pow + k);
+    }
+    lp_interval_add(sum + k + 1, sum + k, t + k);
+  }
+
+  // The value is in R = I(C) ^ T
+  int ok = 1, done = 0;
+  lp_interval_t R;
+  lp_interval_construct_full(&R);
+  switch (lp_interval_cmp_with_intersect(sum + n, T, &R)) {
+  case LP_INTERVAL_CMP_LT_NO_INTERSECT:
+  case LP_INTERVAL_CMP_GT_NO_INTERSECT:
+    ok = 0;
+    break;
+  case LP_INTERVAL_CMP_EQ:
+  case LP_INTERVAL_CMP_LT_WITH_INTERSECT_I1:
+  case LP_INTERVAL_CMP_GEQ_WITH_INTERSECT_I1:
+    // All values are in T, nothing to project
+    done = 1;
+    break;
+  default:
+    break;
+  }
+
+  if (ok && !done) {
+    // Backward: c_k x^k is in U = R - (t_0 + ... + t_{k-1}) - (t_{k+1} + ... + t_{n-1})
+    lp_interval_t rest, U, V;
+    lp_interval_construct_zero(&rest);
+    lp_interval_construct_zero(&U);
+    lp_interval_construct_zero(&V);
+    for (k = n; ok && k -- > 0; ) {
+      const coefficient_t* C_k = COEFF(C, k);
+      if (coefficient_is_zero(ctx, C_k)) {
+        continue;
+      }
+      lp_interval_add(&U, sum + k, &rest);
+      propagator_interval_sub(&U, &R, &U);
+      lp_interval_add(&rest, &rest, t + k);
+      propagator_interval_rationalize(&U);
+      if (lp_interval_is_full(&U)) {
+        continue;
+      }
+      // x^k in U/c_k
+      if (k > 0 && lp_interval_sgn(c + k)) {
+        propagator_interval_div(&V, &U, c + k);
+        propagator_interval_rationalize(&V);
+        ok = propagator_narrow_root(M, x, &x_I, &V, k);
+      }
+      // c_k in U/x^k
+      if (ok && k == 0) {
+        ok = propagator_revise(ctx, C_k, &U, M);
+      } else if (ok && C_k->type != COEFFICIENT_NUMERIC && lp_interval_sgn(x_pow + k)) {
+        propagator_interval_div(&V, &U, x_pow + k);
+        propagator_interval_rationalize(&V);
+        ok = propagator_revise(ctx, C_k, &V, M);
+      }
+    }
+    lp_interval_destruct(&rest);
+    lp_interval_destruct(&U);
+    lp_interval_destruct(&V);
+  }
+
+  lp_interval_destruct(&R);
+  for (k = 0; k < n; ++ k) {
+    lp_interval_destruct(x_pow + k);
+    lp_interval_destruct(c + k);
+    lp_interval_destruct(t + k);
+    lp_interval_destruct(sum + k + 1);
+  }
+  lp_interval_destruct(sum);
+  free(x_pow);
+  free(c);
+  free(t);
+  free(sum);
+  lp_interval_destruct(&x_I);
+
+  return ok;
+}
+
+/** Revise the constraint, returns 0 on conflict */
+static
+int propagator_revise_constraint(const propagator_constraint_t* c, lp_interval_assignment_t* M) {
+
+  STAT_INCR(interval_propagator, revise)
+
+  if (trace_is_enabled("interval_propagator")) {
+    tracef("interval_propagator: revise "); lp_polynomial_print(c->A, trace_out);
+    tracef(" "); lp_sign_condition_print(c->sgn_condition, trace_out); tracef("\n");
+  }
+
+  lp_polynomial_external_clean(c->A);
+  const lp_polynomial_context_t* ctx = c->A->ctx;
+
+  lp_value_t zero;
+  lp_value_construct_zero(&zero);
+  lp_interval_t T;
+
+  int ok = 1;
+  switch (c->sgn_condition) {
+  case LP_SGN_LT_0:
+    lp_interval_construct(&T, lp_value_minus_infinity(), 1, &zero, 1);
+    break;
+  case LP_SGN_LE_0:
+    lp_interval_construct(&T, lp_value_minus_infinity(), 1, &zero, 0);
+    break;
+  case LP_SGN_EQ_0:
+    lp_interval_construct_zero(&T);
+    break;
+  case LP_SGN_GE_0:
+    lp_interval_construct(&T, &zero, 0, lp_value_plus_infinity(), 1);
+    break;
+  case LP_SGN_GT_0:
+    lp_interval_construct(&T, &zero, 1, lp_value_plus_infinity(), 1);
+    break;
+  case LP_SGN_NE_0:
+    // Nothing to project, just check that the value isn't 0
+    lp_interval_construct_zero(&T);
+    coefficient_interval_value(ctx, &c->A->data, M, &T);
+    ok = !(lp_interval_is_point(&T) && lp_value_sgn(&T.a) == 0);
+    break;
+  }
+
+  if (c->sgn_condition != LP_SGN_NE_0) {
+    ok = propagator_revise(ctx, &c->A->data, &T, M);
+  }
+
+  lp_interval_destruct(&T);
+  lp_value_destruct(&zero);
+
+  return ok;
+}
+
+/** Returns true if the interval of some variable of c changed after the last revision of c */
+static
+int propagator_constraint_changed(const propagator_constraint_t* c, const lp_interval_assignment_t* M) {
+  size_t i;
+  if (c->timestamp == 0) {
+    return 1;
+  }
+  for (i = 0; i < c->vars.list_size; ++ i) {
+    if (lp_interval_assignment_get_timestamp(M, c->vars.list[i]) > c->timestamp) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int lp_interval_propagator_run(lp_interval_propagator_t* P, lp_interval_assignment_t* M, size_t budget) {
+
+  STAT_INCR(interval_propagator, run)
+
+  size_t start = lp_interval_assignment_get_clock(M);
+  size_t i, j;
+
+  P->revisions = 0;
+
+  // Start with the constraints whose variables changed since their last revision
+  for (i = 0; i < P->size; ++ i) {
+    if (propagator_constraint_changed(P->constraints + i, M)) {
+      propagator_enqueue(P, i);
+    }
+  }
+
+  int result = 0;
+  while (P->queue_size > 0 && P->revisions < budget) {
+    i = propagator_dequeue(P);
+    propagator_constraint_t* c = P->constraints + i;
+    size_t before = lp_interval_assignment_get_clock(M);
+    P->revisions ++;
+    if (!propagator_revise_constraint(c, M)) {
+      STAT_INCR(interval_propagator, conflict)
+      P->conflict = i;
+      result = -1;
+      break;
+    }
+    c->timestamp = lp_interval_assignment_get_clock(M);
+    if (c->timestamp == before) {
+      continue;
+    }
+    // Wake up the other constraints of the variables that changed
+    size_t k;
+    for (k = 0; k < c->vars.list_size; ++ k) {
+      lp_variable_t x = c->vars.list[k];
+      if (lp_interval_assignment_get_timestamp(M, x) > before) {
+        const propagator_watch_list_t* w = P->watches + x;
+        for (j = 0; j < w->size; ++ j) {
+          if (w->list[j] != i) {
+            propagator_enqueue(P, w->list[j]);
+          }
+        }
+      }
+    }
+  }
+
+  // Drop the rest, they are found again from the timestamps
+  while (P->queue_size > 0) {
+    propagator_dequeue(P);
+  }
+
+  if (result == 0 && lp_interval_assignment_get_clock(M) > start) {
+    result = 1;
+  }
+
+  if (trace_is_enabled("interval_propagator")) {
+    tracef("interval_propagator: %zu revisions => %d\n", P->revisions, result);
+  }
+
+  return result;
+}
+
+/**
+ * One interval Newton step for the variable x of A = 0 over M. The contracted
+ * interval is put in X_new. Returns 1 if contracted, 0 if not, and -1 if there
+ * are no solutions.
+ */
+static
+int newton_contract_var(const lp_polynomial_t* A, const lp_variable_list_t* vars, const lp_interval_assignment_t* M, lp_variable_t x, lp_interval_t* X_new) {
+
+  const lp_polynomial_context_t* ctx = A->ctx;
+
+  lp_interval_t X;
+  lp_interval_construct_copy(&X, lp_interval_assignment_get_interval(M, x));
+  propagator_interval_rationalize(&X);
+  if (X.is_point || lp_value_is_infinity(&X.a) || lp_value_is_infinity(&X.b)) {
+    lp_interval_destruct(&X);
+    return 0;
+  }
+
+  STAT_INCR(interval_propagator, newton)
+
+  // The middle point m, M with x = m, and M with x = X. The derivative is
+  // evaluated over X, so that it covers m even if X is wider than M(x).
+  lp_value_t m, two;
+  lp_value_construct_none(&m);
+  lp_value_construct_int(&two, 2);
+  lp_value_add(&m, &X.a, &X.b);
+  lp_value_div(&m, &m, &two);
+  lp_interval_t m_I;
+  lp_interval_construct_point(&m_I, &m);
+
+  lp_interval_assignment_t M_m, M_X;
+  lp_interval_assignment_construct(&M_m, M->var_db);
+  lp_interval_assignment_construct(&M_X, M->var_db);
+  size_t i;
+  for (i = 0; i < vars->list_size; ++ i) {
+    lp_variable_t y = vars->list[i];
+    const lp_interval_t* y_I = lp_interval_assignment_get_interval(M, y);
+    lp_interval_assignment_set_interval(&M_m, y, y == x ? &m_I : y_I);
+    lp_interval_assignment_set_interval(&M_X, y, y == x ? &X : y_I);
+  }
+
+  // A' in x
+  lp_polynomial_t* A_d = lp_polynomial_new(ctx);
+  if (x == lp_polynomial_top_variable(A)) {
+    lp_polynomial_derivative(A_d, A);
+  } else {
+    coefficient_derivative_var(ctx, &A_d->data, &A->data, x);
+  }
+
+  // F = A(m), D = A'(X)
+  lp_interval_t F, D, N, tmp;
+  lp_interval_construct_zero(&F);
+  lp_interval_construct_zero(&D);
+  lp_interval_construct_full(&N);
+  lp_interval_construct_zero(&tmp);
+  lp_polynomial_interval_value(A, &M_m, &F);
+  lp_polynomial_interval_value(A_d, &M_X, &D);
+  propagator_interval_rationalize(&F);
+  propagator_interval_rationalize(&D);
+
+  if (lp_interval_sgn(&D)) {
+    // N = m - F/D
+    propagator_interval_div(&tmp, &F, &D);
+    propagator_interval_sub(&N, &m_I, &tmp);
+  } else {
+    // Krawczyk: N = m - cF + (1 - cD)(X - m), with c = 1/A'(m) (middle)
+    lp_interval_t D_m;
+    lp_interval_construct_zero(&D_m);
+    lp_polynomial_interval_value(A_d, &M_m, &D_m);
+    propagator_interval_rationalize(&D_m);
+    if (!lp_value_is_infinity(&D_m.a) && !lp_value_is_infinity(propagator_interval_b(&D_m))) {
+      lp_value_t c;
+      lp_value_construct_none(&c);
+      lp_value_add(&c, &D_m.a, propagator_interval_b(&D_m));
+      if (lp_value_sgn(&c)) {
+        // c = 2/(a + b)
+        lp_value_div(&c, &two, &c);
+        lp_interval_t c_I, one;
+        lp_interval_construct_point(&c_I, &c);
+        lp_value_t one_value;
+        lp_value_construct_int(&one_value, 1);
+        lp_interval_construct_point(&one, &one_value);
+        // tmp = m - cF
+        lp_interval_mul(&tmp, &c_I, &F);
+        propagator_interval_sub(&tmp, &m_I, &tmp);
+        // N = (1 - cD)(X - m)
+        lp_interval_mul(&N, &c_I, &D);
+        propagator_interval_sub(&N, &one, &N);
+        propagator_interval_sub(&D_m, &X, &m_I);
+        lp_interval_mul(&N, &N, &D_m);
+        lp_interval_add(&N, &tmp, &N);
+        lp_interval_destruct(&c_I);
+        lp_interval_destruct(&one);
+        lp_value_destruct(&one_value);
+      }
+      lp_value_destruct(&c);
+    }
+    lp_interval_destruct(&D_m);
+  }
+  propagator_interval_rationalize(&N);
+
+  int result = 0;
+  switch (lp_interval_cmp_with_intersect(lp_interval_assignment_get_interval(M, x), &N, X_new)) {
+  case LP_INTERVAL_CMP_LT_NO_INTERSECT:
+  case LP_INTERVAL_CMP_GT_NO_INTERSECT:
+    result = -1;
+    break;
+  case LP_INTERVAL_CMP_EQ:
+  case LP_INTERVAL_CMP_LT_WITH_INTERSECT_I1:
+  case LP_INTERVAL_CMP_GEQ_WITH_INTERSECT_I1:
+    break;
+  default:
+    result = 1;
+    break;
+  }
+
+  if (trace_is_enabled("interval_propagator")) {
+    tracef("newton_contract_var(%s): ", lp_variable_db_get_name(M->var_db, x));
+    lp_interval_print(&N, trace_out);
+    tracef(" => %d\n", result);
+  }
+
+  lp_interval_destruct(&F);
+  lp_interval_destruct(&D);
+  lp_interval_destruct(&N);
+  lp_interval_destruct(&tmp);
+  lp_polynomial_delete(A_d);
+  lp_interval_assignment_destruct(&M_m);
+  lp_interval_assignment_destruct(&M_X);
+  lp_interval_destruct(&m_I);
+  lp_value_destruct(&m);
+  lp_value_destruct(&two);
+  lp_interval_destruct(&X);
+
+  return result;
+}
+
+int lp_polynomial_constraint_contract_newton(const lp_polynomial_t* A, lp_sign_condition_t sgn_condition, int negated, lp_interval_assignment_t* M) {
+
+  if (negated) {
+    sgn_condition = lp_sign_condition_negate(sgn_condition);
+  }
+  if (sgn_condition != LP_SGN_EQ_0 || lp_polynomial_is_constant(A)) {
+    return 0;
+  }
+
+  if (trace_is_enabled("interval_propagator")) {
+    tracef("lp_polynomial_constraint_contract_newton("); lp_polynomial_print(A, trace_out); tracef(")\n");
+  }
+
+  lp_polynomial_external_clean(A);
+
+  lp_variable_list_t vars;
+  lp_variable_list_construct(&vars);
+  lp_polynomial_get_variables(A, &vars);
+
+  // Contract all from the intervals in M, and then update M
+  size_t i;
+  int result = 0;
+  int* contracted = calloc(vars.list_size, sizeof(int));
+  lp_interval_t* X_new = malloc(sizeof(lp_interval_t)*vars.list_size);
+  for (i = 0; i < vars.list_size; ++ i) {
+    lp_interval_construct_full(X_new + i);
+    if (result >= 0) {
+      contracted[i] = newton_contract_var(A, &vars, M, vars.list[i], X_new + i);
+      if (contracted[i]) {
+        result = contracted[i];
+      }
+    }
+  }
+  for (i = 0; i < vars.list_size; ++ i) {
+    if (result > 0 && contracted[i] > 0) {
+      lp_interval_assignment_set_interval(M, vars.list[i], X_new + i);
+    }
+    lp_interval_destruct(X_new + i);
+  }
+  free(X_new);
+  free(contracted);
+  lp_variable_list_destruct(&vars);
+
+  return result;
+}
+
+lp_polynomial_t* lp_polynomial_constraint_explain_contract_newton(const lp_polynomial_t* A, lp_sign_condition_t sgn_condition, int negated, const lp_interval_assignment_t* M, lp_variable_t x) {
+
+  if (negated) {
+    sgn_condition = lp_sign_condition_negate(sgn_condition);
+  }
+  if (sgn_condition != LP_SGN_EQ_0 || lp_polynomial_is_constant(A)) {
+    return 0;
+  }
+
+  lp_polynomial_external_clean(A);
+  const lp_polynomial_context_t* ctx = A->ctx;
+
+  lp_variable_list_t vars;
+  lp_variable_list_construct(&vars);
+  lp_polynomial_get_variables(A, &vars);
+
+  lp_polynomial_t* result = 0;
+  lp_interval_t X_new;
+  lp_interval_construct_full(&X_new);
+  if (lp_variable_list_contains(&vars, x) && newton_contract_var(A, &vars, M, x, &X_new) > 0) {
+    // l <= x <= u with l = n_l/d_l, u = n_u/d_u is (d_l x - n_l)(d_u x - n_u) <= 0
+    propagator_interval_rationalize(&X_new);
+    size_t i;
+    const lp_value_t* bounds[2] = { &X_new.a, propagator_interval_b(&X_new) };
+    coefficient_t f, f_i;
+    lp_integer_t num, den;
+    integer_construct(&num);
+    integer_construct(&den);
+    coefficient_construct_from_int(ctx, &f, 1);
+    for (i = 0; i < 2; ++ i) {
+      lp_value_get_num(bounds[i], &num);
+      lp_value_get_den(bounds[i], &den);
+      integer_neg(lp_Z, &num, &num);
+      coefficient_construct_linear(ctx, &f_i, &den, &num, x);
+      coefficient_mul(ctx, &f, &f, &f_i);
+      coefficient_destruct(&f_i);
+    }
+    result = lp_polynomial_new_from_coefficient(ctx, &f);
+    coefficient_destruct(&f);
+    integer_destruct(&num);
+    integer_destruct(&den);
+  }
+  lp_interval_destruct(&X_new);
+  lp_variable_list_destruct(&vars);
+
+  return result;
+}
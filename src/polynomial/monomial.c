@@ -22,6 +22,7 @@
 #include "polynomial/polynomial.h"
 
 #include "number/integer.h"
+#include "variable/variable_order.h"
 
 #include <stdlib.h>
 #include <assert.h>
@@ -53,7 +54,7 @@ void lp_monomial_construct_copy(const lp_polynomial_context_t* ctx, lp_monomial_
   if (sort) {
     for (i = 0; i < m->n; ++i) {
       for (j = i + 1; j < m->n; ++j) {
-        if (lp_variable_order_cmp(ctx->var_order, m->p[i].x, m->p[j].x) < 0) {
+        if (variable_order_cmp(ctx->var_order, m->p[i].x, m->p[j].x) < 0) {
           power_t tmp = m->p[i];
           m->p[i] = m->p[j];
           m->p[j] = tmp;
@@ -118,7 +119,7 @@ void lp_monomial_gcd(const lp_polynomial_context_t* ctx, lp_monomial_t* gcd, con
   while (m1_i < m1->n && m2_i < m2->n) {
     // Only keep powers that are equal
     // Variables in the monomial go top to bottom
-    int var_cmp = lp_variable_order_cmp(ctx->var_order, m1->p[m1_i].x, m2->p[m2_i].x);
+    int var_cmp = variable_order_cmp(ctx->var_order, m1->p[m1_i].x, m2->p[m2_i].x);
     if (var_cmp == 0) {
       lp_variable_t x = m1->p[m1_i].x;
       size_t d = MIN(m1->p[m1_i].d, m2->p[m2_i].d);
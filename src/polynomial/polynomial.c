@@ -21,11 +21,13 @@
 #include <feasibility_set.h>
 #include <variable_db.h>
 #include <variable_list.h>
+#include <variable_order.h>
 
 #include "polynomial/polynomial.h"
 
 #include "polynomial/gcd.h"
 #include "polynomial/factorization.h"
+#include "polynomial/polynomial_packed.h"
 #include "polynomial/output.h"
 
 #include "number/rational.h"
@@ -34,6 +36,7 @@
 #include "polynomial/feasibility_set.h"
 #include "polynomial/polynomial_vector.h"
 
+#include "utils/assignment.h"
 #include "utils/debug_trace.h"
 
 #include <assert.h>
@@ -67,10 +70,38 @@ void check_polynomial_assignment(const lp_polynomial_t* A, const lp_assignment_t
   lp_variable_list_destruct(&vars);
 }
 
-void lp_polynomial_external_clean(const lp_polynomial_t* A_const) {
-  if (A_const->external && !coefficient_in_order(A_const->ctx, &A_const->data)) {
+/** Drop the memoized evaluation and order check, called whenever A changes */
+static
+void lp_polynomial_invalidate(lp_polynomial_t* A) {
+  A->order_epoch = 0;
+  if (A->eval_cache) {
+    coefficient_eval_cache_delete(A->eval_cache);
+    A->eval_cache = 0;
+  }
+}
+
+/** Get the memoized evaluation of A (created on demand) */
+static
+coefficient_eval_cache_t* lp_polynomial_eval_cache(const lp_polynomial_t* A_const) {
+  if (!A_const->eval_cache) {
     lp_polynomial_t* A = (lp_polynomial_t*) A_const;
-    coefficient_order(A->ctx, &A->data);
+    A->eval_cache = coefficient_eval_cache_new();
+  }
+  return A_const->eval_cache;
+}
+
+void lp_polynomial_external_clean(const lp_polynomial_t* A_const) {
+  if (A_const->external) {
+    // Only check the order again if it has changed since the last check
+    const lp_variable_order_t* order = A_const->ctx->var_order;
+    if (A_const->order_epoch != lp_variable_order_get_epoch(order)) {
+      lp_polynomial_t* A = (lp_polynomial_t*) A_const;
+      if (!coefficient_in_order(A->ctx, &A->data)) {
+        lp_polynomial_invalidate(A);
+        coefficient_order(A->ctx, &A->data);
+      }
+      A->order_epoch = lp_variable_order_get_epoch(order);
+    }
   }
 }
 
@@ -79,10 +110,14 @@ int lp_polynomial_check_order(const lp_polynomial_t* A) {
 }
 
 void lp_polynomial_ensure_order(lp_polynomial_t* A) {
+  lp_polynomial_invalidate(A);
   coefficient_order(A->ctx, &A->data);
+  A->order_epoch = lp_variable_order_get_epoch(A->ctx->var_order);
 }
 
 void lp_polynomial_set_context(lp_polynomial_t* A, const lp_polynomial_context_t* ctx) {
+  // Called before A is overwritten
+  lp_polynomial_invalidate(A);
   if (A->ctx != ctx) {
     if (A->ctx && A->external) {
       lp_polynomial_context_detach((lp_polynomial_context_t*)A->ctx);
@@ -98,6 +133,8 @@ void lp_polynomial_construct(lp_polynomial_t* A, const lp_polynomial_context_t*
   A->ctx = 0;
   A->external = 0;
   A->hash = 0;
+  A->order_epoch = 0;
+  A->eval_cache = 0;
   lp_polynomial_set_context(A, ctx);
   coefficient_construct(ctx, &A->data);
 }
@@ -106,6 +143,8 @@ void lp_polynomial_construct_from_coefficient(lp_polynomial_t* A, const lp_polyn
   A->ctx = 0;
   A->external = 0;
   A->hash = 0;
+  A->order_epoch = 0;
+  A->eval_cache = 0;
   lp_polynomial_set_context(A, ctx);
   coefficient_construct_copy(A->ctx, &A->data, from);
 }
@@ -120,6 +159,8 @@ void lp_polynomial_construct_copy(lp_polynomial_t* A, const lp_polynomial_t* fro
   A->ctx = 0;
   A->external = 0;
   A->hash = from->hash;
+  A->order_epoch = 0;
+  A->eval_cache = 0;
   lp_polynomial_set_context(A, from->ctx);
   coefficient_construct_copy(A->ctx, &A->data, &from->data);
 }
@@ -132,11 +173,14 @@ void lp_polynomial_construct_simple(
   A->ctx = 0;
   A->external = 0;
   A->hash = 0;
+  A->order_epoch = 0;
+  A->eval_cache = 0;
   lp_polynomial_set_context(A, ctx);
   coefficient_construct_simple(ctx, &A->data, c, x, n);
 }
 
 void lp_polynomial_destruct(lp_polynomial_t* A) {
+  lp_polynomial_invalidate(A);
   coefficient_destruct(&A->data);
   if (A->external) {
     lp_polynomial_context_detach((lp_polynomial_context_t*)A->ctx);
@@ -302,7 +346,9 @@ int lp_polynomial_sgn(const lp_polynomial_t* A, const lp_assignment_t* m) {
     check_polynomial_assignment(A, m, lp_variable_null);
   }
 
-  return coefficient_sgn(A->ctx, &A->data, m);
+  // Usually only the top variable changes between calls, so we keep the
+  // evaluation of the coefficients
+  return coefficient_sgn_cached(A->ctx, &A->data, m, lp_polynomial_eval_cache(A));
 }
 
 void lp_polynomial_interval_value(const lp_polynomial_t* A, const lp_interval_assignment_t* m, lp_interval_t* result) {
@@ -405,6 +451,7 @@ void lp_polynomial_add_monomial(lp_polynomial_t* S, const lp_monomial_t* M) {
   }
 
   lp_polynomial_external_clean(S);
+  lp_polynomial_invalidate(S);
 
   coefficient_add_monomial(S->ctx, &S->data, M);
 
@@ -464,7 +511,9 @@ void lp_polynomial_mul(lp_polynomial_t* P, const lp_polynomial_t* A1, const lp_p
 
   lp_polynomial_set_context(P, A1->ctx);
 
-  coefficient_mul(P->ctx, &P->data, &A1->data, &A2->data);
+  if (!coefficient_mul_packed(P->ctx, &P->data, &A1->data, &A2->data)) {
+    coefficient_mul(P->ctx, &P->data, &A1->data, &A2->data);
+  }
 
   if (trace_is_enabled("polynomial")) {
     tracef("polynomial_mul() => "); lp_polynomial_print(P, trace_out); tracef("\n");
@@ -519,7 +568,9 @@ void lp_polynomial_pow(lp_polynomial_t* P, const lp_polynomial_t* A, unsigned n)
 
   lp_polynomial_set_context(P, A->ctx);
 
-  coefficient_pow(P->ctx, &P->data, &A->data, n);
+  if (!coefficient_pow_packed(P->ctx, &P->data, &A->data, n)) {
+    coefficient_pow(P->ctx, &P->data, &A->data, n);
+  }
 
   if (trace_is_enabled("polynomial")) {
     tracef("polynomial_pow() => "); lp_polynomial_print(P, trace_out); tracef("\n");
@@ -536,6 +587,7 @@ void lp_polynomial_add_mul(lp_polynomial_t* S, const lp_polynomial_t* A1, const
   lp_polynomial_external_clean(S);
   lp_polynomial_external_clean(A1);
   lp_polynomial_external_clean(A2);
+  lp_polynomial_invalidate(S);
 
   coefficient_add_mul(ctx, &S->data, &A1->data, &A2->data);
 }
@@ -550,6 +602,7 @@ void lp_polynomial_sub_mul(lp_polynomial_t* S, const lp_polynomial_t* A1, const
   lp_polynomial_external_clean(S);
   lp_polynomial_external_clean(A1);
   lp_polynomial_external_clean(A2);
+  lp_polynomial_invalidate(S);
 
   coefficient_sub_mul(ctx, &S->data, &A1->data, &A2->data);
 }
@@ -571,7 +624,7 @@ void lp_polynomial_div(lp_polynomial_t* D, const lp_polynomial_t* A1, const lp_p
 
   lp_polynomial_set_context(D, A1->ctx);
 
-  coefficient_div(D->ctx, &D->data, &A1->data, &A2->data);
+  coefficient_div_exact(D->ctx, &D->data, &A1->data, &A2->data);
 
   if (trace_is_enabled("polynomial")) {
     tracef("polynomial_div() => "); lp_polynomial_print(D, trace_out); tracef("\n");
@@ -891,6 +944,7 @@ void lp_polynomial_resultant(lp_polynomial_t* res, const lp_polynomial_t* A, con
 
   lp_polynomial_external_clean(A);
   lp_polynomial_external_clean(B);
+  lp_polynomial_invalidate(res);
 
   // Compute
   coefficient_resultant(ctx, &res->data, &A->data, &B->data);
@@ -1023,12 +1077,11 @@ void lp_polynomial_roots_isolate(const lp_polynomial_t* A, const lp_assignment_t
   lp_variable_t x = lp_polynomial_top_variable(A);
   assert(x != lp_variable_null);
 
+  // Unassign x for the isolation (restored below)
   lp_value_t x_value_backup;
+  lp_value_construct_none(&x_value_backup);
   if (lp_assignment_get_value(M, x)->type != LP_VALUE_NONE) {
-    lp_value_construct_copy(&x_value_backup, lp_assignment_get_value(M, x));
-    lp_assignment_set_value((lp_assignment_t*) M, x, 0);
-  } else {
-    lp_value_construct_none(&x_value_backup);
+    assignment_swap_value((lp_assignment_t*) M, x, &x_value_backup);
   }
 
   size_t i;
@@ -1138,7 +1191,7 @@ void lp_polynomial_roots_isolate(const lp_polynomial_t* A, const lp_assignment_t
 
   // Reset the value
   if (x_value_backup.type != LP_VALUE_NONE) {
-    lp_assignment_set_value((lp_assignment_t*) M, x, &x_value_backup);
+    assignment_swap_value((lp_assignment_t*) M, x, &x_value_backup);
   }
 
   // Destroy the temps
@@ -1231,9 +1284,9 @@ lp_feasibility_set_t* lp_polynomial_constraint_get_feasible_set(const lp_polynom
     signs[2*i+1] = 0;
     if (i+1<roots_size) {
       lp_value_get_value_between(roots + i, 1, roots + i + 1, 1, &m);
-      lp_assignment_set_value((lp_assignment_t*) M, x, &m);
-      signs[2*i+2] = coefficient_sgn(A->ctx, &A->data, M);
-      lp_assignment_set_value((lp_assignment_t*) M, x, 0);
+      assignment_swap_value((lp_assignment_t*) M, x, &m);
+      signs[2*i+2] = coefficient_sgn_cached(A->ctx, &A->data, M, lp_polynomial_eval_cache(A));
+      assignment_swap_value((lp_assignment_t*) M, x, &m);
     }
   }
   lp_value_destruct(&m);
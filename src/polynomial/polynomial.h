@@ -32,6 +32,10 @@ struct lp_polynomial_struct {
   char external;
   /** Context of the polynomial */
   const lp_polynomial_context_t* ctx;
+  /** Epoch of the variable order the data was checked against (0 if none) */
+  size_t order_epoch;
+  /** Memoized evaluation in an assignment (0 if none) */
+  coefficient_eval_cache_t* eval_cache;
 };
 
 /** Construct from coefficient */
@@ -39,3 +43,6 @@ void lp_polynomial_construct_from_coefficient(lp_polynomial_t* A, const lp_polyn
 
 /** New from coefficient */
 lp_polynomial_t* lp_polynomial_new_from_coefficient(const lp_polynomial_context_t* ctx, const coefficient_t* from);
+
+/** Reorder the data of an external polynomial if the variable order has changed */
+void lp_polynomial_external_clean(const lp_polynomial_t* A);
@@ -19,6 +19,10 @@
 
 #include <variable_db.h>
 #include <polynomial_context.h>
+#include <variable_order.h>
+#include <variable_list.h>
+
+#include "polynomial/polynomial_context.h"
 
 #include <stdlib.h>
 #include <assert.h>
@@ -86,6 +90,32 @@ lp_polynomial_context_t* lp_polynomial_context_new(lp_int_ring_t* K, lp_variable
   return result;
 }
 
+lp_polynomial_context_t* lp_polynomial_context_new_scratch(const lp_polynomial_context_t* ctx) {
+  lp_polynomial_context_t* result = malloc(sizeof(lp_polynomial_context_t));
+  result->ref_count = 0;
+  result->K = ctx->K;
+  result->var_db = ctx->var_db;
+  result->var_order = 0;
+  if (ctx->var_order) {
+    result->var_order = lp_variable_order_new();
+    const lp_variable_list_t* list = lp_variable_order_get_list(ctx->var_order);
+    size_t i;
+    for (i = 0; i < list->list_size; ++ i) {
+      lp_variable_order_push(result->var_order, list->list[i]);
+    }
+  }
+  result->var_tmp = malloc(sizeof(lp_variable_t)*TEMP_VARIABLE_SIZE);
+  result->var_tmp_size = 0;
+  size_t i;
+  for (i = 0; i < TEMP_VARIABLE_SIZE; ++ i) {
+    result->var_tmp[i] = ctx->var_tmp[i];
+  }
+  lp_polynomial_context_attach(result);
+  if (result->var_order) {
+    lp_variable_order_detach(result->var_order);
+  }
+  return result;
+}
 
 int lp_polynomial_context_equal(const lp_polynomial_context_t* ctx1, const lp_polynomial_context_t* ctx2) {
   if (ctx1 == ctx2) return 1;
@@ -26,3 +26,12 @@ lp_variable_t lp_polynomial_context_get_temp_variable(const lp_polynomial_contex
 
 /** Release the variable (has to be the last one obtained and not released */
 void lp_polynomial_context_release_temp_variable(const lp_polynomial_context_t* ctx_const, lp_variable_t x);
+
+/**
+ * Create a scratch copy of the context, with the same ring, variable database
+ * and temporary variables, but its own copy of the variable order. Some
+ * operations (e.g. root isolation) change the variable order and take
+ * temporary variables while they run, so each thread needs its own copy.
+ * Polynomials of the copy must not be mixed with polynomials of the original.
+ */
+lp_polynomial_context_t* lp_polynomial_context_new_scratch(const lp_polynomial_context_t* ctx);
@@ -0,0 +1,827 @@
+/**
+ * Copyright 2015, SRI International.
+ *
+ * This file is part of LibPoly.
+ *
+ * LibPoly is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LibPoly is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with LibPoly.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polynomial/polynomial_packed.h"
+#include "polynomial/polynomial_context.h"
+#include "variable/variable_order.h"
+
+#include <variable_order.h>
+
+#include "utils/debug_trace.h"
+#include "utils/statistics.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+
+/**
+ * Only multiply through the packed representation if the number of monomial
+ * products is at least this big.
+ */
+#define PACKED_MUL_THRESHOLD 256
+
+/**
+ * Only reorder through the packed representation if the polynomial has at
+ * least this many monomials.
+ */
+#define PACKED_ORDER_THRESHOLD 16
+
+void packed_layout_construct(packed_layout_t* L) {
+  L->size = 0;
+  L->guard = 0;
+}
+
+static
+size_t packed_layout_index(const packed_layout_t* L, lp_variable_t x) {
+  size_t i;
+  for (i = 0; i < L->size; ++ i) {
+    if (L->vars[i] == x) {
+      return i;
+    }
+  }
+  return L->size;
+}
+
+static inline
+unsigned long packed_layout_get_degree(const packed_layout_t* L, packed_exp_t e, size_t i) {
+  return (e >> L->offset[i]) & L->mask[i];
+}
+
+/** Collect the maximal degrees of C into max (indexed as in L) */
+static
+int packed_layout_collect(packed_layout_t* L, const coefficient_t* C, unsigned long* max) {
+  size_t i;
+  if (C->type == COEFFICIENT_NUMERIC) {
+    return 1;
+  }
+  i = packed_layout_index(L, VAR(C));
+  if (i == L->size) {
+    if (L->size == PACKED_LAYOUT_MAX_VARS) {
+      return 0;
+    }
+    L->vars[i] = VAR(C);
+    L->degrees[i] = 0;
+    L->size ++;
+  }
+  if (SIZE(C) - 1 > max[i]) {
+    max[i] = SIZE(C) - 1;
+  }
+  for (i = 0; i < SIZE(C); ++ i) {
+    if (!packed_layout_collect(L, COEFF(C, i), max)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+int packed_layout_add(const lp_polynomial_context_t* ctx, packed_layout_t* L, const coefficient_t* C, unsigned n) {
+  unsigned long max[PACKED_LAYOUT_MAX_VARS] = { 0 };
+  size_t i;
+
+  (void) ctx;
+
+  if (!packed_layout_collect(L, C, max)) {
+    return 0;
+  }
+  for (i = 0; i < L->size; ++ i) {
+    if (n > 0 && max[i] > (ULONG_MAX - L->degrees[i]) / n) {
+      return 0;
+    }
+    L->degrees[i] += max[i] * n;
+  }
+
+  return 1;
+}
+
+int packed_layout_setup(const lp_polynomial_context_t* ctx, packed_layout_t* L) {
+  size_t i, j, bits;
+  unsigned offset;
+
+  // Sort the variables, top variable first
+  for (i = 1; i < L->size; ++ i) {
+    lp_variable_t x = L->vars[i];
+    unsigned long d = L->degrees[i];
+    for (j = i; j > 0 && variable_order_cmp(ctx->var_order, L->vars[j-1], x) < 0; -- j) {
+      L->vars[j] = L->vars[j-1];
+      L->degrees[j] = L->degrees[j-1];
+    }
+    L->vars[j] = x;
+    L->degrees[j] = d;
+  }
+
+  // Allocate the fields, bottom variable in the lowest bits
+  offset = 0;
+  L->guard = 0;
+  for (i = L->size; i > 0; -- i) {
+    for (bits = 0; bits < 64 && (L->degrees[i-1] >> bits); ++ bits) {}
+    if (offset + bits + 1 > 64) {
+      return 0;
+    }
+    L->offset[i-1] = offset;
+    L->mask[i-1] = ((packed_exp_t) 1 << bits) - 1;
+    L->guard |= (packed_exp_t) 1 << (offset + bits);
+    offset += bits + 1;
+  }
+
+  return 1;
+}
+
+void polynomial_packed_construct(polynomial_packed_t* P, size_t capacity) {
+  P->size = 0;
+  P->capacity = 0;
+  P->exp = 0;
+  P->coeff = 0;
+  polynomial_packed_ensure_capacity(P, capacity);
+}
+
+void polynomial_packed_ensure_capacity(polynomial_packed_t* P, size_t capacity) {
+  size_t i;
+  if (capacity > P->capacity) {
+    P->exp = realloc(P->exp, capacity * sizeof(packed_exp_t));
+    P->coeff = realloc(P->coeff, capacity * sizeof(lp_integer_t));
+    for (i = P->capacity; i < capacity; ++ i) {
+      integer_construct(P->coeff + i);
+    }
+    P->capacity = capacity;
+  }
+}
+
+void polynomial_packed_destruct(polynomial_packed_t* P) {
+  size_t i;
+  for (i = 0; i < P->capacity; ++ i) {
+    integer_destruct(P->coeff + i);
+  }
+  free(P->exp);
+  free(P->coeff);
+}
+
+void polynomial_packed_swap(polynomial_packed_t* P, polynomial_packed_t* Q) {
+  polynomial_packed_t tmp = *P;
+  *P = *Q;
+  *Q = tmp;
+}
+
+size_t coefficient_terms_count(const coefficient_t* C) {
+  size_t i, count = 0;
+  switch (C->type) {
+  case COEFFICIENT_NUMERIC:
+    return integer_sgn(lp_Z, &C->value.num) != 0;
+  case COEFFICIENT_POLYNOMIAL:
+    for (i = 0; i < SIZE(C); ++ i) {
+      count += coefficient_terms_count(COEFF(C, i));
+    }
+    break;
+  }
+  return count;
+}
+
+/**
+ * Append the monomials of C times the monomial e to P. If C is ordered as the
+ * layout, the monomials are appended in increasing order. If move is true,
+ * the coefficients are moved out of C, leaving zeros behind.
+ */
+static
+void packed_fill(const lp_polynomial_context_t* ctx, polynomial_packed_t* P, const packed_layout_t* L, coefficient_t* C, packed_exp_t e, int move) {
+  size_t i, x_i;
+  unsigned offset;
+
+  switch (C->type) {
+  case COEFFICIENT_NUMERIC:
+    if (!integer_is_zero(ctx->K, &C->value.num)) {
+      assert(P->size < P->capacity);
+      P->exp[P->size] = e;
+      if (move) {
+        integer_swap(P->coeff + P->size, &C->value.num);
+      } else {
+        integer_assign(ctx->K, P->coeff + P->size, &C->value.num);
+      }
+      P->size ++;
+    }
+    break;
+  case COEFFICIENT_POLYNOMIAL:
+    x_i = packed_layout_index(L, VAR(C));
+    assert(x_i < L->size);
+    assert(SIZE(C) - 1 <= L->mask[x_i]);
+    offset = L->offset[x_i];
+    for (i = 0; i < SIZE(C); ++ i) {
+      packed_fill(ctx, P, L, COEFF(C, i), e + ((packed_exp_t) i << offset), move);
+    }
+    break;
+  }
+}
+
+static inline
+int packed_is_sorted(const polynomial_packed_t* P) {
+  size_t i;
+  for (i = 1; i < P->size; ++ i) {
+    if (P->exp[i-1] >= P->exp[i]) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+STAT_DECLARE(int, polynomial_packed, construct_from_coefficient)
+
+void polynomial_packed_construct_from_coefficient(const lp_polynomial_context_t* ctx, polynomial_packed_t* P, const packed_layout_t* L, const coefficient_t* C) {
+  STAT_INCR(polynomial_packed, construct_from_coefficient)
+  polynomial_packed_construct(P, coefficient_terms_count(C));
+  // C is not changed when copying
+  packed_fill(ctx, P, L, (coefficient_t*) C, 0, 0);
+  assert(packed_is_sorted(P));
+}
+
+/**
+ * Build the monomials [begin, end) of P into C. All the monomials agree on
+ * the variables before the given level. If move is true, the coefficients are
+ * moved out of P, leaving zeros behind.
+ */
+static
+void packed_build(const lp_polynomial_context_t* ctx, coefficient_t* C, const packed_layout_t* L, const polynomial_packed_t* P, size_t begin, size_t end, size_t level, int move) {
+
+  size_t i, j;
+  unsigned long d;
+  coefficient_t result;
+
+  assert(begin < end);
+
+  // Degrees of the variable at level are increasing, so if the last one is 0
+  // the variable doesn't appear in this range
+  while (level < L->size && packed_layout_get_degree(L, P->exp[end-1], level) == 0) {
+    level ++;
+  }
+
+  if (level == L->size) {
+    assert(end == begin + 1);
+    if (move && C->type == COEFFICIENT_NUMERIC) {
+      integer_swap(&C->value.num, P->coeff + begin);
+    } else {
+      coefficient_assign_integer(ctx, C, P->coeff + begin);
+    }
+    return;
+  }
+
+  d = packed_layout_get_degree(L, P->exp[end-1], level);
+  coefficient_construct_rec(ctx, &result, L->vars[level], d + 1);
+  for (i = begin; i < end; i = j) {
+    d = packed_layout_get_degree(L, P->exp[i], level);
+    for (j = i + 1; j < end && packed_layout_get_degree(L, P->exp[j], level) == d; ++ j) {}
+    packed_build(ctx, COEFF(&result, d), L, P, i, j, level + 1, move);
+  }
+  coefficient_swap(C, &result);
+  coefficient_destruct(&result);
+}
+
+STAT_DECLARE(int, polynomial_packed, to_coefficient)
+
+void polynomial_packed_to_coefficient(const lp_polynomial_context_t* ctx, coefficient_t* C, const packed_layout_t* L, const polynomial_packed_t* P) {
+  STAT_INCR(polynomial_packed, to_coefficient)
+  if (P->size == 0) {
+    coefficient_assign_int(ctx, C, 0);
+  } else {
+    packed_build(ctx, C, L, P, 0, P->size, 0, 0);
+  }
+  assert(coefficient_is_normalized(ctx, C));
+}
+
+STAT_DECLARE(int, polynomial_packed, add)
+
+void polynomial_packed_add(const lp_int_ring_t* K, polynomial_packed_t* S, const polynomial_packed_t* A, const polynomial_packed_t* B) {
+  STAT_INCR(polynomial_packed, add)
+
+  size_t i = 0, j = 0;
+  polynomial_packed_t result;
+  polynomial_packed_construct(&result, A->size + B->size);
+
+  while (i < A->size && j < B->size) {
+    if (A->exp[i] < B->exp[j]) {
+      result.exp[result.size] = A->exp[i];
+      integer_assign(K, result.coeff + result.size, A->coeff + i);
+      result.size ++;
+      i ++;
+    } else if (A->exp[i] > B->exp[j]) {
+      result.exp[result.size] = B->exp[j];
+      integer_assign(K, result.coeff + result.size, B->coeff + j);
+      result.size ++;
+      j ++;
+    } else {
+      result.exp[result.size] = A->exp[i];
+      integer_add(K, result.coeff + result.size, A->coeff + i, B->coeff + j);
+      if (!integer_is_zero(K, result.coeff + result.size)) {
+        result.size ++;
+      }
+      i ++;
+      j ++;
+    }
+  }
+  for (; i < A->size; ++ i, ++ result.size) {
+    result.exp[result.size] = A->exp[i];
+    integer_assign(K, result.coeff + result.size, A->coeff + i);
+  }
+  for (; j < B->size; ++ j, ++ result.size) {
+    result.exp[result.size] = B->exp[j];
+    integer_assign(K, result.coeff + result.size, B->coeff + j);
+  }
+
+  polynomial_packed_swap(S, &result);
+  polynomial_packed_destruct(&result);
+}
+
+/** Entry of the heap: the product of the i-th and j-th monomials, from the top */
+typedef struct {
+  packed_exp_t exp;
+  size_t i, j;
+} packed_heap_entry_t;
+
+/** Max-heap of monomial products, ordered by the exponent */
+typedef struct {
+  size_t size;
+  size_t capacity;
+  packed_heap_entry_t* data;
+} packed_heap_t;
+
+static
+void packed_heap_construct(packed_heap_t* h, size_t capacity) {
+  h->size = 0;
+  h->capacity = capacity ? capacity : 1;
+  h->data = malloc(h->capacity * sizeof(packed_heap_entry_t));
+}
+
+static
+void packed_heap_destruct(packed_heap_t* h) {
+  free(h->data);
+}
+
+static
+void packed_heap_push(packed_heap_t* h, packed_exp_t exp, size_t i, size_t j) {
+  size_t k, parent;
+  if (h->size == h->capacity) {
+    h->capacity *= 2;
+    h->data = realloc(h->data, h->capacity * sizeof(packed_heap_entry_t));
+  }
+  // Sift up
+  for (k = h->size ++; k > 0; k = parent) {
+    parent = (k - 1) / 2;
+    if (h->data[parent].exp >= exp) {
+      break;
+    }
+    h->data[k] = h->data[parent];
+  }
+  h->data[k].exp = exp;
+  h->data[k].i = i;
+  h->data[k].j = j;
+}
+
+static
+void packed_heap_pop(packed_heap_t* h) {
+  size_t k, child;
+  packed_heap_entry_t last;
+  assert(h->size > 0);
+  last = h->data[-- h->size];
+  // Sift down
+  for (k = 0; (child = 2*k + 1) < h->size; k = child) {
+    if (child + 1 < h->size && h->data[child + 1].exp > h->data[child].exp) {
+      child ++;
+    }
+    if (last.exp >= h->data[child].exp) {
+      break;
+    }
+    h->data[k] = h->data[child];
+  }
+  h->data[k] = last;
+}
+
+/** Exponent of the i-th monomial, counting from the top */
+#define TOP_EXP(P, i) ((P)->exp[(P)->size - 1 - (i)])
+/** Coefficient of the i-th monomial, counting from the top */
+#define TOP_COEFF(P, i) ((P)->coeff + (P)->size - 1 - (i))
+
+/** Reverse the order of monomials (used for results computed top-down) */
+static
+void packed_reverse(polynomial_packed_t* P) {
+  size_t i, j;
+  packed_exp_t tmp;
+  for (i = 0, j = P->size; i + 1 < j; ++ i, -- j) {
+    tmp = P->exp[i];
+    P->exp[i] = P->exp[j-1];
+    P->exp[j-1] = tmp;
+    integer_swap(P->coeff + i, P->coeff + j - 1);
+  }
+}
+
+/** Make sure there is room for one more monomial, growing geometrically */
+static inline
+void packed_ensure_one_more(polynomial_packed_t* P) {
+  if (P->size == P->capacity) {
+    polynomial_packed_ensure_capacity(P, 2*P->capacity + 1);
+  }
+}
+
+STAT_DECLARE(int, polynomial_packed, mul)
+
+void polynomial_packed_mul(const lp_int_ring_t* K, polynomial_packed_t* P, const polynomial_packed_t* A, const polynomial_packed_t* B) {
+  STAT_INCR(polynomial_packed, mul)
+
+  size_t i, j;
+  packed_exp_t e;
+  lp_integer_t* c;
+  packed_heap_t heap;
+  polynomial_packed_t result;
+
+  // Heap is as big as the smaller polynomial
+  if (A->size > B->size) {
+    const polynomial_packed_t* tmp = A;
+    A = B;
+    B = tmp;
+  }
+
+  polynomial_packed_construct(&result, A->size + B->size);
+
+  if (A->size > 0) {
+    // Merge the rows A_i*B, top-down. Row i+1 enters the heap once the first
+    // product of row i has been consumed, so the heap has at most |A| entries.
+    packed_heap_construct(&heap, A->size);
+    packed_heap_push(&heap, TOP_EXP(A, 0) + TOP_EXP(B, 0), 0, 0);
+    while (heap.size > 0) {
+      e = heap.data[0].exp;
+      packed_ensure_one_more(&result);
+      c = result.coeff + result.size;
+      integer_assign_int(K, c, 0);
+      while (heap.size > 0 && heap.data[0].exp == e) {
+        i = heap.data[0].i;
+        j = heap.data[0].j;
+        packed_heap_pop(&heap);
+        integer_add_mul(K, c, TOP_COEFF(A, i), TOP_COEFF(B, j));
+        if (j == 0 && i + 1 < A->size) {
+          packed_heap_push(&heap, TOP_EXP(A, i + 1) + TOP_EXP(B, 0), i + 1, 0);
+        }
+        if (j + 1 < B->size) {
+          packed_heap_push(&heap, TOP_EXP(A, i) + TOP_EXP(B, j + 1), i, j + 1);
+        }
+      }
+      if (!integer_is_zero(K, c)) {
+        result.exp[result.size ++] = e;
+      }
+    }
+    packed_heap_destruct(&heap);
+    packed_reverse(&result);
+  }
+
+  polynomial_packed_swap(P, &result);
+  polynomial_packed_destruct(&result);
+}
+
+STAT_DECLARE(int, polynomial_packed, div_exact)
+
+int polynomial_packed_div_exact(const lp_int_ring_t* K, const packed_layout_t* L, polynomial_packed_t* Q, const polynomial_packed_t* A, const polynomial_packed_t* B) {
+  STAT_INCR(polynomial_packed, div_exact)
+
+  size_t i, j, k;
+  int exact = 1;
+  packed_exp_t e, lm_B;
+  const lp_integer_t* lc_B;
+  lp_integer_t c;
+  packed_heap_t heap;
+  polynomial_packed_t result;
+
+  assert(B->size > 0);
+
+  lm_B = TOP_EXP(B, 0);
+  lc_B = TOP_COEFF(B, 0);
+
+  integer_construct(&c);
+  packed_heap_construct(&heap, 0);
+  polynomial_packed_construct(&result, A->size / B->size + 1);
+
+  // The heap holds the products Q_i*B_j for j > 0 that are still to be
+  // subtracted, with one entry per quotient monomial. The next monomial of
+  // A - Q*B is the bigger of the next monomial of A and the top of the heap.
+  k = 0;
+  while (k < A->size || heap.size > 0) {
+    if (heap.size == 0 || (k < A->size && TOP_EXP(A, k) > heap.data[0].exp)) {
+      e = TOP_EXP(A, k);
+      integer_assign(K, &c, TOP_COEFF(A, k));
+      k ++;
+    } else {
+      e = heap.data[0].exp;
+      if (k < A->size && TOP_EXP(A, k) == e) {
+        integer_assign(K, &c, TOP_COEFF(A, k));
+        k ++;
+      } else {
+        integer_assign_int(K, &c, 0);
+      }
+      while (heap.size > 0 && heap.data[0].exp == e) {
+        i = heap.data[0].i;
+        j = heap.data[0].j;
+        packed_heap_pop(&heap);
+        integer_sub_mul(K, &c, result.coeff + i, TOP_COEFF(B, j));
+        if (j + 1 < B->size) {
+          packed_heap_push(&heap, result.exp[i] + TOP_EXP(B, j + 1), i, j + 1);
+        }
+      }
+    }
+
+    if (integer_is_zero(K, &c)) {
+      continue;
+    }
+
+    // Leading monomial of B must divide the current monomial
+    if (((e - lm_B) & L->guard) || !integer_divides(K, lc_B, &c)) {
+      exact = 0;
+      break;
+    }
+
+    packed_ensure_one_more(&result);
+    result.exp[result.size] = e - lm_B;
+    integer_div_exact(K, result.coeff + result.size, &c, lc_B);
+    if (B->size > 1) {
+      packed_heap_push(&heap, result.exp[result.size] + TOP_EXP(B, 1), result.size, 1);
+    }
+    result.size ++;
+  }
+
+  if (exact) {
+    packed_reverse(&result);
+    polynomial_packed_swap(Q, &result);
+  }
+
+  polynomial_packed_destruct(&result);
+  packed_heap_destruct(&heap);
+  integer_destruct(&c);
+
+  return exact;
+}
+
+STAT_DECLARE(int, polynomial_packed, pow)
+
+void polynomial_packed_pow(const lp_int_ring_t* K, polynomial_packed_t* P, const polynomial_packed_t* A, unsigned n) {
+  STAT_INCR(polynomial_packed, pow)
+
+  polynomial_packed_t result, tmp;
+
+  // Accumulator for A^n (start with 1)
+  polynomial_packed_construct(&result, 1);
+  result.exp[0] = 0;
+  integer_assign_int(K, result.coeff, 1);
+  result.size = integer_is_zero(K, result.coeff) ? 0 : 1;
+
+  // A^power of 2 (start with A)
+  polynomial_packed_construct(&tmp, 0);
+  polynomial_packed_add(K, &tmp, &tmp, A);
+
+  while (n) {
+    if (n & 1) {
+      polynomial_packed_mul(K, &result, &result, &tmp);
+    }
+    n >>= 1;
+    if (n) {
+      polynomial_packed_mul(K, &tmp, &tmp, &tmp);
+    }
+  }
+
+  polynomial_packed_swap(P, &result);
+  polynomial_packed_destruct(&tmp);
+  polynomial_packed_destruct(&result);
+}
+
+STAT_DECLARE(int, coefficient, mul_packed)
+
+int coefficient_mul_packed(const lp_polynomial_context_t* ctx, coefficient_t* P, const coefficient_t* C1, const coefficient_t* C2) {
+
+  packed_layout_t L;
+  polynomial_packed_t A1, A2;
+
+  if (C1->type == COEFFICIENT_NUMERIC || C2->type == COEFFICIENT_NUMERIC) {
+    return 0;
+  }
+
+  if (coefficient_terms_count(C1) * coefficient_terms_count(C2) < PACKED_MUL_THRESHOLD) {
+    return 0;
+  }
+
+  // Univariate products are already dense in the recursive representation
+  packed_layout_construct(&L);
+  if (!packed_layout_add(ctx, &L, C1, 1) || !packed_layout_add(ctx, &L, C2, 1) || L.size < 2) {
+    return 0;
+  }
+  if (!packed_layout_setup(ctx, &L)) {
+    return 0;
+  }
+
+  TRACE("coefficient::arith", "coefficient_mul_packed()\n");
+  STAT_INCR(coefficient, mul_packed)
+
+  polynomial_packed_construct_from_coefficient(ctx, &A1, &L, C1);
+  polynomial_packed_construct_from_coefficient(ctx, &A2, &L, C2);
+  polynomial_packed_mul(ctx->K, &A1, &A1, &A2);
+  polynomial_packed_to_coefficient(ctx, P, &L, &A1);
+  polynomial_packed_destruct(&A1);
+  polynomial_packed_destruct(&A2);
+
+  return 1;
+}
+
+STAT_DECLARE(int, coefficient, pow_packed)
+
+int coefficient_pow_packed(const lp_polynomial_context_t* ctx, coefficient_t* P, const coefficient_t* C, unsigned n) {
+
+  packed_layout_t L;
+  polynomial_packed_t A;
+  size_t terms;
+
+  if (C->type == COEFFICIENT_NUMERIC || n < 2) {
+    return 0;
+  }
+
+  terms = coefficient_terms_count(C);
+  if (terms * terms < PACKED_MUL_THRESHOLD) {
+    return 0;
+  }
+
+  packed_layout_construct(&L);
+  if (!packed_layout_add(ctx, &L, C, n) || L.size < 2) {
+    return 0;
+  }
+  if (!packed_layout_setup(ctx, &L)) {
+    return 0;
+  }
+
+  TRACE("coefficient::arith", "coefficient_pow_packed()\n");
+  STAT_INCR(coefficient, pow_packed)
+
+  polynomial_packed_construct_from_coefficient(ctx, &A, &L, C);
+  polynomial_packed_pow(ctx->K, &A, &A, n);
+  polynomial_packed_to_coefficient(ctx, P, &L, &A);
+  polynomial_packed_destruct(&A);
+
+  return 1;
+}
+
+/**
+ * Only divide through the packed representation if the dividend has at least
+ * this many monomials.
+ */
+#define PACKED_DIV_THRESHOLD 64
+
+STAT_DECLARE(int, coefficient, div_packed)
+
+/** Compute D = C1/C2 with the heap division, returns 0 if not applicable */
+static
+int coefficient_div_packed(const lp_polynomial_context_t* ctx, coefficient_t* D, const coefficient_t* C1, const coefficient_t* C2) {
+
+  int exact;
+  packed_layout_t L;
+  polynomial_packed_t A1, A2;
+
+  if (C1->type == COEFFICIENT_NUMERIC || C2->type == COEFFICIENT_NUMERIC) {
+    return 0;
+  }
+
+  if (coefficient_terms_count(C1) < PACKED_DIV_THRESHOLD) {
+    return 0;
+  }
+
+  packed_layout_construct(&L);
+  if (!packed_layout_add(ctx, &L, C1, 1) || !packed_layout_add(ctx, &L, C2, 1) || L.size < 2) {
+    return 0;
+  }
+  if (!packed_layout_setup(ctx, &L)) {
+    return 0;
+  }
+
+  TRACE("coefficient", "coefficient_div_packed()\n");
+  STAT_INCR(coefficient, div_packed)
+
+  polynomial_packed_construct_from_coefficient(ctx, &A1, &L, C1);
+  polynomial_packed_construct_from_coefficient(ctx, &A2, &L, C2);
+  exact = polynomial_packed_div_exact(ctx->K, &L, &A1, &A1, &A2);
+  if (exact) {
+    polynomial_packed_to_coefficient(ctx, D, &L, &A1);
+  }
+  polynomial_packed_destruct(&A1);
+  polynomial_packed_destruct(&A2);
+
+  return exact;
+}
+
+void coefficient_div_exact(const lp_polynomial_context_t* ctx, coefficient_t* D, const coefficient_t* C1, const coefficient_t* C2) {
+  if (!coefficient_div_packed(ctx, D, C1, C2)) {
+    coefficient_div(ctx, D, C1, C2);
+  }
+}
+
+/** A monomial being sorted, with its position in the polynomial */
+typedef struct {
+  packed_exp_t exp;
+  size_t index;
+} packed_sort_entry_t;
+
+/**
+ * Sort the monomials of P in increasing order with a radix sort on the
+ * exponents, a byte at a time, only looking at the bytes used by the layout.
+ * The coefficients are moved, not copied.
+ */
+static
+void packed_sort(polynomial_packed_t* P, const packed_layout_t* L) {
+  size_t i, d, n = P->size;
+  unsigned shift, bits;
+  size_t count[257];
+
+  packed_sort_entry_t* a = malloc(sizeof(packed_sort_entry_t)*n);
+  packed_sort_entry_t* b = malloc(sizeof(packed_sort_entry_t)*n);
+  for (i = 0; i < n; ++ i) {
+    a[i].exp = P->exp[i];
+    a[i].index = i;
+  }
+
+  for (bits = 0; bits < 64 && (L->guard >> bits); ++ bits) {}
+  for (shift = 0; shift < bits; shift += 8) {
+    for (d = 0; d < 257; ++ d) {
+      count[d] = 0;
+    }
+    for (i = 0; i < n; ++ i) {
+      count[((a[i].exp >> shift) & 0xff) + 1] ++;
+    }
+    // Skip the byte if all monomials agree on it
+    if (count[((a[0].exp >> shift) & 0xff) + 1] == n) {
+      continue;
+    }
+    for (d = 1; d < 257; ++ d) {
+      count[d] += count[d-1];
+    }
+    for (i = 0; i < n; ++ i) {
+      b[count[(a[i].exp >> shift) & 0xff] ++] = a[i];
+    }
+    packed_sort_entry_t* tmp = a; a = b; b = tmp;
+  }
+
+  // Permute the coefficients, the unused ones stay at the end
+  lp_integer_t* coeff = malloc(sizeof(lp_integer_t)*P->capacity);
+  for (i = 0; i < n; ++ i) {
+    P->exp[i] = a[i].exp;
+    coeff[i] = P->coeff[a[i].index];
+  }
+  for (i = n; i < P->capacity; ++ i) {
+    coeff[i] = P->coeff[i];
+  }
+  free(P->coeff);
+  P->coeff = coeff;
+
+  free(a);
+  free(b);
+
+  assert(packed_is_sorted(P));
+}
+
+STAT_DECLARE(int, coefficient, order_packed)
+
+int coefficient_order_packed(const lp_polynomial_context_t* ctx, coefficient_t* C) {
+
+  packed_layout_t L;
+  polynomial_packed_t P;
+  size_t terms;
+
+  if (C->type == COEFFICIENT_NUMERIC) {
+    return 0;
+  }
+
+  terms = coefficient_terms_count(C);
+  if (terms < PACKED_ORDER_THRESHOLD) {
+    return 0;
+  }
+
+  // The layout follows the current order
+  packed_layout_construct(&L);
+  if (!packed_layout_add(ctx, &L, C, 1) || !packed_layout_setup(ctx, &L)) {
+    return 0;
+  }
+
+  TRACE("coefficient", "coefficient_order_packed()\n");
+  STAT_INCR(coefficient, order_packed)
+
+  // Monomials come in the old order, sort them and rebuild bottom-up. The
+  // coefficients are moved out of C and then back, C is overwritten anyway.
+  polynomial_packed_construct(&P, terms);
+  packed_fill(ctx, &P, &L, C, 0, 1);
+  packed_sort(&P, &L);
+  packed_build(ctx, C, &L, &P, 0, P.size, 0, 1);
+  polynomial_packed_destruct(&P);
+
+  return 1;
+}
@@ -0,0 +1,151 @@
+/**
+ * Copyright 2015, SRI International.
+ *
+ * This file is part of LibPoly.
+ *
+ * LibPoly is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LibPoly is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with LibPoly.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "polynomial/coefficient.h"
+
+/** Packed exponent vector of a monomial */
+typedef uint64_t packed_exp_t;
+
+/** Maximal number of variables in a packed layout (each needs at least 2 bits) */
+#define PACKED_LAYOUT_MAX_VARS 32
+
+/**
+ * Layout of the packed exponent vectors. Each variable gets a field of bits in
+ * a 64-bit word, the top variable taking the most significant bits. Comparing
+ * the words therefore compares the monomials lexicographically, in the same
+ * order as the recursive representation. The top bit of each field is a guard
+ * bit that is always 0 in a valid exponent, so that adding exponents never
+ * carries into the next field and underflows in subtraction can be detected.
+ */
+typedef struct {
+  /** Number of variables */
+  size_t size;
+  /** The variables, top variable first */
+  lp_variable_t vars[PACKED_LAYOUT_MAX_VARS];
+  /** Degree bound of each variable */
+  unsigned long degrees[PACKED_LAYOUT_MAX_VARS];
+  /** Offset of the field of each variable */
+  unsigned offset[PACKED_LAYOUT_MAX_VARS];
+  /** Mask of each field (without the guard bit) */
+  packed_exp_t mask[PACKED_LAYOUT_MAX_VARS];
+  /** Mask of all the guard bits */
+  packed_exp_t guard;
+} packed_layout_t;
+
+/**
+ * Distributed polynomial with packed exponents: the monomials are kept in
+ * increasing order of the exponents, with non-zero coefficients.
+ */
+typedef struct {
+  /** Number of monomials */
+  size_t size;
+  /** Capacity of the arrays */
+  size_t capacity;
+  /** The exponents */
+  packed_exp_t* exp;
+  /** The coefficients */
+  lp_integer_t* coeff;
+} polynomial_packed_t;
+
+/** Construct an empty layout */
+void packed_layout_construct(packed_layout_t* L);
+
+/**
+ * Add the variables of C to the layout, and add n times the degrees of C to
+ * the degree bounds. Returns 0 if there are too many variables.
+ */
+int packed_layout_add(const lp_polynomial_context_t* ctx, packed_layout_t* L, const coefficient_t* C, unsigned n);
+
+/**
+ * Order the variables and compute the fields. Returns 0 if the degree bounds
+ * don't fit into a word.
+ */
+int packed_layout_setup(const lp_polynomial_context_t* ctx, packed_layout_t* L);
+
+/** Construct a zero polynomial with the given capacity */
+void polynomial_packed_construct(polynomial_packed_t* P, size_t capacity);
+
+/** Construct from a coefficient (the layout must cover C) */
+void polynomial_packed_construct_from_coefficient(const lp_polynomial_context_t* ctx, polynomial_packed_t* P, const packed_layout_t* L, const coefficient_t* C);
+
+/** Destruct the polynomial */
+void polynomial_packed_destruct(polynomial_packed_t* P);
+
+/** Swap two polynomials */
+void polynomial_packed_swap(polynomial_packed_t* P, polynomial_packed_t* Q);
+
+/** Make sure there is room for the given number of monomials */
+void polynomial_packed_ensure_capacity(polynomial_packed_t* P, size_t capacity);
+
+/** Convert back to the recursive representation: C = P */
+void polynomial_packed_to_coefficient(const lp_polynomial_context_t* ctx, coefficient_t* C, const packed_layout_t* L, const polynomial_packed_t* P);
+
+/** Compute S = A + B */
+void polynomial_packed_add(const lp_int_ring_t* K, polynomial_packed_t* S, const polynomial_packed_t* A, const polynomial_packed_t* B);
+
+/**
+ * Compute P = A * B with the heap-based (Johnson) multiplication. The layout
+ * must have room for the product degrees.
+ */
+void polynomial_packed_mul(const lp_int_ring_t* K, polynomial_packed_t* P, const polynomial_packed_t* A, const polynomial_packed_t* B);
+
+/**
+ * Compute Q = A / B with the heap-based (Monagan-Pearce) division, producing
+ * the quotient monomial by monomial. Returns 0 if B doesn't divide A, in which
+ * case Q is unchanged.
+ */
+int polynomial_packed_div_exact(const lp_int_ring_t* K, const packed_layout_t* L, polynomial_packed_t* Q, const polynomial_packed_t* A, const polynomial_packed_t* B);
+
+/** Compute P = A^n (the layout must have room for the product degrees) */
+void polynomial_packed_pow(const lp_int_ring_t* K, polynomial_packed_t* P, const polynomial_packed_t* A, unsigned n);
+
+/** Returns the number of monomials of the coefficient */
+size_t coefficient_terms_count(const coefficient_t* C);
+
+/**
+ * Compute P = C1*C2 using the packed representation. Returns 0 if the
+ * multiplication is not worth doing (or can not be done) this way, in which
+ * case P is unchanged.
+ */
+int coefficient_mul_packed(const lp_polynomial_context_t* ctx, coefficient_t* P, const coefficient_t* C1, const coefficient_t* C2);
+
+/**
+ * Compute P = C^n using the packed representation. Returns 0 if the
+ * power is not worth computing (or can not be computed) this way, in which
+ * case P is unchanged.
+ */
+int coefficient_pow_packed(const lp_polynomial_context_t* ctx, coefficient_t* P, const coefficient_t* C, unsigned n);
+
+/**
+ * Reorder C to the current variable order using the packed representation:
+ * the monomials are flattened, sorted in the new order and the recursive
+ * representation is rebuilt bottom-up. Returns 0 if the reordering is not
+ * worth doing (or can not be done) this way, in which case C is unchanged.
+ */
+int coefficient_order_packed(const lp_polynomial_context_t* ctx, coefficient_t* C);
+
+/**
+ * Compute D = C1/C2, assuming that C2 divides C1. Large sparse divisions are
+ * done with the heap-based division, the rest with coefficient_div().
+ */
+void coefficient_div_exact(const lp_polynomial_context_t* ctx, coefficient_t* D, const coefficient_t* C1, const coefficient_t* C2);
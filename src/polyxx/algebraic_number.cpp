@@ -222,10 +222,12 @@ namespace poly {
   }
 
   UPolynomial get_defining_polynomial(const AlgebraicNumber& an) {
+    lp_algebraic_number_force_const(an.get_internal());
     return UPolynomial(static_cast<const lp_upolynomial_t*>(an.get_internal()->f));
   }
 
   const DyadicInterval& get_isolating_interval(const AlgebraicNumber& an) {
+    lp_algebraic_number_force_const(an.get_internal());
     return *detail::cast_from(&an.get_internal()->I);
   }
   const DyadicRational& get_lower_bound(const AlgebraicNumber& an) {
@@ -32,6 +32,8 @@ namespace poly {
     lp_assignment_destruct(get_internal());
     lp_assignment_construct(get_internal(), var_db);
   }
+  void Assignment::push() { lp_assignment_push(get_internal()); }
+  void Assignment::pop() { lp_assignment_pop(get_internal()); }
 
   std::ostream& operator<<(std::ostream& os, const Assignment& a) {
     return stream_ptr(os, lp_assignment_to_string(a.get_internal()));
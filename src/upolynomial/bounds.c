@@ -40,40 +40,28 @@ void upolynomial_root_bound_cauchy(const lp_upolynomial_t* f, lp_integer_t* B) {
 
   assert(f->K == lp_Z);
 
-  lp_integer_t M_p; // Positive
-  lp_integer_t M_n; // Negative
-  integer_construct_from_int(lp_Z, &M_p, 0);
-  integer_construct_from_int(lp_Z, &M_n, 0);
+  // Max of |a_0|, ..., |a_{n-1}|
+  lp_integer_t M, a;
+  integer_construct_from_int(lp_Z, &M, 0);
+  integer_construct_from_int(lp_Z, &a, 0);
 
   int k;
   int d = f->size - 1;
   for (k = 0; k < d; ++ k) {
-    if (f->monomials[k].degree > 0) {
-      if (integer_cmp(lp_Z, &f->monomials[k].coefficient, &M_p) > 0) {
-        integer_assign(lp_Z, &M_p, &f->monomials[k].coefficient);
-        integer_neg(lp_Z, &M_n, &f->monomials[k].coefficient);
-      } else if (integer_cmp(lp_Z, &f->monomials[k].coefficient, &M_n) < 0) {
-        integer_assign(lp_Z, &M_n, &f->monomials[k].coefficient);
-        integer_neg(lp_Z, &M_p, &f->monomials[k].coefficient);
-      }
+    integer_abs(lp_Z, &a, &f->monomials[k].coefficient);
+    if (integer_cmp(lp_Z, &a, &M) > 0) {
+      integer_swap(&a, &M);
     }
   }
 
-  integer_construct_from_int(lp_Z, B, 0);
-  if (integer_sgn(lp_Z, &f->monomials[d].coefficient) > 0) {
-    integer_div_Z(B, &M_p, &f->monomials[d].coefficient);
-  } else {
-    lp_integer_t neg;
-    integer_construct_from_int(lp_Z, &neg, 0);
-    integer_neg(lp_Z, &neg, &f->monomials[d].coefficient);
-    integer_div_Z(B, &M_p, &f->monomials[d].coefficient);
-    integer_destruct(&neg);
-  }
-
+  // Rounded down, so we add 2 to keep the bound strict
+  integer_abs(lp_Z, &a, &f->monomials[d].coefficient);
+  integer_div_Z(B, &M, &a);
+  integer_inc(lp_Z, B);
   integer_inc(lp_Z, B);
 
-  integer_destruct(&M_p);
-  integer_destruct(&M_n);
+  integer_destruct(&M);
+  integer_destruct(&a);
 }
 
 /**
@@ -31,7 +31,9 @@
  *
  * the bound is
  *
- *  B = 1 + max(a_0, ..., a_{n-1})/|a_n|
+ *  B = 2 + floor(max(|a_0|, ..., |a_{n-1}|)/|a_n|)
+ *
+ * so that all roots z of f satisfy |z| < B. B should be constructed.
  */
 void upolynomial_root_bound_cauchy(const lp_upolynomial_t* f, lp_integer_t* B);
 
@@ -0,0 +1,234 @@
+/**
+ * Copyright 2015, SRI International.
+ *
+ * This file is part of LibPoly.
+ *
+ * LibPoly is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LibPoly is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with LibPoly.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <upolynomial.h>
+
+#include "upolynomial/composed.h"
+
+#include "number/integer.h"
+#include "number/rational.h"
+
+#include "utils/debug_trace.h"
+#include "utils/statistics.h"
+
+#include <assert.h>
+
+STAT_DECLARE(int, upolynomial, composed_sum)
+STAT_DECLARE(int, upolynomial, composed_product)
+
+/**
+ * Compute the power sums p_0, ..., p_n of the roots of f into p. With f monic
+ * f = x^m + a_1 x^{m-1} + ... + a_m, Newton's identities give
+ *
+ *   p_k = -k*a_k - sum_{i=1}^{min(k-1, m)} a_i p_{k-i}
+ *
+ * where a_k = 0 for k > m.
+ */
+static
+void upolynomial_power_sums(const lp_upolynomial_t* f, lp_rational_t* p, size_t n) {
+
+  size_t m = lp_upolynomial_degree(f);
+  assert(m > 0);
+
+  // Coefficients of monic f: a[i] = f_{m-i}/f_m
+  size_t i, k;
+  lp_integer_t* f_coeff = malloc(sizeof(lp_integer_t)*(m + 1));
+  for (i = 0; i <= m; ++ i) {
+    integer_construct(f_coeff + i);
+  }
+  lp_upolynomial_unpack(f, f_coeff);
+  lp_rational_t* a = malloc(sizeof(lp_rational_t)*(m + 1));
+  for (i = 0; i <= m; ++ i) {
+    rational_construct_from_div(a + i, f_coeff + m - i, f_coeff + m);
+  }
+
+  lp_rational_t tmp;
+  rational_construct(&tmp);
+
+  rational_assign_int(p, m, 1);
+  for (k = 1; k <= n; ++ k) {
+    if (k <= m) {
+      rational_assign_int(&tmp, -k, 1);
+      rational_mul(p + k, &tmp, a + k);
+    } else {
+      rational_assign_int(p + k, 0, 1);
+    }
+    for (i = 1; i < k && i <= m; ++ i) {
+      rational_mul(&tmp, a + i, p + k - i);
+      rational_sub(p + k, p + k, &tmp);
+    }
+  }
+
+  rational_destruct(&tmp);
+  for (i = 0; i <= m; ++ i) {
+    rational_destruct(a + i);
+    integer_destruct(f_coeff + i);
+  }
+  free(a);
+  free(f_coeff);
+}
+
+/**
+ * Construct the polynomial of degree n from the power sums s_1, ..., s_n of
+ * its roots. The monic polynomial x^n + b_1 x^{n-1} + ... + b_n has
+ *
+ *   b_k = -(s_k + sum_{i=1}^{k-1} b_i s_{k-i})/k
+ *
+ * and we return its primitive integer multiple.
+ */
+static
+lp_upolynomial_t* upolynomial_from_power_sums(const lp_rational_t* s, size_t n) {
+
+  size_t i, k;
+
+  // b[k] is the coefficient of x^{n-k}
+  lp_rational_t* b = malloc(sizeof(lp_rational_t)*(n + 1));
+  lp_rational_t tmp;
+  rational_construct(&tmp);
+  rational_construct_from_int(b, 1, 1);
+  for (k = 1; k <= n; ++ k) {
+    rational_construct_copy(b + k, s + k);
+    for (i = 1; i < k; ++ i) {
+      rational_mul(&tmp, b + i, s + k - i);
+      rational_add(b + k, b + k, &tmp);
+    }
+    rational_assign_int(&tmp, -1, k);
+    rational_mul(b + k, b + k, &tmp);
+  }
+
+  // Clear the denominators
+  lp_integer_t lcm;
+  integer_construct_from_int(lp_Z, &lcm, 1);
+  for (k = 1; k <= n; ++ k) {
+    integer_lcm_Z(&lcm, &lcm, rational_get_den_ref(b + k));
+  }
+  lp_integer_t* coeff = malloc(sizeof(lp_integer_t)*(n + 1));
+  for (k = 0; k <= n; ++ k) {
+    integer_construct(coeff + n - k);
+    integer_div_exact(lp_Z, coeff + n - k, &lcm, rational_get_den_ref(b + k));
+    integer_mul(lp_Z, coeff + n - k, coeff + n - k, rational_get_num_ref(b + k));
+  }
+
+  lp_upolynomial_t* result_int = lp_upolynomial_construct(lp_Z, n, coeff);
+  lp_upolynomial_t* result = lp_upolynomial_primitive_part_Z(result_int);
+
+  lp_upolynomial_delete(result_int);
+  for (k = 0; k <= n; ++ k) {
+    integer_destruct(coeff + k);
+    rational_destruct(b + k);
+  }
+  free(coeff);
+  free(b);
+  integer_destruct(&lcm);
+  rational_destruct(&tmp);
+
+  return result;
+}
+
+lp_upolynomial_t* upolynomial_composed_sum(const lp_upolynomial_t* f, const lp_upolynomial_t* g) {
+
+  STAT_INCR(upolynomial, composed_sum)
+
+  assert(f->K == lp_Z && g->K == lp_Z);
+
+  size_t n = lp_upolynomial_degree(f)*lp_upolynomial_degree(g);
+  size_t i, k, l;
+
+  lp_rational_t* p_f = malloc(sizeof(lp_rational_t)*(n + 1));
+  lp_rational_t* p_g = malloc(sizeof(lp_rational_t)*(n + 1));
+  lp_rational_t* s = malloc(sizeof(lp_rational_t)*(n + 1));
+  for (i = 0; i <= n; ++ i) {
+    rational_construct(p_f + i);
+    rational_construct(p_g + i);
+    rational_construct(s + i);
+  }
+  upolynomial_power_sums(f, p_f, n);
+  upolynomial_power_sums(g, p_g, n);
+
+  // s_k = sum_l C(k, l) p_l(f) p_{k-l}(g), we keep row k of the binomials
+  lp_rational_t* binomial = malloc(sizeof(lp_rational_t)*(n + 1));
+  for (i = 0; i <= n; ++ i) {
+    rational_construct_from_int(binomial + i, i == 0, 1);
+  }
+
+  lp_rational_t tmp;
+  rational_construct(&tmp);
+  for (k = 1; k <= n; ++ k) {
+    // Next row of the Pascal triangle
+    for (l = k; l > 0; -- l) {
+      rational_add(binomial + l, binomial + l, binomial + l - 1);
+    }
+    for (l = 0; l <= k; ++ l) {
+      rational_mul(&tmp, p_f + l, p_g + k - l);
+      rational_mul(&tmp, &tmp, binomial + l);
+      rational_add(s + k, s + k, &tmp);
+    }
+  }
+
+  lp_upolynomial_t* result = upolynomial_from_power_sums(s, n);
+
+  rational_destruct(&tmp);
+  for (i = 0; i <= n; ++ i) {
+    rational_destruct(p_f + i);
+    rational_destruct(p_g + i);
+    rational_destruct(s + i);
+    rational_destruct(binomial + i);
+  }
+  free(p_f);
+  free(p_g);
+  free(s);
+  free(binomial);
+
+  return result;
+}
+
+lp_upolynomial_t* upolynomial_composed_product(const lp_upolynomial_t* f, const lp_upolynomial_t* g) {
+
+  STAT_INCR(upolynomial, composed_product)
+
+  assert(f->K == lp_Z && g->K == lp_Z);
+
+  size_t n = lp_upolynomial_degree(f)*lp_upolynomial_degree(g);
+  size_t i;
+
+  lp_rational_t* p_f = malloc(sizeof(lp_rational_t)*(n + 1));
+  lp_rational_t* p_g = malloc(sizeof(lp_rational_t)*(n + 1));
+  for (i = 0; i <= n; ++ i) {
+    rational_construct(p_f + i);
+    rational_construct(p_g + i);
+  }
+  upolynomial_power_sums(f, p_f, n);
+  upolynomial_power_sums(g, p_g, n);
+
+  // s_k = p_k(f) p_k(g)
+  for (i = 0; i <= n; ++ i) {
+    rational_mul(p_f + i, p_f + i, p_g + i);
+  }
+
+  lp_upolynomial_t* result = upolynomial_from_power_sums(p_f, n);
+
+  for (i = 0; i <= n; ++ i) {
+    rational_destruct(p_f + i);
+    rational_destruct(p_g + i);
+  }
+  free(p_f);
+  free(p_g);
+
+  return result;
+}
@@ -0,0 +1,44 @@
+/**
+ * Copyright 2015, SRI International.
+ *
+ * This file is part of LibPoly.
+ *
+ * LibPoly is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LibPoly is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with LibPoly.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "upolynomial/upolynomial.h"
+
+/**
+ * Composed sum of f and g: the polynomial whose roots are a + b, for all
+ * roots a of f and b of g (with multiplicities). The result is primitive,
+ * with positive leading coefficient, and of degree deg(f)*deg(g).
+ *
+ * The polynomial is computed from the power sums of the roots
+ *
+ *   s_k = sum_{a, b} (a + b)^k = sum_l C(k, l) p_l(f) p_{k-l}(g)
+ *
+ * where p_l(f) are the power sums of the roots of f, obtained (and turned
+ * back into coefficients) with Newton's identities.
+ */
+lp_upolynomial_t* upolynomial_composed_sum(const lp_upolynomial_t* f, const lp_upolynomial_t* g);
+
+/**
+ * Composed product of f and g: the polynomial whose roots are a*b, for all
+ * roots a of f and b of g (with multiplicities). The result is primitive,
+ * with positive leading coefficient, and of degree deg(f)*deg(g). Here the
+ * power sums are simply s_k = p_k(f) p_k(g).
+ */
+lp_upolynomial_t* upolynomial_composed_product(const lp_upolynomial_t* f, const lp_upolynomial_t* g);
@@ -1398,6 +1398,8 @@ void factorization_recombination(const lp_upolynomial_t* f, const lp_upolynomial
           for (i = 0; i < sel_size; ++ i) {
             enabled[sel[i]] = 0;
           }
+        } else {
+          lp_upolynomial_delete(candidate);
         }
       }
     }
@@ -1580,6 +1582,7 @@ lp_upolynomial_factors_t* upolynomial_factor_Z(const lp_upolynomial_t* f) {
 
   // Get a square-free decomposition of f
   lp_upolynomial_factors_t* sq_free_factors = lp_upolynomial_factor_square_free_primitive(f_pp);
+  lp_upolynomial_delete(f_pp);
   assert(integer_cmp_int(lp_Z, &sq_free_factors->constant, 1) == 0);
 
   // Factor individuals
@@ -26,6 +26,7 @@
 #include "utils/statistics.h"
 
 #include <assert.h>
+#include <stdlib.h>
 
 STAT_DECLARE(int, upolynomial, gcd_euclid)
 STAT_DECLARE(int, upolynomial, gcd_euclid_extended)
@@ -211,6 +212,322 @@ lp_upolynomial_t* upolynomial_gcd_euclid(const lp_upolynomial_t* A, const lp_upo
   return D;
 }
 
+STAT_DECLARE(int, upolynomial, gcd_hgcd)
+
+/** Below this degree the half-GCD matrix is computed with Euclid steps */
+#define HGCD_BASE_DEGREE 32
+
+/** Degree of p, -1 for the zero polynomial */
+static inline
+int hgcd_deg(const upolynomial_dense_t* p) {
+  return upolynomial_dense_is_zero(p) ? -1 : (int) p->size - 1;
+}
+
+/** Remove the leading zeros */
+static inline
+void hgcd_normalize(upolynomial_dense_t* p) {
+  while (p->size > 1 && integer_sgn(lp_Z, p->coefficients + p->size - 1) == 0) {
+    p->size --;
+  }
+}
+
+/** Make sure p can hold the given number of coefficients */
+static
+void hgcd_reserve(upolynomial_dense_t* p, size_t capacity) {
+  if (p->capacity < capacity) {
+    p->coefficients = realloc(p->coefficients, capacity*sizeof(lp_integer_t));
+    size_t i;
+    for (i = p->capacity; i < capacity; ++ i) {
+      integer_construct_from_int(lp_Z, p->coefficients + i, 0);
+    }
+    p->capacity = capacity;
+  }
+}
+
+/** Construct p = q */
+static
+void hgcd_construct_copy(upolynomial_dense_t* p, const upolynomial_dense_t* q) {
+  upolynomial_dense_construct(p, q->size);
+  upolynomial_dense_assign(p, q);
+}
+
+/** Construct p = q div x^k */
+static
+void hgcd_construct_shift(upolynomial_dense_t* p, const upolynomial_dense_t* q, size_t k) {
+  size_t size = q->size > k ? q->size - k : 1;
+  upolynomial_dense_construct(p, size);
+  if (q->size > k) {
+    size_t i;
+    for (i = 0; i < size; ++ i) {
+      integer_assign(lp_Z, p->coefficients + i, q->coefficients + k + i);
+    }
+    p->size = size;
+  }
+}
+
+/** Construct p = a*b */
+static
+void hgcd_construct_mul(const lp_int_ring_t* K, upolynomial_dense_t* p, const upolynomial_dense_t* a, const upolynomial_dense_t* b) {
+  upolynomial_dense_construct(p, a->size + b->size - 1);
+  if (!upolynomial_dense_is_zero(a) && !upolynomial_dense_is_zero(b)) {
+    upolynomial_dense_mul_add_array(p->coefficients, a->coefficients, a->size, b->coefficients, b->size);
+    p->size = a->size + b->size - 1;
+    size_t i;
+    for (i = 0; i < p->size; ++ i) {
+      integer_ring_normalize(K, p->coefficients + i);
+    }
+    hgcd_normalize(p);
+  }
+}
+
+/** p += q (or p -= q if negative) */
+static
+void hgcd_add(const lp_int_ring_t* K, upolynomial_dense_t* p, const upolynomial_dense_t* q, int negative) {
+  hgcd_reserve(p, q->size);
+  size_t i;
+  for (i = 0; i < q->size; ++ i) {
+    if (negative) {
+      integer_sub(K, p->coefficients + i, p->coefficients + i, q->coefficients + i);
+    } else {
+      integer_add(K, p->coefficients + i, p->coefficients + i, q->coefficients + i);
+    }
+  }
+  if (q->size > p->size) {
+    p->size = q->size;
+  }
+  hgcd_normalize(p);
+}
+
+/**
+ * One step of Euclid's algorithm: a = q*b + r, then (a, b) = (b, r). If q is
+ * not 0, it is constructed to the quotient.
+ */
+static
+void hgcd_euclid_step(const lp_int_ring_t* K, upolynomial_dense_t* a, upolynomial_dense_t* b, upolynomial_dense_t* q) {
+  upolynomial_dense_t div, rem;
+  upolynomial_dense_construct(&div, a->size);
+  upolynomial_dense_construct(&rem, a->size);
+  upolynomial_dense_div_general(K, 1 /* exact */, a, b, &div, &rem);
+  upolynomial_dense_swap(a, b);
+  upolynomial_dense_swap(b, &rem);
+  if (q) {
+    *q = div;
+  } else {
+    upolynomial_dense_destruct(&div);
+  }
+  upolynomial_dense_destruct(&rem);
+}
+
+/** 2x2 matrix of polynomials */
+typedef struct {
+  upolynomial_dense_t m[2][2];
+} hgcd_matrix_t;
+
+static
+void hgcd_matrix_construct_identity(hgcd_matrix_t* M) {
+  size_t i, j;
+  for (i = 0; i < 2; ++ i) {
+    for (j = 0; j < 2; ++ j) {
+      upolynomial_dense_construct(&M->m[i][j], 1);
+    }
+    integer_assign_int(lp_Z, M->m[i][i].coefficients, 1);
+  }
+}
+
+static
+void hgcd_matrix_destruct(hgcd_matrix_t* M) {
+  size_t i, j;
+  for (i = 0; i < 2; ++ i) {
+    for (j = 0; j < 2; ++ j) {
+      upolynomial_dense_destruct(&M->m[i][j]);
+    }
+  }
+}
+
+static
+void hgcd_matrix_swap(hgcd_matrix_t* M, hgcd_matrix_t* N) {
+  hgcd_matrix_t tmp = *M;
+  *M = *N;
+  *N = tmp;
+}
+
+/** Compute (a, b) = M*(a, b) */
+static
+void hgcd_matrix_apply(const lp_int_ring_t* K, const hgcd_matrix_t* M, upolynomial_dense_t* a, upolynomial_dense_t* b) {
+  upolynomial_dense_t new_ab[2], tmp;
+  size_t i;
+  for (i = 0; i < 2; ++ i) {
+    hgcd_construct_mul(K, &new_ab[i], &M->m[i][0], a);
+    hgcd_construct_mul(K, &tmp, &M->m[i][1], b);
+    hgcd_add(K, &new_ab[i], &tmp, 0);
+    upolynomial_dense_destruct(&tmp);
+  }
+  upolynomial_dense_swap(a, &new_ab[0]);
+  upolynomial_dense_swap(b, &new_ab[1]);
+  upolynomial_dense_destruct(&new_ab[0]);
+  upolynomial_dense_destruct(&new_ab[1]);
+}
+
+/** Compute M = [0, 1; 1, -q]*M, i.e. the Euclid step a = q*b + r */
+static
+void hgcd_matrix_mul_quotient(const lp_int_ring_t* K, hgcd_matrix_t* M, const upolynomial_dense_t* q) {
+  upolynomial_dense_t tmp;
+  size_t j;
+  for (j = 0; j < 2; ++ j) {
+    hgcd_construct_mul(K, &tmp, q, &M->m[1][j]);
+    hgcd_add(K, &M->m[0][j], &tmp, 1);
+    upolynomial_dense_swap(&M->m[0][j], &M->m[1][j]);
+    upolynomial_dense_destruct(&tmp);
+  }
+}
+
+/** Compute M = S*M */
+static
+void hgcd_matrix_mul(const lp_int_ring_t* K, const hgcd_matrix_t* S, hgcd_matrix_t* M) {
+  hgcd_matrix_t P;
+  upolynomial_dense_t tmp;
+  size_t i, j;
+  for (i = 0; i < 2; ++ i) {
+    for (j = 0; j < 2; ++ j) {
+      hgcd_construct_mul(K, &P.m[i][j], &S->m[i][0], &M->m[0][j]);
+      hgcd_construct_mul(K, &tmp, &S->m[i][1], &M->m[1][j]);
+      hgcd_add(K, &P.m[i][j], &tmp, 0);
+      upolynomial_dense_destruct(&tmp);
+    }
+  }
+  hgcd_matrix_swap(M, &P);
+  hgcd_matrix_destruct(&P);
+}
+
+/**
+ * Half-GCD: given deg(a) = n > deg(b), construct the matrix M of the Euclid
+ * steps, such that for (c, d) = M*(a, b) we have deg(c) >= m > deg(d), with
+ * m = ceil(n/2). The steps only depend on the top coefficients of a and b, so
+ * we recurse on the top halves (Thull-Yap formulation).
+ */
+static
+void hgcd(const lp_int_ring_t* K, const upolynomial_dense_t* a, const upolynomial_dense_t* b, hgcd_matrix_t* M) {
+
+  int n = hgcd_deg(a);
+  int m = (n + 1) / 2;
+  assert(n > hgcd_deg(b));
+
+  if (hgcd_deg(b) < m) {
+    hgcd_matrix_construct_identity(M);
+    return;
+  }
+
+  upolynomial_dense_t q;
+
+  if (n < HGCD_BASE_DEGREE) {
+    // Small, just do the Euclid steps
+    hgcd_matrix_construct_identity(M);
+    upolynomial_dense_t c, d;
+    hgcd_construct_copy(&c, a);
+    hgcd_construct_copy(&d, b);
+    while (hgcd_deg(&d) >= m) {
+      hgcd_euclid_step(K, &c, &d, &q);
+      hgcd_matrix_mul_quotient(K, M, &q);
+      upolynomial_dense_destruct(&q);
+    }
+    upolynomial_dense_destruct(&c);
+    upolynomial_dense_destruct(&d);
+    return;
+  }
+
+  // Steps of the top halves
+  upolynomial_dense_t a0, b0;
+  hgcd_construct_shift(&a0, a, m);
+  hgcd_construct_shift(&b0, b, m);
+  hgcd(K, &a0, &b0, M);
+  upolynomial_dense_destruct(&a0);
+  upolynomial_dense_destruct(&b0);
+
+  // Apply to get the remainders (c, d)
+  upolynomial_dense_t c, d;
+  hgcd_construct_copy(&c, a);
+  hgcd_construct_copy(&d, b);
+  hgcd_matrix_apply(K, M, &c, &d);
+  assert(hgcd_deg(&c) > hgcd_deg(&d));
+
+  if (hgcd_deg(&d) >= m) {
+    // One step (c, d) = (d, c mod d)
+    hgcd_euclid_step(K, &c, &d, &q);
+    hgcd_matrix_mul_quotient(K, M, &q);
+    upolynomial_dense_destruct(&q);
+    // Steps of the top halves again
+    size_t k = 2*m - hgcd_deg(&c);
+    upolynomial_dense_t c0, d0;
+    hgcd_construct_shift(&c0, &c, k);
+    hgcd_construct_shift(&d0, &d, k);
+    hgcd_matrix_t S;
+    hgcd(K, &c0, &d0, &S);
+    hgcd_matrix_mul(K, &S, M);
+    hgcd_matrix_destruct(&S);
+    upolynomial_dense_destruct(&c0);
+    upolynomial_dense_destruct(&d0);
+  }
+
+  upolynomial_dense_destruct(&c);
+  upolynomial_dense_destruct(&d);
+}
+
+lp_upolynomial_t* upolynomial_gcd_hgcd(const lp_upolynomial_t* A, const lp_upolynomial_t* B) {
+
+  if (trace_is_enabled("gcd")) {
+    tracef("upolynomial_gcd_hgcd("); lp_upolynomial_print(A, trace_out); tracef(", "); lp_upolynomial_print(B, trace_out); tracef(")\n");
+  }
+
+  STAT_INCR(upolynomial, gcd_hgcd);
+
+  assert(!lp_upolynomial_is_zero(B));
+  assert(lp_upolynomial_degree(A) >= lp_upolynomial_degree(B));
+
+  // The ring of computation
+  assert(A->K == B->K);
+  const lp_int_ring_t* K = A->K;
+  assert(K && K->is_prime);
+
+  size_t deg_A = lp_upolynomial_degree(A);
+  upolynomial_dense_t a, b;
+  upolynomial_dense_construct_p(&a, deg_A + 1, A);
+  upolynomial_dense_construct_p(&b, deg_A + 1, B);
+
+  while (!upolynomial_dense_is_zero(&b)) {
+    // Jump over half of the remainders with the half-gcd
+    if (hgcd_deg(&a) > hgcd_deg(&b) && hgcd_deg(&b) >= HGCD_BASE_DEGREE) {
+      hgcd_matrix_t M;
+      hgcd(K, &a, &b, &M);
+      hgcd_matrix_apply(K, &M, &a, &b);
+      hgcd_matrix_destruct(&M);
+      if (upolynomial_dense_is_zero(&b)) {
+        break;
+      }
+    }
+    // One regular step (guarantees progress)
+    hgcd_euclid_step(K, &a, &b, 0);
+  }
+
+  // We're in a field, make it monic
+  lp_integer_t lc;
+  integer_construct_copy(K, &lc, upolynomial_dense_lead_coeff(&a));
+  if (integer_cmp_int(lp_Z, &lc, 1)) {
+    upolynomial_dense_div_c(&a, K, &lc);
+  }
+  integer_destruct(&lc);
+
+  lp_upolynomial_t* D = upolynomial_dense_to_upolynomial(&a, K);
+
+  upolynomial_dense_destruct(&a);
+  upolynomial_dense_destruct(&b);
+
+  if (trace_is_enabled("gcd")) {
+    tracef("upolynomial_gcd_hgcd("); lp_upolynomial_print(A, trace_out); tracef(", "); lp_upolynomial_print(B, trace_out); tracef(") = "); lp_upolynomial_print(D, trace_out); tracef("\n");
+  }
+
+  return D;
+}
+
 lp_upolynomial_t* upolynomial_gcd_subresultant(const lp_upolynomial_t* A, const lp_upolynomial_t* B) {
 
   if (trace_is_enabled("gcd")) {
@@ -559,3 +876,187 @@ lp_upolynomial_t* upolynomial_gcd_heuristic(const lp_upolynomial_t* A, const lp_
 
   return D;
 }
+
+STAT_DECLARE(int, upolynomial, gcd_modular)
+STAT_DECLARE(int, upolynomial, gcd_modular_primes)
+STAT_DECLARE(int, upolynomial, gcd_modular_unlucky)
+STAT_DECLARE(int, upolynomial, gcd_modular_checks)
+
+/** The modular gcd starts with the first prime after 2^30 */
+#define GCD_MODULAR_FIRST_PRIME_BITS 30
+
+/**
+ * Modular GCD (Brown, Collins). With A, B primitive and g = gcd(lc(A), lc(B)),
+ * for each prime p not dividing g we compute the monic G_p = gcd(A_p, B_p) in
+ * Z_p. The degree of G_p is at least the degree of D = gcd(A, B), and is
+ * equal for all but finitely many (unlucky) primes. We therefore only keep
+ * the images of the smallest degree seen, and combine g*G_p using the Chinese
+ * remainder theorem into g/lc(D)*D. Once the combination doesn't change with
+ * a new prime, we check the primitive part by trial division.
+ */
+lp_upolynomial_t* upolynomial_gcd_modular(const lp_upolynomial_t* A, const lp_upolynomial_t* B) {
+
+  if (trace_is_enabled("gcd")) {
+    tracef("upolynomial_gcd_modular("); lp_upolynomial_print(A, trace_out); tracef(", "); lp_upolynomial_print(B, trace_out); tracef(")\n");
+  }
+
+  STAT_INCR(upolynomial, gcd_modular)
+
+  assert(A->K == lp_Z && B->K == lp_Z);
+  assert(!lp_upolynomial_is_zero(A) && !lp_upolynomial_is_zero(B));
+
+  lp_upolynomial_t* D = 0;
+
+  // d = gcd(content(A), content(B))
+  lp_integer_t A_cont, B_cont, d;
+  integer_construct_from_int(lp_Z, &A_cont, 0);
+  integer_construct_from_int(lp_Z, &B_cont, 0);
+  integer_construct_from_int(lp_Z, &d, 0);
+  lp_upolynomial_content_Z(A, &A_cont);
+  lp_upolynomial_content_Z(B, &B_cont);
+  integer_gcd_Z(&d, &A_cont, &B_cont);
+
+  // Work with primitive parts
+  lp_upolynomial_t* A_pp = lp_upolynomial_primitive_part_Z(A);
+  lp_upolynomial_t* B_pp = lp_upolynomial_primitive_part_Z(B);
+
+  // g = gcd(lc(A), lc(B))
+  lp_integer_t g;
+  integer_construct_from_int(lp_Z, &g, 0);
+  integer_gcd_Z(&g, lp_upolynomial_lead_coeff(A_pp), lp_upolynomial_lead_coeff(B_pp));
+
+  // The combined image H mod M of degree H_deg (-1 if none yet)
+  size_t max_size = lp_upolynomial_degree(B_pp) + 1;
+  if (lp_upolynomial_degree(A_pp) + 1 < max_size) {
+    max_size = lp_upolynomial_degree(A_pp) + 1;
+  }
+  int H_deg = -1;
+  lp_integer_t* H = malloc(sizeof(lp_integer_t)*max_size);
+  lp_integer_t* G = malloc(sizeof(lp_integer_t)*max_size);
+  size_t i;
+  for (i = 0; i < max_size; ++ i) {
+    integer_construct_from_int(lp_Z, H + i, 0);
+    integer_construct_from_int(lp_Z, G + i, 0);
+  }
+
+  lp_integer_t M, prime, tmp, M_inv;
+  integer_construct_from_int(lp_Z, &M, 1);
+  integer_construct_from_int(lp_Z, &prime, 1);
+  integer_construct_from_int(lp_Z, &tmp, 0);
+  integer_construct_from_int(lp_Z, &M_inv, 0);
+  mpz_mul_2exp(&prime, &prime, GCD_MODULAR_FIRST_PRIME_BITS);
+
+  while (D == 0) {
+
+    // Next prime that doesn't divide g
+    do {
+      mpz_nextprime(&prime, &prime);
+    } while (integer_divides(lp_Z, &prime, &g));
+
+    STAT_INCR(upolynomial, gcd_modular_primes)
+
+    // G_p = g*gcd(A_p, B_p) in Z_p
+    lp_int_ring_t* K = lp_int_ring_create(&prime, 1);
+    lp_upolynomial_t* A_p = lp_upolynomial_construct_copy_K(K, A_pp);
+    lp_upolynomial_t* B_p = lp_upolynomial_construct_copy_K(K, B_pp);
+    lp_upolynomial_t* G_p = lp_upolynomial_gcd(A_p, B_p);
+    int G_p_deg = lp_upolynomial_degree(G_p);
+
+    if (trace_is_enabled("gcd")) {
+      tracef("p = "); integer_print(&prime, trace_out);
+      tracef(", G_p = "); lp_upolynomial_print(G_p, trace_out); tracef("\n");
+    }
+
+    if (G_p_deg == 0) {
+      // Coprime
+      D = lp_upolynomial_construct(lp_Z, 0, &d);
+    } else if (H_deg >= 0 && G_p_deg > H_deg) {
+      // Unlucky prime
+      STAT_INCR(upolynomial, gcd_modular_unlucky)
+    } else {
+      // Get the image (and restart if all previous primes were unlucky)
+      for (i = 0; i < max_size; ++ i) {
+        integer_assign_int(lp_Z, G + i, 0);
+      }
+      lp_upolynomial_unpack(G_p, G);
+      integer_assign(K, &tmp, &g);
+      for (i = 0; i <= (size_t) G_p_deg; ++ i) {
+        integer_mul(K, G + i, G + i, &tmp);
+      }
+      int changed;
+      if (G_p_deg < H_deg || H_deg < 0) {
+        if (H_deg >= 0) {
+          STAT_INCR(upolynomial, gcd_modular_unlucky)
+        }
+        for (i = 0; i < max_size; ++ i) {
+          integer_assign(lp_Z, H + i, G + i);
+        }
+        integer_assign(lp_Z, &M, &prime);
+        H_deg = G_p_deg;
+        changed = 1;
+      } else {
+        // H' = H + M*((G - H)/M mod p), normalized to the symmetric range of M*p
+        integer_assign(K, &M_inv, &M);
+        integer_inv(K, &M_inv, &M_inv);
+        lp_integer_t M_new;
+        integer_construct_from_int(lp_Z, &M_new, 0);
+        integer_mul(lp_Z, &M_new, &M, &prime);
+        lp_int_ring_t* K_M = lp_int_ring_create(&M_new, 0);
+        changed = 0;
+        for (i = 0; i <= (size_t) H_deg; ++ i) {
+          integer_assign(K, &tmp, H + i);
+          integer_sub(K, &tmp, G + i, &tmp);
+          if (integer_sgn(lp_Z, &tmp)) {
+            changed = 1;
+            integer_mul(K, &tmp, &tmp, &M_inv);
+            integer_add_mul(lp_Z, H + i, &M, &tmp);
+            integer_ring_normalize(K_M, H + i);
+          }
+        }
+        integer_swap(&M, &M_new);
+        lp_int_ring_detach(K_M);
+        integer_destruct(&M_new);
+      }
+
+      // If stable, check the candidate
+      if (!changed) {
+        STAT_INCR(upolynomial, gcd_modular_checks)
+        lp_upolynomial_t* H_poly = lp_upolynomial_construct(lp_Z, H_deg, H);
+        lp_upolynomial_t* H_pp = lp_upolynomial_primitive_part_Z(H_poly);
+        if (lp_upolynomial_divides(H_pp, B_pp) && lp_upolynomial_divides(H_pp, A_pp)) {
+          D = lp_upolynomial_mul_c(H_pp, &d);
+        }
+        lp_upolynomial_delete(H_pp);
+        lp_upolynomial_delete(H_poly);
+      }
+    }
+
+    lp_upolynomial_delete(A_p);
+    lp_upolynomial_delete(B_p);
+    lp_upolynomial_delete(G_p);
+    lp_int_ring_detach(K);
+  }
+
+  for (i = 0; i < max_size; ++ i) {
+    integer_destruct(H + i);
+    integer_destruct(G + i);
+  }
+  free(H);
+  free(G);
+  integer_destruct(&M);
+  integer_destruct(&M_inv);
+  integer_destruct(&prime);
+  integer_destruct(&tmp);
+  integer_destruct(&g);
+  integer_destruct(&d);
+  integer_destruct(&A_cont);
+  integer_destruct(&B_cont);
+  lp_upolynomial_delete(A_pp);
+  lp_upolynomial_delete(B_pp);
+
+  if (trace_is_enabled("gcd")) {
+    tracef("upolynomial_gcd_modular("); lp_upolynomial_print(A, trace_out); tracef(", "); lp_upolynomial_print(B, trace_out); tracef(") = "); lp_upolynomial_print(D, trace_out); tracef("\n");
+  }
+
+  return D;
+}
@@ -33,12 +33,34 @@
  */
 lp_upolynomial_t* upolynomial_gcd_euclid(const lp_upolynomial_t* A, const lp_upolynomial_t* B, lp_upolynomial_t** U, lp_upolynomial_t** V);
 
+/**
+ * Minimal degree of B for which the half-GCD is used instead of Euclid. The
+ * half-GCD is faster from degree around 400 (small or word-size primes).
+ */
+#define UPOLYNOMIAL_GCD_HGCD_MIN_DEGREE 448
+
+/**
+ * Compute the GCD using the half-GCD algorithm (Knuth-Schoenhage). Degree of
+ * A should be >= than the degree of B. This one only works in Z_p rings, and
+ * the result is monic (same as Euclid's algorithm). The half-GCD jumps over
+ * the quotient sequence using products of polynomial matrices (fast
+ * multiplication), so it only pays off for large degrees.
+ */
+lp_upolynomial_t* upolynomial_gcd_hgcd(const lp_upolynomial_t* A, const lp_upolynomial_t* B);
+
 /**
  * Compute the GCD using the Subresultant algorithm. Degree of A should be >= than the
  * degree of B.
  */
 lp_upolynomial_t* upolynomial_gcd_subresultant(const lp_upolynomial_t* A, const lp_upolynomial_t* B);
 
+/**
+ * Maximal degree of B for which the subresultant GCD is used over Z instead
+ * of the heuristic (and modular) GCD. Only the first few remainders are cheap
+ * enough to beat the evaluation and reconstruction.
+ */
+#define UPOLYNOMIAL_GCD_SUBRESULTANT_MAX_DEGREE 3
+
 
 /**
  * Heuristic GCD computation. Pick a large value v, evaluate A(v), B(v), and
@@ -48,3 +70,12 @@ lp_upolynomial_t* upolynomial_gcd_subresultant(const lp_upolynomial_t* A, const
  * @param tries how many attempts
  */
 lp_upolynomial_t* upolynomial_gcd_heuristic(const lp_upolynomial_t* A, const lp_upolynomial_t* B, int attempts);
+
+/**
+ * Multi-prime modular GCD computation. Compute the GCD in Z_p for word-size
+ * primes p, combine the images with the Chinese remainder theorem, and verify
+ * the result by trial division. Only on Z[x] polynomials, and the result is
+ * normalized as content times primitive part with positive leading
+ * coefficient.
+ */
+lp_upolynomial_t* upolynomial_gcd_modular(const lp_upolynomial_t* A, const lp_upolynomial_t* B);
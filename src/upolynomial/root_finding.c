@@ -27,11 +27,15 @@
 #include "upolynomial/upolynomial_dense.h"
 #include "upolynomial/output.h"
 
+#include "number/algebraic_number.h"
+
 #include <assert.h>
 #include <stdlib.h>
 #include <stdlib.h>
+#include <math.h>
 
 #include "utils/debug_trace.h"
+#include "utils/statistics.h"
 
 /** Negative infinity */
 #define INF_N (void*) 0
@@ -98,6 +102,68 @@ void upolynomial_compute_sturm_sequence(const lp_upolynomial_t* f, upolynomial_d
   *size = i + 1;
 }
 
+void upolynomial_sturm_delete(upolynomial_sturm_t* sturm) {
+  size_t factor_i, i;
+  for (factor_i = 0; factor_i < sturm->size; ++ factor_i) {
+    for (i = 0; i < sturm->S_size[factor_i]; ++ i) {
+      upolynomial_dense_destruct(sturm->S[factor_i] + i);
+    }
+    free(sturm->S[factor_i]);
+  }
+  free(sturm->S);
+  free(sturm->S_size);
+  free(sturm);
+}
+
+STAT_DECLARE(int, upolynomial, sturm_compute)
+STAT_DECLARE(int, upolynomial, sturm_cached)
+STAT_DECLARE(int, upolynomial, sturm_discarded)
+
+/**
+ * Get the Sturm sequences of the square-free factors of f, computing them if
+ * not already cached with f. NOT CONST: the cache of f is updated. The same
+ * polynomial can be used from several threads, so the sequences are published
+ * with a compare-and-swap: if another thread was first, we use its sequences
+ * and delete ours.
+ */
+static
+const upolynomial_sturm_t* upolynomial_get_sturm(const lp_upolynomial_t* f) {
+
+  upolynomial_sturm_t* cached = __atomic_load_n(&f->sturm, __ATOMIC_ACQUIRE);
+  if (cached) {
+    STAT_INCR(upolynomial, sturm_cached)
+    return cached;
+  }
+
+  STAT_INCR(upolynomial, sturm_compute)
+
+  // Get the square-free factorization and compute the sequence of each factor
+  lp_upolynomial_factors_t* square_free_factors = lp_upolynomial_factor_square_free(f);
+
+  upolynomial_sturm_t* sturm = malloc(sizeof(upolynomial_sturm_t));
+  sturm->size = square_free_factors->size;
+  sturm->S = malloc(sturm->size*sizeof(upolynomial_dense_t*));
+  sturm->S_size = malloc(sturm->size*sizeof(size_t));
+
+  size_t factor_i;
+  for (factor_i = 0; factor_i < square_free_factors->size; ++ factor_i) {
+    const lp_upolynomial_t* factor = square_free_factors->factors[factor_i];
+    sturm->S[factor_i] = malloc((lp_upolynomial_degree(factor) + 1)*sizeof(upolynomial_dense_t));
+    upolynomial_compute_sturm_sequence(factor, sturm->S[factor_i], sturm->S_size + factor_i);
+  }
+
+  lp_upolynomial_factors_destruct(square_free_factors, 1);
+
+  // Publish, unless someone else did it already
+  if (!__atomic_compare_exchange_n(&((lp_upolynomial_t*) f)->sturm, &cached, sturm, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    STAT_INCR(upolynomial, sturm_discarded)
+    upolynomial_sturm_delete(sturm);
+    sturm = cached;
+  }
+
+  return sturm;
+}
+
 /**
  * Compute the number sgn_changes(a) given Sturm sequence and a. If a is 0 or
  * 1 as a pointer, we evaluate at -inf, +inf respectively.
@@ -107,11 +173,32 @@ int sturm_seqence_count_sign_changes(
     const lp_rational_t* a, int max_changes)
 {
   int i, sgn_a, sgn_a_previous = 0, sgn_a_changes_count = 0;
+
+  // Share the powers of the denominator of a among the sequence, and
+  // evaluate in the integers (the denominator is positive)
+  size_t k, d = sturm_sequence[0].size - 1;
+  lp_integer_t* b_pow = 0;
+  lp_integer_t value;
+  if (a != INF_N && a != INF_P) {
+    b_pow = malloc(sizeof(lp_integer_t)*(d + 1));
+    integer_construct_from_int(lp_Z, b_pow, 1);
+    for (k = 1; k <= d; ++ k) {
+      integer_construct_from_int(lp_Z, b_pow + k, 0);
+      integer_mul(lp_Z, b_pow + k, b_pow + k - 1, rational_get_den_ref(a));
+    }
+    integer_construct_from_int(lp_Z, &value, 0);
+  }
+
   for (i = 0; i < sturm_sequence_size && sgn_a_changes_count < max_changes; ++ i) {
     // Get the sign of S[i] at a
-    sgn_a = (a == INF_N) ? upolynomial_dense_sgn_at_minus_inf(&sturm_sequence[i])
-          : (a == INF_P) ? upolynomial_dense_sgn_at_plus_inf(&sturm_sequence[i])
-          : upolynomial_dense_sgn_at_rational(&sturm_sequence[i], a);
+    if (a == INF_N) {
+      sgn_a = upolynomial_dense_sgn_at_minus_inf(&sturm_sequence[i]);
+    } else if (a == INF_P) {
+      sgn_a = upolynomial_dense_sgn_at_plus_inf(&sturm_sequence[i]);
+    } else {
+      upolynomial_dense_evaluate_homogeneous(&sturm_sequence[i], rational_get_num_ref(a), 0, b_pow, &value);
+      sgn_a = integer_sgn(lp_Z, &value);
+    }
     // Compare with the previous non-zero sign
     if (sgn_a_previous == 0) {
       sgn_a_previous = sgn_a;
@@ -120,6 +207,15 @@ int sturm_seqence_count_sign_changes(
       sgn_a_previous = sgn_a;
     }
   }
+
+  if (b_pow) {
+    for (k = 0; k <= d; ++ k) {
+      integer_destruct(b_pow + k);
+    }
+    free(b_pow);
+    integer_destruct(&value);
+  }
+
   return sgn_a_changes_count;
 }
 
@@ -229,42 +325,25 @@ int upolynomial_roots_count_sturm(const lp_upolynomial_t* f, const lp_rational_i
     return 0;
   }
 
-  // Get the square-free factorization and then count roots for each factor.
-  lp_upolynomial_factors_t* square_free_factors = lp_upolynomial_factor_square_free(f);
+  // Get the Sturm sequences of the square-free factors and count roots for each factor
+  const upolynomial_sturm_t* sturm = upolynomial_get_sturm(f);
 
   size_t factor_i;
-  for (factor_i = 0; factor_i < square_free_factors->size; ++ factor_i) {
-    // The factor we are working with
-    const lp_upolynomial_t* factor = square_free_factors->factors[factor_i];
-
-    // Compute the Sturm sequence for the factor
-    size_t sturm_sequence_size;
-    upolynomial_dense_t* sturm_sequence = malloc((lp_upolynomial_degree(factor) + 1)*sizeof(upolynomial_dense_t));
-    upolynomial_compute_sturm_sequence(factor, sturm_sequence, &sturm_sequence_size);
-
+  for (factor_i = 0; factor_i < sturm->size; ++ factor_i) {
     // Add the number of roots
-    total_count += sturm_seqence_count_roots(sturm_sequence, sturm_sequence_size, interval);
-
-    // Destroy the temporaries
-    size_t i;
-    for (i = 0; i < sturm_sequence_size; ++i) {
-      upolynomial_dense_destruct(sturm_sequence + i);
-    }
-    free(sturm_sequence);
+    total_count += sturm_seqence_count_roots(sturm->S[factor_i], sturm->S_size[factor_i], interval);
   }
 
-  // Destroy the factors
-  lp_upolynomial_factors_destruct(square_free_factors, 1);
-
   // Return the total number of roots
   return total_count;
 }
 
 /**
- * Recursive root isolation on an interval (a, b].
+ * Recursive root isolation on an interval (a, b]. The roots are constructed
+ * from the left, as the roots of the given root set (of S[0]).
  */
 void sturm_seqence_isolate_roots(
-    const upolynomial_dense_t* S, size_t S_size,
+    const upolynomial_dense_t* S, size_t S_size, lp_algebraic_root_set_t* set,
     lp_algebraic_number_t* roots, size_t* roots_size,
     const lp_dyadic_interval_t* interval,
     int a_sgn_changes, int b_sgn_changes)
@@ -300,11 +379,7 @@ void sturm_seqence_isolate_roots(
       } else if (upolynomial_dense_sgn_at_dyadic_rational(&S[0], &I.a) != 0) {
         // Copy out the open interval (a, b)
         I.b_open = 1;
-        lp_upolynomial_t* f = upolynomial_dense_to_upolynomial(&S[0], lp_Z);
-        if (trace_is_enabled("roots")) {
-          tracef("f = "); lp_upolynomial_print(f, trace_out); tracef("\n");
-        }
-        lp_algebraic_number_construct(&roots[*roots_size], f, &I);
+        lp_algebraic_number_construct_root(&roots[*roots_size], set, *roots_size, &I);
         lp_dyadic_interval_destruct(&I);
         (*roots_size) ++;
         return;
@@ -329,9 +404,9 @@ void sturm_seqence_isolate_roots(
     } else {
       // Recurse
       // Isolate in the right interval
-      sturm_seqence_isolate_roots(S, S_size, roots, roots_size, &I_left, a_sgn_changes, m_sgn_changes);
+      sturm_seqence_isolate_roots(S, S_size, set, roots, roots_size, &I_left, a_sgn_changes, m_sgn_changes);
       // Isolate in the left interval
-      sturm_seqence_isolate_roots(S, S_size, roots, roots_size, &I_right, m_sgn_changes, b_sgn_changes);
+      sturm_seqence_isolate_roots(S, S_size, set, roots, roots_size, &I_right, m_sgn_changes, b_sgn_changes);
       // Remove the temporaries
       lp_dyadic_interval_destruct(&I);
       lp_dyadic_interval_destruct(&I_left);
@@ -346,6 +421,69 @@ void sturm_seqence_isolate_roots(
   }
 }
 
+/**
+ * Isolate the roots of a square-free factor given its Sturm sequence. The
+ * roots are added to the roots array.
+ */
+static
+void sturm_seqence_isolate_factor(
+    const upolynomial_dense_t* sturm_sequence, size_t sturm_sequence_size,
+    lp_algebraic_number_t* roots, size_t* roots_size)
+{
+  if (trace_is_enabled("roots")) {
+    tracef("upolynomial_root_isolate_sturm(): factor = "); upolynomial_dense_print(&sturm_sequence[0], trace_out); tracef(")\n");
+  }
+
+  // Check if it's a power of x
+  if (integer_sgn(lp_Z, sturm_sequence[0].coefficients) == 0) {
+    assert(sturm_sequence[0].size == 2);
+    // Add 0 as a root
+    lp_algebraic_number_construct_zero(roots + *roots_size);
+    (*roots_size) ++;
+    return;
+  }
+
+  // Get the total number of roots
+  int total_count = sturm_seqence_count_roots_dyadic(sturm_sequence, sturm_sequence_size, 0);
+  // Now grow the interval (-1, 1] until it captures all the roots
+  lp_dyadic_interval_t interval_all;
+  lp_dyadic_interval_construct_from_int(&interval_all, -1, 1, 1, 1);
+  int a_sgn_changes, b_sgn_changes;
+  for (;;) {
+
+    if (trace_is_enabled("roots")) {
+      tracef("interval_all: ");
+      lp_dyadic_interval_print(&interval_all, trace_out);
+      tracef("\n");
+    }
+
+    // Compute the sign changes
+    a_sgn_changes = sturm_seqence_count_sign_changes_dyadic(sturm_sequence, sturm_sequence_size, &interval_all.a, sturm_sequence_size);
+    b_sgn_changes = sturm_seqence_count_sign_changes_dyadic(sturm_sequence, sturm_sequence_size, &interval_all.b, sturm_sequence_size);
+    if (a_sgn_changes - b_sgn_changes == total_count) {
+      break;
+    }
+    // Get the total number of roots
+    lp_dyadic_interval_scale(&interval_all, 1);
+  }
+
+  // Isolate the roots, all sharing the factor in a root set
+  if (a_sgn_changes - b_sgn_changes > 0) {
+    lp_upolynomial_t* factor_pp = upolynomial_dense_to_upolynomial(&sturm_sequence[0], lp_Z);
+    if (trace_is_enabled("roots")) {
+      tracef("f = "); lp_upolynomial_print(factor_pp, trace_out); tracef("\n");
+    }
+    lp_algebraic_root_set_t* set = lp_algebraic_root_set_new(factor_pp, total_count);
+    size_t current_roots_size = 0;
+    sturm_seqence_isolate_roots(sturm_sequence, sturm_sequence_size, set, roots + *roots_size, &current_roots_size, &interval_all, a_sgn_changes, b_sgn_changes);
+    (*roots_size) += current_roots_size;
+    lp_algebraic_root_set_detach(set);
+  }
+
+  // Destroy the temporaries
+  lp_dyadic_interval_destruct(&interval_all);
+}
+
 /**
  * Same as the root counting except the we
  */
@@ -365,89 +503,455 @@ void upolynomial_roots_isolate_sturm(const lp_upolynomial_t* f, lp_algebraic_num
     return;
   }
 
-  // Get the square-free factorization and then count roots for each factor.
-  lp_upolynomial_factors_t* square_free_factors = lp_upolynomial_factor_square_free(f);
+  // Get the Sturm sequences of the square-free factors
+  const upolynomial_sturm_t* sturm = upolynomial_get_sturm(f);
 
   //
   // SQUARE-FREE FACTORS CAN NOT SHARE ROOTS: we therefore us the input array directly
   //
 
   size_t factor_i;
-  for (factor_i = 0; factor_i < square_free_factors->size; ++ factor_i) {
+  for (factor_i = 0; factor_i < sturm->size; ++ factor_i) {
+    sturm_seqence_isolate_factor(sturm->S[factor_i], sturm->S_size[factor_i], roots, roots_size);
+    assert(*roots_size <= lp_upolynomial_degree(f));
+  }
 
-    // The factor we are working with
-    const lp_upolynomial_t* factor = square_free_factors->factors[factor_i];
-    int factor_deg = lp_upolynomial_degree(factor);
+  if (trace_is_enabled("roots")) {
+    tracef("upolynomial_root_isolate_sturm(");
+    lp_upolynomial_print(f, trace_out);
+    tracef(" = %zu \n", *roots_size);
+  }
 
-    if (trace_is_enabled("roots")) {
-      tracef("upolynomial_root_isolate_sturm(): factor = "); lp_upolynomial_print(factor, trace_out); tracef(")\n");
-    }
+  // Sort the roots
+  qsort(roots, *roots_size, sizeof(lp_algebraic_number_t), lp_algebraic_number_cmp_void);
+}
 
-    // Check if it's a power of x
-    if (!lp_upolynomial_const_term(factor)) {
-      assert(factor_deg == 1);
-      // Add 0 as a root
-      lp_algebraic_number_construct_zero(roots + *roots_size);
-      (*roots_size) ++;
-      assert(*roots_size <= lp_upolynomial_degree(f));
-      continue;
+STAT_DECLARE(int, upolynomial, roots_numeric)
+STAT_DECLARE(int, upolynomial, roots_numeric_certified)
+STAT_DECLARE(int, upolynomial, roots_numeric_certified_local)
+STAT_DECLARE(int, upolynomial, roots_numeric_fallback)
+
+/** Maximal number of Aberth iterations */
+#define ROOTS_NUMERIC_MAX_ITERATIONS 100
+
+/** Relative precision at which the Aberth iteration stops */
+#define ROOTS_NUMERIC_EPS 0x1p-56L
+
+/** Relative width of the isolating intervals around the approximations */
+#define ROOTS_NUMERIC_WIDTH 0x1p-48L
+
+/** Complex numbers for the numeric approximation */
+typedef long double _Complex root_complex_t;
+
+/** Returns re + i*im */
+static inline
+root_complex_t root_complex(long double re, long double im) {
+  root_complex_t z;
+  __real__ z = re;
+  __imag__ z = im;
+  return z;
+}
+
+/** The L1 norm |re(z)| + |im(z)| */
+static inline
+long double root_complex_abs(root_complex_t z) {
+  long double re = __real__ z, im = __imag__ z;
+  return (re < 0 ? -re : re) + (im < 0 ? -im : im);
+}
+
+/**
+ * Approximate all complex roots of the polynomial with coefficients c[0..d]
+ * using the Aberth-Ehrlich iteration. The last corrections of each root are
+ * stored in w. Returns 0 if the computation breaks down.
+ */
+static
+int roots_numeric_aberth(const long double* c, size_t d, root_complex_t* z, long double* w) {
+
+  size_t i, j, k, it;
+
+  // Start on a circle with radius roughly |c_0/c_d|^(1/d), with a rotation so
+  // that we're not symmetric with respect to the real axis
+  int e_0, e_d;
+  frexpl(c[0], &e_0);
+  frexpl(c[d], &e_d);
+  long double radius = ldexpl(1, (e_0 - e_d) / (int) d);
+  long double t = 3.14159265358979323846L / d;
+  root_complex_t step = root_complex(1, t)*root_complex(1, t) / (1 + t*t);
+  root_complex_t current = root_complex(0.6L*radius, 0.8L*radius);
+  for (k = 0; k < d; ++ k) {
+    z[k] = current;
+    current *= step;
+  }
+
+  for (it = 0; it < ROOTS_NUMERIC_MAX_ITERATIONS; ++ it) {
+    int converged = 1;
+    for (k = 0; k < d; ++ k) {
+      // p(z_k) and p'(z_k)
+      root_complex_t p = c[d], dp = 0;
+      for (i = d; i > 0; -- i) {
+        dp = dp*z[k] + p;
+        p = p*z[k] + c[i - 1];
+      }
+      if (p == 0) {
+        w[k] = 0;
+        continue;
+      }
+      // Aberth correction p/p' / (1 - p/p' * sum 1/(z_k - z_j))
+      root_complex_t ratio = p / dp;
+      root_complex_t sum = 0;
+      for (j = 0; j < d; ++ j) {
+        if (j != k) {
+          sum += 1 / (z[k] - z[j]);
+        }
+      }
+      root_complex_t correction = ratio / (1 - ratio*sum);
+      w[k] = root_complex_abs(correction);
+      if (!__builtin_isfinite(w[k])) {
+        return 0;
+      }
+      z[k] -= correction;
+      if (w[k] > ROOTS_NUMERIC_EPS*root_complex_abs(z[k])) {
+        converged = 0;
+      }
     }
+    if (converged) {
+      break;
+    }
+  }
+
+  return 1;
+}
 
-    // Compute the Sturm sequence for the factor
-    size_t sturm_sequence_size;
-    upolynomial_dense_t* sturm_sequence = malloc((factor_deg+1)*sizeof(upolynomial_dense_t));
-    upolynomial_compute_sturm_sequence(factor, sturm_sequence, &sturm_sequence_size);
+static
+int roots_numeric_cmp(const void* x, const void* y) {
+  long double a = *(const long double*) x;
+  long double b = *(const long double*) y;
+  return a < b ? -1 : (a > b ? 1 : 0);
+}
 
-    // Get the total number of roots
-    int total_count = sturm_seqence_count_roots_dyadic(sturm_sequence, sturm_sequence_size, 0);
-    // Now grow the interval (-1, 1] until it captures all the roots
-    lp_dyadic_interval_t interval_all;
-    lp_dyadic_interval_construct_from_int(&interval_all, -1, 1, 1, 1);
-    int a_sgn_changes, b_sgn_changes;
-    for (;;) {
-
-      if (trace_is_enabled("roots")) {
-        tracef("interval_all: ");
-        lp_dyadic_interval_print(&interval_all, trace_out);
-        tracef("\n");
+/** Number of sign variations in the coefficients of p */
+static
+int upolynomial_dense_sgn_variations(const upolynomial_dense_t* p) {
+  size_t i;
+  int variations = 0, last_sgn = 0;
+  for (i = 0; i < p->size; ++ i) {
+    int sgn = integer_sgn(lp_Z, p->coefficients + i);
+    if (sgn) {
+      if (last_sgn && sgn != last_sgn) {
+        variations ++;
       }
+      last_sgn = sgn;
+    }
+  }
+  return variations;
+}
 
-      // Compute the sign changes
-      a_sgn_changes = sturm_seqence_count_sign_changes_dyadic(sturm_sequence, sturm_sequence_size, &interval_all.a, sturm_sequence_size);
-      b_sgn_changes = sturm_seqence_count_sign_changes_dyadic(sturm_sequence, sturm_sequence_size, &interval_all.b, sturm_sequence_size);
-      if (a_sgn_changes - b_sgn_changes == total_count) {
+/** p = 2^(n*d)*p((x + a)/2^n) */
+static
+void upolynomial_dense_shift_dyadic(upolynomial_dense_t* p, const lp_integer_t* a, unsigned long n) {
+  size_t i, d = p->size - 1;
+  for (i = 0; i < d; ++ i) {
+    integer_mul_pow2(lp_Z, p->coefficients + i, p->coefficients + i, n*(d - i));
+  }
+  upolynomial_dense_taylor_shift(p, a);
+}
+
+/**
+ * Descartes' bound on the number of roots of the square-free p in the open
+ * interval (a, b), where a can be INF_N or b can be INF_P. The number of roots
+ * is at most the bound and has the same parity.
+ */
+static
+int upolynomial_dense_descartes_bound(const upolynomial_dense_t* p, const lp_dyadic_rational_t* a, const lp_dyadic_rational_t* b) {
+
+  assert(a != INF_N || b != INF_P);
+
+  size_t i, d = p->size - 1;
+  upolynomial_dense_t h;
+  upolynomial_dense_construct(&h, d + 1);
+  for (i = 0; i <= d; ++ i) {
+    integer_assign(lp_Z, h.coefficients + i, p->coefficients + i);
+  }
+  h.size = d + 1;
+
+  if (a == INF_N) {
+    // Roots y > 0 of p(b - y)
+    upolynomial_dense_shift_dyadic(&h, &b->a, b->n);
+    for (i = 1; i <= d; i += 2) {
+      integer_neg(lp_Z, h.coefficients + i, h.coefficients + i);
+    }
+  } else if (b == INF_P) {
+    // Roots y > 0 of p(a + y)
+    upolynomial_dense_shift_dyadic(&h, &a->a, a->n);
+  } else {
+    // Roots y in (0, 1) of p(a + (b - a)*y), i.e. roots y > 0 of
+    // (y + 1)^d p(a + (b - a)/(y + 1)), with a = A/2^n and b - a = W/2^n
+    unsigned long n = a->n > b->n ? a->n : b->n;
+    lp_integer_t A, W, W_pow;
+    integer_construct_from_int(lp_Z, &A, 0);
+    integer_construct_from_int(lp_Z, &W, 0);
+    integer_construct_from_int(lp_Z, &W_pow, 1);
+    integer_mul_pow2(lp_Z, &A, &a->a, n - a->n);
+    integer_mul_pow2(lp_Z, &W, &b->a, n - b->n);
+    integer_sub(lp_Z, &W, &W, &A);
+    assert(integer_sgn(lp_Z, &W) > 0);
+    upolynomial_dense_shift_dyadic(&h, &A, n);
+    for (i = 1; i <= d; ++ i) {
+      integer_mul(lp_Z, &W_pow, &W_pow, &W);
+      integer_mul(lp_Z, h.coefficients + i, h.coefficients + i, &W_pow);
+    }
+    for (i = 0; i < d - i; ++ i) {
+      integer_swap(h.coefficients + i, h.coefficients + d - i);
+    }
+    integer_assign_int(lp_Z, &W_pow, 1);
+    upolynomial_dense_taylor_shift(&h, &W_pow);
+    integer_destruct(&A);
+    integer_destruct(&W);
+    integer_destruct(&W_pow);
+  }
+
+  int variations = upolynomial_dense_sgn_variations(&h);
+  upolynomial_dense_destruct(&h);
+  return variations;
+}
+
+/**
+ * Isolate the real roots of the square-free and primitive g (with g(0) != 0)
+ * numerically, and certify the intervals exactly. Each interval must have a
+ * sign change of g at the end-points. We then check that there are no other
+ * roots: first with Descartes' rule of signs on (-inf, 0) and (0, inf), and
+ * if that is not enough, on each interval and each gap between them. Returns
+ * 0 if the roots could not be certified (in which case nothing is
+ * constructed).
+ */
+static
+int upolynomial_roots_isolate_numeric_factor(const lp_upolynomial_t* g, lp_algebraic_number_t* roots, size_t* roots_size) {
+
+  size_t i, j, d = lp_upolynomial_degree(g);
+  int certified = 0;
+
+  upolynomial_dense_t g_d;
+  upolynomial_dense_construct_p(&g_d, d + 1, g);
+
+  // Coefficients as long doubles, scaled by the largest exponent
+  long double* c = malloc(sizeof(long double)*(d + 1));
+  long* c_exp = malloc(sizeof(long)*(d + 1));
+  long exp_max = 0;
+  for (i = 0; i <= d; ++ i) {
+    c[i] = mpz_get_d_2exp(c_exp + i, g_d.coefficients + i);
+    if (i == 0 || c_exp[i] > exp_max) {
+      exp_max = c_exp[i];
+    }
+  }
+  for (i = 0; i <= d; ++ i) {
+    c[i] = ldexpl(c[i], c_exp[i] - exp_max);
+  }
+
+  root_complex_t* z = malloc(sizeof(root_complex_t)*d);
+  long double* w = malloc(sizeof(long double)*d);
+  long double* x = malloc(sizeof(long double)*2*d);
+  lp_dyadic_interval_t* intervals = malloc(sizeof(lp_dyadic_interval_t)*d);
+  size_t x_size = 0, intervals_size = 0;
+
+  if (!roots_numeric_aberth(c, d, z, w)) {
+    goto done;
+  }
+
+  // Pick the real roots (x, w) sorted by x
+  for (i = 0; i < d; ++ i) {
+    long double re = __real__ z[i], im = __imag__ z[i];
+    long double im_abs = im < 0 ? -im : im;
+    long double re_abs = re < 0 ? -re : re;
+    if (im_abs <= 16*w[i] + ROOTS_NUMERIC_WIDTH*re_abs) {
+      x[2*x_size] = re;
+      x[2*x_size + 1] = w[i];
+      x_size ++;
+    }
+  }
+  qsort(x, x_size, 2*sizeof(long double), roots_numeric_cmp);
+
+  // Isolating intervals with a sign change, not containing 0 and disjoint
+  int positive = 0, negative = 0;
+  for (i = 0; i < x_size; ++ i) {
+    long double x_i = x[2*i], x_i_abs = x_i < 0 ? -x_i : x_i;
+    long double r = 8*x[2*i + 1];
+    if (r < ROOTS_NUMERIC_WIDTH*x_i_abs) {
+      r = ROOTS_NUMERIC_WIDTH*x_i_abs;
+    }
+    long double r_max = x_i_abs;
+    if (i > 0 && (x_i - x[2*i - 2])/3 < r_max) {
+      r_max = (x_i - x[2*i - 2])/3;
+    }
+    if (i + 1 < x_size && (x[2*i + 2] - x_i)/3 < r_max) {
+      r_max = (x[2*i + 2] - x_i)/3;
+    }
+    int sgn_change = 0;
+    lp_dyadic_rational_t lo, hi;
+    dyadic_rational_construct(&lo);
+    dyadic_rational_construct(&hi);
+    for (; r <= r_max; r *= 16) {
+      double lo_d = x_i - r, hi_d = x_i + r;
+      if (!(lo_d < hi_d) || (lo_d <= 0 && 0 <= hi_d)) {
+        continue;
+      }
+      dyadic_rational_destruct(&lo);
+      dyadic_rational_destruct(&hi);
+      dyadic_rational_construct_from_double(&lo, lo_d);
+      dyadic_rational_construct_from_double(&hi, hi_d);
+      int sgn_lo = upolynomial_dense_sgn_at_dyadic_rational(&g_d, &lo);
+      int sgn_hi = upolynomial_dense_sgn_at_dyadic_rational(&g_d, &hi);
+      if (sgn_lo*sgn_hi < 0) {
+        sgn_change = 1;
+        break;
+      }
+      if (sgn_lo == 0 || sgn_hi == 0) {
         break;
       }
-      // Get the total number of roots
-      lp_dyadic_interval_scale(&interval_all, 1);
     }
+    if (sgn_change) {
+      lp_dyadic_interval_construct(intervals + intervals_size, &lo, 1, &hi, 1);
+      intervals_size ++;
+      if (x_i > 0) {
+        positive ++;
+      } else {
+        negative ++;
+      }
+    }
+    dyadic_rational_destruct(&lo);
+    dyadic_rational_destruct(&hi);
+    if (!sgn_change) {
+      goto done;
+    }
+  }
 
-    // Isolate the roots
-    if (a_sgn_changes - b_sgn_changes > 0) {
-      size_t current_roots_size = 0;
-      sturm_seqence_isolate_roots(sturm_sequence, sturm_sequence_size, roots + *roots_size, &current_roots_size, &interval_all, a_sgn_changes, b_sgn_changes);
-      (*roots_size) += current_roots_size;
-      assert(*roots_size <= lp_upolynomial_degree(f));
+  // Descartes' bound for positive and negative roots
+  int positive_bound = upolynomial_dense_sgn_variations(&g_d);
+  for (i = 1; i <= d; i += 2) {
+    integer_neg(lp_Z, g_d.coefficients + i, g_d.coefficients + i);
+  }
+  int negative_bound = upolynomial_dense_sgn_variations(&g_d);
+  for (i = 1; i <= d; i += 2) {
+    integer_neg(lp_Z, g_d.coefficients + i, g_d.coefficients + i);
+  }
+
+  if (positive_bound == positive && negative_bound == negative) {
+    certified = 1;
+  } else {
+    // Check each interval and each gap between them
+    certified = 1;
+    for (i = 0; certified && i <= intervals_size; ++ i) {
+      const lp_dyadic_rational_t* a = i > 0 ? &intervals[i - 1].b : INF_N;
+      const lp_dyadic_rational_t* b = i < intervals_size ? &intervals[i].a : INF_P;
+      if (a == INF_N && b == INF_P) {
+        certified = positive_bound == 0 && negative_bound == 0;
+      } else if (upolynomial_dense_descartes_bound(&g_d, a, b) != 0) {
+        certified = 0;
+      }
+      if (certified && i < intervals_size) {
+        certified = upolynomial_dense_descartes_bound(&g_d, &intervals[i].a, &intervals[i].b) == 1;
+      }
     }
+    if (certified) {
+      STAT_INCR(upolynomial, roots_numeric_certified_local)
+    }
+  }
 
-    // Destroy the temporaries
-    lp_dyadic_interval_destruct(&interval_all);
-    size_t i;
-    for (i = 0; i < sturm_sequence_size; ++i) {
-      upolynomial_dense_destruct(sturm_sequence + i);
+  if (certified) {
+    STAT_INCR(upolynomial, roots_numeric_certified)
+    if (intervals_size > 0) {
+      lp_algebraic_root_set_t* set = lp_algebraic_root_set_new(lp_upolynomial_construct_copy(g), intervals_size);
+      for (j = 0; j < intervals_size; ++ j) {
+        lp_algebraic_number_construct_root(roots + *roots_size, set, j, intervals + j);
+        (*roots_size) ++;
+      }
+      lp_algebraic_root_set_detach(set);
     }
-    free(sturm_sequence);
   }
 
+done:
+
+  for (i = 0; i < intervals_size; ++ i) {
+    lp_dyadic_interval_destruct(intervals + i);
+  }
+  free(intervals);
+  free(x);
+  free(w);
+  free(z);
+  free(c_exp);
+  free(c);
+  upolynomial_dense_destruct(&g_d);
+
+  return certified;
+}
+
+void upolynomial_roots_isolate_numeric(const lp_upolynomial_t* f, lp_algebraic_number_t* roots, size_t* roots_size) {
+
+  assert(f->K == lp_Z);
+
   if (trace_is_enabled("roots")) {
-    tracef("upolynomial_root_isolate_sturm(");
+    tracef("upolynomial_roots_isolate_numeric("); lp_upolynomial_print(f, trace_out); tracef(")\n");
+  }
+
+  STAT_INCR(upolynomial, roots_numeric)
+
+  *roots_size = 0;
+
+  // Special case for the constants
+  if (lp_upolynomial_degree(f) == 0) {
+    assert(!lp_upolynomial_is_zero(f));
+    return;
+  }
+
+  lp_upolynomial_factors_t* square_free_factors = lp_upolynomial_factor_square_free(f);
+
+  // Sturm sequences of f, if a large factor can't be certified
+  const upolynomial_sturm_t* sturm = 0;
+
+  size_t factor_i;
+  for (factor_i = 0; factor_i < square_free_factors->size; ++ factor_i) {
+    const lp_upolynomial_t* factor = square_free_factors->factors[factor_i];
+    if (!lp_upolynomial_const_term(factor)) {
+      // Power of x
+      assert(lp_upolynomial_degree(factor) == 1);
+      lp_algebraic_number_construct_zero(roots + *roots_size);
+      (*roots_size) ++;
+      continue;
+    }
+    lp_upolynomial_t* factor_pp = lp_upolynomial_primitive_part_Z(factor);
+    if (lp_upolynomial_degree(factor_pp) < UPOLYNOMIAL_ROOTS_NUMERIC_MIN_DEGREE) {
+      // Exact isolation, the sequence of a small factor is cheap to compute
+      size_t S_size;
+      upolynomial_dense_t* S = malloc((lp_upolynomial_degree(factor_pp) + 1)*sizeof(upolynomial_dense_t));
+      upolynomial_compute_sturm_sequence(factor_pp, S, &S_size);
+      sturm_seqence_isolate_factor(S, S_size, roots, roots_size);
+      size_t i;
+      for (i = 0; i < S_size; ++ i) {
+        upolynomial_dense_destruct(S + i);
+      }
+      free(S);
+    } else if (!upolynomial_roots_isolate_numeric_factor(factor_pp, roots, roots_size)) {
+      // Exact isolation. The factor would fail again the next time, so we use
+      // the Sturm sequences cached with f (same factors), and f is isolated
+      // with the cached sequences directly from then on.
+      STAT_INCR(upolynomial, roots_numeric_fallback)
+      if (!sturm) {
+        sturm = upolynomial_get_sturm(f);
+        assert(sturm->size == square_free_factors->size);
+      }
+      sturm_seqence_isolate_factor(sturm->S[factor_i], sturm->S_size[factor_i], roots, roots_size);
+    }
+    lp_upolynomial_delete(factor_pp);
+    assert(*roots_size <= lp_upolynomial_degree(f));
+  }
+
+  lp_upolynomial_factors_destruct(square_free_factors, 1);
+
+  if (trace_is_enabled("roots")) {
+    tracef("upolynomial_roots_isolate_numeric(");
     lp_upolynomial_print(f, trace_out);
     tracef(" = %zu \n", *roots_size);
   }
 
   // Sort the roots
   qsort(roots, *roots_size, sizeof(lp_algebraic_number_t), lp_algebraic_number_cmp_void);
-
-  // Destroy the factors
-  lp_upolynomial_factors_destruct(square_free_factors, 1);
 }
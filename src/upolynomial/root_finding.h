@@ -23,6 +23,7 @@
 #include <upolynomial.h>
 #include <algebraic_number.h>
 
+#include "upolynomial/upolynomial.h"
 #include "upolynomial/upolynomial_dense.h"
 
 #include "number/dyadic_rational.h"
@@ -40,6 +41,31 @@
  */
 void upolynomial_compute_sturm_sequence(const lp_upolynomial_t* f, upolynomial_dense_t* S, size_t* size);
 
+/**
+ * Sturm sequences of the square-free factors of a polynomial. These are
+ * computed on the first root counting (or isolation) and cached with the
+ * polynomial, so that repeated root counting only evaluates the signs.
+ *
+ * The cache is kept until the polynomial is deleted, and it is much larger
+ * than the polynomial: a factor of degree d has d+1 polynomials in its
+ * sequence, of degrees up to d and with coefficients of size O(d) times the
+ * size of the coefficients of the factor, so O(d^3) for the whole sequence.
+ * Polynomials of large degree are only isolated with Sturm sequences if they
+ * are already cached (see UPOLYNOMIAL_ROOTS_NUMERIC_MIN_DEGREE), but root
+ * counting caches them for any degree.
+ */
+struct upolynomial_sturm_struct {
+  /** Number of square-free factors */
+  size_t size;
+  /** The Sturm sequence of each factor */
+  upolynomial_dense_t** S;
+  /** The size of each sequence */
+  size_t* S_size;
+};
+
+/** Delete the Sturm sequences */
+void upolynomial_sturm_delete(upolynomial_sturm_t* sturm);
+
 /**
  * Count the number of real roots that the polynomial f has in the given open
  * interval. The polynomial f should be square-free.
@@ -52,3 +78,15 @@ int upolynomial_roots_count_sturm(const lp_upolynomial_t* f, const lp_rational_i
  * will be updated to the number of roots.
  */
 void upolynomial_roots_isolate_sturm(const lp_upolynomial_t* f, lp_algebraic_number_t* roots, size_t* roots_size);
+
+/** Square-free factors of smaller degree are isolated with Sturm sequences directly */
+#define UPOLYNOMIAL_ROOTS_NUMERIC_MIN_DEGREE 96
+
+/**
+ * Same as upolynomial_roots_isolate_sturm(), but for each square-free factor
+ * the roots are first approximated numerically (Aberth iteration in long
+ * double precision). The isolating intervals around the real approximations
+ * are then certified exactly using sign changes and Descartes' rule of signs.
+ * Factors that can't be certified are isolated with Sturm sequences.
+ */
+void upolynomial_roots_isolate_numeric(const lp_upolynomial_t* f, lp_algebraic_number_t* roots, size_t* roots_size);
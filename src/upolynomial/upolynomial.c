@@ -26,8 +26,10 @@
 #include "upolynomial/gcd.h"
 #include "upolynomial/factorization.h"
 #include "upolynomial/root_finding.h"
+#include "upolynomial/composed.h"
 
 #include "utils/debug_trace.h"
+#include "utils/statistics.h"
 
 #include <stdlib.h>
 #include <assert.h>
@@ -48,10 +50,20 @@ lp_upolynomial_t* lp_upolynomial_construct_empty(const lp_int_ring_t* K, size_t
   lp_upolynomial_t* new_p = (lp_upolynomial_t*) malloc(malloc_size);
   new_p->K = (lp_int_ring_t*)K;
   new_p->size = size;
+  new_p->sturm = 0;
   lp_int_ring_attach((lp_int_ring_t*)K);
   return new_p;
 }
 
+/** Drop the cached data, to be called when p changes */
+static inline
+void upolynomial_invalidate_cache(lp_upolynomial_t* p) {
+  if (p->sturm) {
+    upolynomial_sturm_delete(p->sturm);
+    p->sturm = 0;
+  }
+}
+
 lp_upolynomial_t* lp_upolynomial_construct(const lp_int_ring_t* K, size_t degree, const lp_integer_t* coefficients) {
 
   // Compute the needed size
@@ -100,6 +112,7 @@ void lp_upolynomial_delete(lp_upolynomial_t* p) {
   for (i = 0; i < p->size; ++ i) {
     integer_destruct(&p->monomials[i].coefficient);
   }
+  upolynomial_invalidate_cache(p);
   lp_int_ring_detach((lp_int_ring_t*)p->K);
   free(p);
 }
@@ -234,6 +247,7 @@ const lp_int_ring_t* lp_upolynomial_ring(const lp_upolynomial_t* p) {
 
 void lp_upolynomial_set_ring(lp_upolynomial_t* p, const lp_int_ring_t* K) {
   assert(p);
+  upolynomial_invalidate_cache(p);
   lp_int_ring_detach(p->K);
   p->K = (lp_int_ring_t*)K;
   lp_int_ring_attach(p->K);
@@ -917,6 +931,7 @@ int lp_upolynomial_is_primitive(const lp_upolynomial_t* p) {
 
 void lp_upolynomial_make_primitive_Z(lp_upolynomial_t* p) {
   assert(p->K == lp_Z);
+  upolynomial_invalidate_cache(p);
 
   lp_integer_t gcd;
   integer_construct_from_int(lp_Z, &gcd, 0);
@@ -1004,6 +1019,143 @@ int lp_upolynomial_sgn_at_dyadic_rational(const lp_upolynomial_t* p, const lp_dy
   return sgn;
 }
 
+STAT_DECLARE(int, upolynomial, evaluate_many)
+STAT_DECLARE(int, upolynomial, evaluate_many_den)
+
+/**
+ * Computes the homogenized values b^d*p(a/b) at all points a/b. The powers of
+ * the denominator are shared among consecutive points with the same
+ * denominator.
+ */
+static
+void upolynomial_dense_evaluate_many_homogeneous(const upolynomial_dense_t* p_d, size_t n, const lp_rational_t* x, lp_integer_t* values) {
+  size_t i, k, d = p_d->size - 1;
+
+  lp_integer_t* b_pow = malloc(sizeof(lp_integer_t)*(d + 1));
+  for (k = 0; k <= d; ++ k) {
+    integer_construct_from_int(lp_Z, b_pow + k, 0);
+  }
+
+  for (i = 0; i < n; ++ i) {
+    const lp_integer_t* b = rational_get_den_ref(x + i);
+    if (i == 0 || integer_cmp(lp_Z, b, rational_get_den_ref(x + i - 1))) {
+      STAT_INCR(upolynomial, evaluate_many_den)
+      integer_assign_int(lp_Z, b_pow, 1);
+      for (k = 1; k <= d; ++ k) {
+        integer_mul(lp_Z, b_pow + k, b_pow + k - 1, b);
+      }
+    }
+    upolynomial_dense_evaluate_homogeneous(p_d, rational_get_num_ref(x + i), b, b_pow, values + i);
+  }
+
+  for (k = 0; k <= d; ++ k) {
+    integer_destruct(b_pow + k);
+  }
+  free(b_pow);
+}
+
+void lp_upolynomial_evaluate_many(const lp_upolynomial_t* p, size_t n, const lp_rational_t* x, lp_rational_t* values) {
+  assert(p->K == lp_Z);
+
+  STAT_INCR(upolynomial, evaluate_many)
+
+  size_t i, d = lp_upolynomial_degree(p);
+  upolynomial_dense_t p_d;
+  upolynomial_dense_construct_p(&p_d, d + 1, p);
+
+  lp_integer_t* num = malloc(sizeof(lp_integer_t)*n);
+  for (i = 0; i < n; ++ i) {
+    integer_construct_from_int(lp_Z, num + i, 0);
+  }
+  upolynomial_dense_evaluate_many_homogeneous(&p_d, n, x, num);
+
+  // p(a/b) = num/b^d
+  lp_integer_t den;
+  integer_construct_from_int(lp_Z, &den, 0);
+  for (i = 0; i < n; ++ i) {
+    if (i == 0 || integer_cmp(lp_Z, rational_get_den_ref(x + i), rational_get_den_ref(x + i - 1))) {
+      integer_pow(lp_Z, &den, rational_get_den_ref(x + i), d);
+    }
+    lp_rational_t value;
+    rational_construct_from_div(&value, num + i, &den);
+    rational_swap(&value, values + i);
+    rational_destruct(&value);
+  }
+  integer_destruct(&den);
+
+  for (i = 0; i < n; ++ i) {
+    integer_destruct(num + i);
+  }
+  free(num);
+  upolynomial_dense_destruct(&p_d);
+}
+
+void lp_upolynomial_sgn_many(const lp_upolynomial_t* p, size_t n, const lp_rational_t* x, int* sgns) {
+  assert(p->K == lp_Z);
+
+  STAT_INCR(upolynomial, evaluate_many)
+
+  size_t i;
+  upolynomial_dense_t p_d;
+  upolynomial_dense_construct_p(&p_d, lp_upolynomial_degree(p) + 1, p);
+
+  lp_integer_t* num = malloc(sizeof(lp_integer_t)*n);
+  for (i = 0; i < n; ++ i) {
+    integer_construct_from_int(lp_Z, num + i, 0);
+  }
+  upolynomial_dense_evaluate_many_homogeneous(&p_d, n, x, num);
+
+  // Denominators are positive
+  for (i = 0; i < n; ++ i) {
+    sgns[i] = integer_sgn(lp_Z, num + i);
+    integer_destruct(num + i);
+  }
+  free(num);
+  upolynomial_dense_destruct(&p_d);
+}
+
+void lp_upolynomial_evaluate_many_dyadic(const lp_upolynomial_t* p, size_t n, const lp_dyadic_rational_t* x, lp_dyadic_rational_t* values) {
+  assert(p->K == lp_Z);
+
+  STAT_INCR(upolynomial, evaluate_many)
+
+  size_t i, d = lp_upolynomial_degree(p);
+  upolynomial_dense_t p_d;
+  upolynomial_dense_construct_p(&p_d, d + 1, p);
+
+  // p(a/2^k) = num/2^(k*d)
+  lp_dyadic_rational_t num;
+  dyadic_rational_construct(&num);
+  for (i = 0; i < n; ++ i) {
+    upolynomial_dense_evaluate_homogeneous_2exp(&p_d, &x[i].a, x[i].n, &num.a);
+    num.n = 0;
+    dyadic_rational_div_2exp(values + i, &num, x[i].n*d);
+  }
+  dyadic_rational_destruct(&num);
+
+  upolynomial_dense_destruct(&p_d);
+}
+
+void lp_upolynomial_sgn_many_dyadic(const lp_upolynomial_t* p, size_t n, const lp_dyadic_rational_t* x, int* sgns) {
+  assert(p->K == lp_Z);
+
+  STAT_INCR(upolynomial, evaluate_many)
+
+  size_t i;
+  upolynomial_dense_t p_d;
+  upolynomial_dense_construct_p(&p_d, lp_upolynomial_degree(p) + 1, p);
+
+  lp_integer_t value;
+  integer_construct_from_int(lp_Z, &value, 0);
+  for (i = 0; i < n; ++ i) {
+    upolynomial_dense_evaluate_homogeneous_2exp(&p_d, &x[i].a, x[i].n, &value);
+    sgns[i] = integer_sgn(lp_Z, &value);
+  }
+  integer_destruct(&value);
+
+  upolynomial_dense_destruct(&p_d);
+}
+
 lp_upolynomial_t* lp_upolynomial_gcd(const lp_upolynomial_t* p, const lp_upolynomial_t* q) {
 
   if (trace_is_enabled("gcd")) {
@@ -1022,10 +1174,16 @@ lp_upolynomial_t* lp_upolynomial_gcd(const lp_upolynomial_t* p, const lp_upolyno
     gcd = lp_upolynomial_gcd(q, p);
   } else {
     if (p->K == lp_Z) {
-      gcd = upolynomial_gcd_heuristic(p, q, 2);
-      if (!gcd) {
+      if (lp_upolynomial_degree(q) <= UPOLYNOMIAL_GCD_SUBRESULTANT_MAX_DEGREE) {
         gcd = upolynomial_gcd_subresultant(p, q);
+      } else {
+        gcd = upolynomial_gcd_heuristic(p, q, 2);
+        if (!gcd) {
+          gcd = upolynomial_gcd_modular(p, q);
+        }
       }
+    } else if (lp_upolynomial_degree(q) >= UPOLYNOMIAL_GCD_HGCD_MIN_DEGREE) {
+      gcd = upolynomial_gcd_hgcd(p, q);
     } else {
       gcd = upolynomial_gcd_euclid(p, q, 0, 0);
     }
@@ -1127,12 +1285,45 @@ void lp_upolynomial_roots_isolate(const lp_upolynomial_t* p, lp_algebraic_number
   if (trace_is_enabled("roots")) {
     tracef("upolynomial_roots_isolate("); lp_upolynomial_print(p, trace_out); tracef(")\n");
   }
-  upolynomial_roots_isolate_sturm(p, roots, roots_size);
+  if (__atomic_load_n(&p->sturm, __ATOMIC_ACQUIRE) || lp_upolynomial_degree(p) < UPOLYNOMIAL_ROOTS_NUMERIC_MIN_DEGREE) {
+    // Sturm sequences are cached, or small degree
+    upolynomial_roots_isolate_sturm(p, roots, roots_size);
+  } else {
+    upolynomial_roots_isolate_numeric(p, roots, roots_size);
+  }
   if (trace_is_enabled("roots")) {
     tracef("upolynomial_roots_isolate("); lp_upolynomial_print(p, trace_out); tracef(") => %zu\n", *roots_size);
   }
 }
 
+lp_upolynomial_t* lp_upolynomial_composed_sum(const lp_upolynomial_t* f, const lp_upolynomial_t* g) {
+  if (trace_is_enabled("composed")) {
+    tracef("upolynomial_composed_sum("); lp_upolynomial_print(f, trace_out); tracef(", "); lp_upolynomial_print(g, trace_out); tracef(")\n");
+  }
+  assert(f->K == lp_Z && g->K == lp_Z);
+  assert(lp_upolynomial_degree(f) > 0 && lp_upolynomial_degree(g) > 0);
+  lp_upolynomial_t* result = upolynomial_composed_sum(f, g);
+  if (trace_is_enabled("composed")) {
+    tracef("upolynomial_composed_sum("); lp_upolynomial_print(f, trace_out); tracef(", "); lp_upolynomial_print(g, trace_out); tracef(") => ");
+    lp_upolynomial_print(result, trace_out); tracef("\n");
+  }
+  return result;
+}
+
+lp_upolynomial_t* lp_upolynomial_composed_product(const lp_upolynomial_t* f, const lp_upolynomial_t* g) {
+  if (trace_is_enabled("composed")) {
+    tracef("upolynomial_composed_product("); lp_upolynomial_print(f, trace_out); tracef(", "); lp_upolynomial_print(g, trace_out); tracef(")\n");
+  }
+  assert(f->K == lp_Z && g->K == lp_Z);
+  assert(lp_upolynomial_degree(f) > 0 && lp_upolynomial_degree(g) > 0);
+  lp_upolynomial_t* result = upolynomial_composed_product(f, g);
+  if (trace_is_enabled("composed")) {
+    tracef("upolynomial_composed_product("); lp_upolynomial_print(f, trace_out); tracef(", "); lp_upolynomial_print(g, trace_out); tracef(") => ");
+    lp_upolynomial_print(result, trace_out); tracef("\n");
+  }
+  return result;
+}
+
 void lp_upolynomial_sturm_sequence(const lp_upolynomial_t* f, lp_upolynomial_t*** S, size_t* size) {
   if (trace_is_enabled("roots")) {
     tracef("upolynomial_roots_sturm_sequence("); lp_upolynomial_print(f, trace_out); tracef(")\n");
@@ -1163,6 +1354,7 @@ lp_upolynomial_t* lp_upolynomial_neg(const lp_upolynomial_t* p) {
 
 void lp_upolynomial_neg_in_place(lp_upolynomial_t* p) {
   size_t i;
+  upolynomial_invalidate_cache(p);
   for (i = 0; i < p->size; ++ i) {
     integer_neg(p->K, &p->monomials[i].coefficient, &p->monomials[i].coefficient);
   }
@@ -1174,6 +1366,7 @@ void lp_upolynomial_reverse_in_place(lp_upolynomial_t* p) {
 
   // reverse order and update degrees
   assert(p->size > 0);
+  upolynomial_invalidate_cache(p);
   p_deg = lp_upolynomial_degree(p);
   m_i = p->monomials;
   m_j = p->monomials + p->size - 1;
@@ -1199,3 +1392,38 @@ lp_upolynomial_t* lp_upolynomial_subst_x_neg(const lp_upolynomial_t* f) {
 
   return neg;
 }
+
+lp_upolynomial_t* lp_upolynomial_taylor_shift(const lp_upolynomial_t* f, const lp_dyadic_rational_t* c) {
+
+  assert(f->K == lp_Z || c->n == 0);
+
+  if (trace_is_enabled("arithmetic")) {
+    tracef("upolynomial_taylor_shift("); lp_upolynomial_print(f, trace_out); tracef(", "); dyadic_rational_print(c, trace_out); tracef(")\n");
+  }
+
+  size_t i, d = lp_upolynomial_degree(f);
+  upolynomial_dense_t f_d;
+  upolynomial_dense_construct_p(&f_d, d + 1, f);
+
+  // 2^(n*d)*f(x + a/2^n) = F(2^n*x + a), where F(y) = sum f_i 2^(n*(d - i)) y^i
+  if (c->n) {
+    for (i = 0; i < d; ++ i) {
+      integer_mul_pow2(lp_Z, f_d.coefficients + i, f_d.coefficients + i, c->n*(d - i));
+    }
+  }
+  upolynomial_dense_taylor_shift(&f_d, &c->a);
+  if (c->n) {
+    for (i = 1; i <= d; ++ i) {
+      integer_mul_pow2(lp_Z, f_d.coefficients + i, f_d.coefficients + i, c->n*i);
+    }
+  }
+
+  lp_upolynomial_t* result = upolynomial_dense_to_upolynomial(&f_d, f->K);
+  upolynomial_dense_destruct(&f_d);
+
+  if (trace_is_enabled("arithmetic")) {
+    tracef("upolynomial_taylor_shift("); lp_upolynomial_print(f, trace_out); tracef(", "); dyadic_rational_print(c, trace_out); tracef(") = "); lp_upolynomial_print(result, trace_out); tracef("\n");
+  }
+
+  return result;
+}
@@ -22,14 +22,21 @@
 #include <integer.h>
 #include "upolynomial/umonomial.h"
 
+/** Sturm sequences of the square-free factors (see root_finding.h) */
+typedef struct upolynomial_sturm_struct upolynomial_sturm_t;
+
 /**
- * A polynomial is the ring, number of monomials and the monomials.
+ * A polynomial is the ring, number of monomials and the monomials. Data that
+ * is expensive to compute (such as Sturm sequences for root counting) is
+ * cached with the polynomial and dropped if the polynomial changes.
  */
 struct lp_upolynomial_struct {
   /** The ring of coefficients */
   lp_int_ring_t* K;
   /** The number of monomials */
   size_t size;
+  /** Cached Sturm sequences (0 if not computed) */
+  upolynomial_sturm_t* sturm;
   /** The monomials */
   ulp_monomial_t monomials[];
 };
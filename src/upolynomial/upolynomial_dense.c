@@ -101,39 +101,93 @@ const lp_integer_t* upolynomial_dense_lead_coeff(const upolynomial_dense_t* p_d)
   return p_d->coefficients + p_d->size - 1;
 }
 
-void upolynomial_dense_evaluate_at_rational(const upolynomial_dense_t* p_d, const lp_rational_t* x, lp_rational_t* value) {
-  int i;
-  rational_assign_int(value, 0, 1);
-  for (i = p_d->size - 1; i >= 0; -- i) {
-    rational_mul(value, value, x);
-    rational_add_integer(value, value, p_d->coefficients + i);
+void upolynomial_dense_evaluate_homogeneous(const upolynomial_dense_t* p_d, const lp_integer_t* a, const lp_integer_t* b, const lp_integer_t* b_pow, lp_integer_t* value) {
+  assert(b || b_pow);
+
+  int i, d = p_d->size - 1;
+  lp_integer_t b_k;
+  if (!b_pow) {
+    integer_construct_copy(lp_Z, &b_k, b);
+  }
+
+  // value = (...(c_d*a + c_{d-1}*b)*a + ...)*a + c_0*b^d
+  integer_assign(lp_Z, value, p_d->coefficients + d);
+  for (i = d - 1; i >= 0; -- i) {
+    integer_mul(lp_Z, value, value, a);
+    if (integer_sgn(lp_Z, p_d->coefficients + i)) {
+      integer_add_mul(lp_Z, value, p_d->coefficients + i, b_pow ? b_pow + (d - i) : &b_k);
+    }
+    if (!b_pow && i > 0) {
+      integer_mul(lp_Z, &b_k, &b_k, b);
+    }
+  }
+
+  if (!b_pow) {
+    integer_destruct(&b_k);
   }
 }
 
-void upolynomial_dense_evaluate_at_dyadic_rational(const upolynomial_dense_t* p_d, const lp_dyadic_rational_t* x, lp_dyadic_rational_t* value) {
-  int i;
-  dyadic_rational_assign_int(value, 0, 0);
-  for (i = p_d->size - 1; i >= 0; -- i) {
-    dyadic_rational_mul(value, value, x);
-    dyadic_rational_add_integer(value, value, p_d->coefficients + i);
+void upolynomial_dense_evaluate_homogeneous_2exp(const upolynomial_dense_t* p_d, const lp_integer_t* a, unsigned long n, lp_integer_t* value) {
+  int i, d = p_d->size - 1;
+  lp_integer_t tmp;
+  integer_construct_from_int(lp_Z, &tmp, 0);
+
+  // value = (...(c_d*a + c_{d-1}*2^n)*a + ...)*a + c_0*2^(n*d)
+  integer_assign(lp_Z, value, p_d->coefficients + d);
+  for (i = d - 1; i >= 0; -- i) {
+    integer_mul(lp_Z, value, value, a);
+    if (integer_sgn(lp_Z, p_d->coefficients + i)) {
+      integer_mul_pow2(lp_Z, &tmp, p_d->coefficients + i, n*(d - i));
+      integer_add(lp_Z, value, value, &tmp);
+    }
   }
+
+  integer_destruct(&tmp);
+}
+
+void upolynomial_dense_evaluate_at_rational(const upolynomial_dense_t* p_d, const lp_rational_t* x, lp_rational_t* value) {
+  // p(a/b) = value/b^d
+  lp_integer_t num, den;
+  integer_construct_from_int(lp_Z, &num, 0);
+  integer_construct_from_int(lp_Z, &den, 0);
+  upolynomial_dense_evaluate_homogeneous(p_d, rational_get_num_ref(x), rational_get_den_ref(x), 0, &num);
+  integer_pow(lp_Z, &den, rational_get_den_ref(x), p_d->size - 1);
+  lp_rational_t result;
+  rational_construct_from_div(&result, &num, &den);
+  rational_swap(&result, value);
+  rational_destruct(&result);
+  integer_destruct(&num);
+  integer_destruct(&den);
+}
+
+void upolynomial_dense_evaluate_at_dyadic_rational(const upolynomial_dense_t* p_d, const lp_dyadic_rational_t* x, lp_dyadic_rational_t* value) {
+  // p(a/2^n) = value/2^(n*d)
+  lp_integer_t num;
+  integer_construct_from_int(lp_Z, &num, 0);
+  upolynomial_dense_evaluate_homogeneous_2exp(p_d, &x->a, x->n, &num);
+  lp_dyadic_rational_t result;
+  dyadic_rational_construct_from_integer(&result, &num);
+  dyadic_rational_div_2exp(value, &result, x->n*(p_d->size - 1));
+  dyadic_rational_destruct(&result);
+  integer_destruct(&num);
 }
 
 int upolynomial_dense_sgn_at_rational(const upolynomial_dense_t* p_d, const lp_rational_t* x) {
-  lp_rational_t value;
-  rational_construct(&value);
-  upolynomial_dense_evaluate_at_rational(p_d, x, &value);
-  int sgn = rational_sgn(&value);
-  rational_destruct(&value);
+  // Denominator is positive, so the sign is the sign of the homogeneous value
+  lp_integer_t value;
+  integer_construct_from_int(lp_Z, &value, 0);
+  upolynomial_dense_evaluate_homogeneous(p_d, rational_get_num_ref(x), rational_get_den_ref(x), 0, &value);
+  int sgn = integer_sgn(lp_Z, &value);
+  integer_destruct(&value);
   return sgn;
 }
 
 int upolynomial_dense_sgn_at_dyadic_rational(const upolynomial_dense_t* p_d, const lp_dyadic_rational_t* x) {
-  lp_dyadic_rational_t value;
-  dyadic_rational_construct(&value);
-  upolynomial_dense_evaluate_at_dyadic_rational(p_d, x, &value);
-  int sgn = dyadic_rational_sgn(&value);
-  dyadic_rational_destruct(&value);
+  lp_integer_t value;
+  integer_construct_from_int(lp_Z, &value, 0);
+  upolynomial_dense_evaluate_homogeneous_2exp(p_d, &x->a, x->n, &value);
+  int sgn = integer_sgn(lp_Z, &value);
+  integer_destruct(&value);
   return sgn;
 }
 
@@ -559,3 +613,343 @@ void upolynomial_dense_derivative(const lp_int_ring_t* K, const upolynomial_dens
     upolynomial_dense_normalize(p_d_prime, K);
   }
 }
+
+/** Polynomials with fewer coefficients are multiplied with the schoolbook method */
+#define UPOLYNOMIAL_DENSE_KARATSUBA_THRESHOLD 32
+
+static
+lp_integer_t* upolynomial_dense_array_new(size_t size) {
+  lp_integer_t* a = malloc(size*sizeof(lp_integer_t));
+  size_t i;
+  for (i = 0; i < size; ++ i) {
+    integer_construct_from_int(lp_Z, a + i, 0);
+  }
+  return a;
+}
+
+static
+void upolynomial_dense_array_delete(lp_integer_t* a, size_t size) {
+  size_t i;
+  for (i = 0; i < size; ++ i) {
+    integer_destruct(a + i);
+  }
+  free(a);
+}
+
+/**
+ * Karatsuba multiplication out += a*b, where a and b have n coefficients (and
+ * out has 2n - 1 coefficients). With a = a0 + x^h a1, b = b0 + x^h b1 we have
+ *
+ *   a*b = z0 + x^h (z1 - z0 - z2) + x^2h z2
+ *
+ * with z0 = a0*b0, z2 = a1*b1, and z1 = (a0 + a1)*(b0 + b1). The computation
+ * is done in Z, the caller reduces the result.
+ */
+static
+void upolynomial_dense_karatsuba(lp_integer_t* out, const lp_integer_t* a, const lp_integer_t* b, size_t n) {
+
+  size_t i, j;
+
+  if (n <= UPOLYNOMIAL_DENSE_KARATSUBA_THRESHOLD) {
+    for (i = 0; i < n; ++ i) {
+      if (integer_sgn(lp_Z, a + i)) {
+        for (j = 0; j < n; ++ j) {
+          integer_add_mul(lp_Z, out + i + j, a + i, b + j);
+        }
+      }
+    }
+    return;
+  }
+
+  // Split with h <= n1
+  size_t h = n / 2;
+  size_t n1 = n - h;
+
+  // Temporaries
+  size_t tmp_size = 2*n1 + (2*h - 1) + 2*(2*n1 - 1);
+  lp_integer_t* tmp = upolynomial_dense_array_new(tmp_size);
+  lp_integer_t* a_sum = tmp;
+  lp_integer_t* b_sum = a_sum + n1;
+  lp_integer_t* z0 = b_sum + n1;
+  lp_integer_t* z1 = z0 + 2*h - 1;
+  lp_integer_t* z2 = z1 + 2*n1 - 1;
+
+  for (i = 0; i < n1; ++ i) {
+    if (i < h) {
+      integer_add(lp_Z, a_sum + i, a + i, a + h + i);
+      integer_add(lp_Z, b_sum + i, b + i, b + h + i);
+    } else {
+      integer_assign(lp_Z, a_sum + i, a + h + i);
+      integer_assign(lp_Z, b_sum + i, b + h + i);
+    }
+  }
+
+  upolynomial_dense_karatsuba(z0, a, b, h);
+  upolynomial_dense_karatsuba(z2, a + h, b + h, n1);
+  upolynomial_dense_karatsuba(z1, a_sum, b_sum, n1);
+
+  for (i = 0; i < 2*h - 1; ++ i) {
+    integer_sub(lp_Z, z1 + i, z1 + i, z0 + i);
+    integer_add(lp_Z, out + i, out + i, z0 + i);
+  }
+  for (i = 0; i < 2*n1 - 1; ++ i) {
+    integer_sub(lp_Z, z1 + i, z1 + i, z2 + i);
+    integer_add(lp_Z, out + 2*h + i, out + 2*h + i, z2 + i);
+  }
+  for (i = 0; i < 2*n1 - 1; ++ i) {
+    integer_add(lp_Z, out + h + i, out + h + i, z1 + i);
+  }
+
+  upolynomial_dense_array_delete(tmp, tmp_size);
+}
+
+/** Polynomials with at least this many coefficients are multiplied with Kronecker substitution */
+#define UPOLYNOMIAL_DENSE_KRONECKER_THRESHOLD 64
+
+/** Computes out = sum a_i 2^(w*i) for i < n */
+static
+void upolynomial_dense_kronecker_pack(lp_integer_t* out, const lp_integer_t* a, size_t n, size_t w) {
+  if (n == 1) {
+    integer_assign(lp_Z, out, a);
+    return;
+  }
+  size_t h = n / 2;
+  lp_integer_t hi;
+  integer_construct_from_int(lp_Z, &hi, 0);
+  upolynomial_dense_kronecker_pack(out, a, h, w);
+  upolynomial_dense_kronecker_pack(&hi, a + h, n - h, w);
+  integer_mul_pow2(lp_Z, &hi, &hi, w*h);
+  integer_add(lp_Z, out, out, &hi);
+  integer_destruct(&hi);
+}
+
+/**
+ * Adds the n digits of v = sum c_i 2^(w*i) to out, where all |c_i| < 2^(w-1).
+ * The value v is destroyed.
+ */
+static
+void upolynomial_dense_kronecker_unpack_add(lp_integer_t* out, lp_integer_t* v, size_t n, size_t w) {
+  if (n == 1) {
+    integer_add(lp_Z, out, out, v);
+    return;
+  }
+  size_t h = n / 2;
+  // v = lo + 2^(w*h) hi, with lo in the symmetric range
+  lp_integer_t lo;
+  integer_construct_from_int(lp_Z, &lo, 0);
+  mpz_fdiv_r_2exp(&lo, v, w*h);
+  if (mpz_tstbit(&lo, w*h - 1)) {
+    lp_integer_t base;
+    integer_construct_from_int(lp_Z, &base, 0);
+    mpz_setbit(&base, w*h);
+    integer_sub(lp_Z, &lo, &lo, &base);
+    integer_destruct(&base);
+  }
+  integer_sub(lp_Z, v, v, &lo);
+  mpz_tdiv_q_2exp(v, v, w*h);
+  upolynomial_dense_kronecker_unpack_add(out, &lo, h, w);
+  upolynomial_dense_kronecker_unpack_add(out + h, v, n - h, w);
+  integer_destruct(&lo);
+}
+
+/** Maximal number of bits of the n coefficients of a */
+static
+size_t upolynomial_dense_array_max_bits(const lp_integer_t* a, size_t n) {
+  size_t i, bits = 0;
+  for (i = 0; i < n; ++ i) {
+    size_t a_bits = mpz_sizeinbase(a + i, 2);
+    if (a_bits > bits) {
+      bits = a_bits;
+    }
+  }
+  return bits;
+}
+
+/**
+ * Multiplication out += a*b with Kronecker substitution, i.e. we evaluate a
+ * and b at 2^w, multiply the two integers, and read the coefficients of the
+ * product from the digits in base 2^w. This relies on the fast
+ * multiplication of large integers in GMP.
+ */
+static
+void upolynomial_dense_kronecker(lp_integer_t* out, const lp_integer_t* a, size_t a_size, const lp_integer_t* b, size_t b_size) {
+  // All coefficients of a*b are smaller than 2^(w-1)
+  size_t w = upolynomial_dense_array_max_bits(a, a_size) + upolynomial_dense_array_max_bits(b, b_size) + 2;
+  size_t n = b_size;
+  while (n) {
+    w ++;
+    n >>= 1;
+  }
+  lp_integer_t A, B;
+  integer_construct_from_int(lp_Z, &A, 0);
+  integer_construct_from_int(lp_Z, &B, 0);
+  upolynomial_dense_kronecker_pack(&A, a, a_size, w);
+  upolynomial_dense_kronecker_pack(&B, b, b_size, w);
+  integer_mul(lp_Z, &A, &A, &B);
+  upolynomial_dense_kronecker_unpack_add(out, &A, a_size + b_size - 1, w);
+  integer_destruct(&A);
+  integer_destruct(&B);
+}
+
+void upolynomial_dense_mul_add_array(lp_integer_t* out, const lp_integer_t* a, size_t a_size, const lp_integer_t* b, size_t b_size) {
+
+  if (a_size < b_size) {
+    upolynomial_dense_mul_add_array(out, b, b_size, a, a_size);
+    return;
+  }
+
+  size_t i, j;
+
+  if (b_size <= UPOLYNOMIAL_DENSE_KARATSUBA_THRESHOLD) {
+    for (i = 0; i < a_size; ++ i) {
+      if (integer_sgn(lp_Z, a + i)) {
+        for (j = 0; j < b_size; ++ j) {
+          integer_add_mul(lp_Z, out + i + j, a + i, b + j);
+        }
+      }
+    }
+    return;
+  }
+
+  if (b_size >= UPOLYNOMIAL_DENSE_KRONECKER_THRESHOLD) {
+    upolynomial_dense_kronecker(out, a, a_size, b, b_size);
+    return;
+  }
+
+  // Multiply by chunks of a of the size of b
+  for (i = 0; i < a_size; i += b_size) {
+    size_t chunk_size = a_size - i < b_size ? a_size - i : b_size;
+    if (chunk_size == b_size) {
+      upolynomial_dense_karatsuba(out + i, a + i, b, b_size);
+    } else {
+      upolynomial_dense_mul_add_array(out + i, a + i, chunk_size, b, b_size);
+    }
+  }
+}
+
+/** Below this many coefficients the Taylor shift uses the quadratic scheme */
+#define UPOLYNOMIAL_DENSE_TAYLOR_SHIFT_DC_SIZE 512
+
+/**
+ * a(x) = a(x + c) in Z, where a has n coefficients, with the quadratic Horner
+ * scheme. If c is 0 the shift is by 1 and only uses additions.
+ */
+static
+void upolynomial_dense_taylor_shift_horner(lp_integer_t* a, size_t n, const lp_integer_t* c) {
+  size_t i, j;
+  for (i = n - 1; i > 0; -- i) {
+    for (j = i - 1; j + 1 < n; ++ j) {
+      if (c) {
+        integer_add_mul(lp_Z, a + j, c, a + j + 1);
+      } else {
+        integer_add(lp_Z, a + j, a + j, a + j + 1);
+      }
+    }
+  }
+}
+
+/** Returns (x + c)^(2^k) with 2^k + 1 coefficients, computed if not cached in pow */
+static
+const lp_integer_t* upolynomial_dense_taylor_shift_power(lp_integer_t** pow, size_t k, const lp_integer_t* c) {
+  if (!pow[k]) {
+    size_t j, m = ((size_t) 1) << k;
+    pow[k] = upolynomial_dense_array_new(m + 1);
+    // Coefficient j is binomial(m, j)*c^(m - j)
+    lp_integer_t c_pow;
+    integer_construct_from_int(lp_Z, &c_pow, 1);
+    for (j = m + 1; j > 0; -- j) {
+      mpz_bin_uiui(pow[k] + j - 1, m, j - 1);
+      if (c) {
+        integer_mul(lp_Z, pow[k] + j - 1, pow[k] + j - 1, &c_pow);
+        integer_mul(lp_Z, &c_pow, &c_pow, c);
+      }
+    }
+    integer_destruct(&c_pow);
+  }
+  return pow[k];
+}
+
+/**
+ * a(x) = a(x + c) in Z, where a has n coefficients. With a = a_0 + x^m a_1 we
+ * have a(x + c) = a_0(x + c) + (x + c)^m a_1(x + c), where m is a power of 2
+ * so that the powers (x + c)^m are shared among the recursive calls. The
+ * products use Karatsuba multiplication.
+ */
+static
+void upolynomial_dense_taylor_shift_dc(lp_integer_t* a, size_t n, const lp_integer_t* c, lp_integer_t** pow) {
+
+  if (n <= UPOLYNOMIAL_DENSE_TAYLOR_SHIFT_DC_SIZE) {
+    upolynomial_dense_taylor_shift_horner(a, n, c);
+    return;
+  }
+
+  // Largest m = 2^k < n
+  size_t k = 0, m = 1;
+  while (2*m < n) {
+    m *= 2;
+    k ++;
+  }
+
+  upolynomial_dense_taylor_shift_dc(a, m, c, pow);
+  upolynomial_dense_taylor_shift_dc(a + m, n - m, c, pow);
+
+  // a = a_0 + (x + c)^m a_1
+  lp_integer_t* tmp = upolynomial_dense_array_new(n);
+  upolynomial_dense_mul_add_array(tmp, a + m, n - m, upolynomial_dense_taylor_shift_power(pow, k, c), m + 1);
+  size_t i;
+  for (i = 0; i < m; ++ i) {
+    integer_add(lp_Z, a + i, a + i, tmp + i);
+  }
+  for (i = m; i < n; ++ i) {
+    integer_swap(a + i, tmp + i);
+  }
+  upolynomial_dense_array_delete(tmp, n);
+}
+
+void upolynomial_dense_taylor_shift(upolynomial_dense_t* p_d, const lp_integer_t* c) {
+
+  if (integer_sgn(lp_Z, c) == 0 || p_d->size == 1) {
+    return;
+  }
+
+  size_t i, n = p_d->size;
+  lp_integer_t* a = p_d->coefficients;
+
+  // If c = +/-2^k, we shift p(c*x) by 1 and scale back, using only additions
+  unsigned long k = mpz_scan1(c, 0);
+  int c_is_pow2 = mpz_sizeinbase(c, 2) == k + 1;
+  int c_sgn = integer_sgn(lp_Z, c);
+
+  if (c_is_pow2) {
+    for (i = 1; i < n; ++ i) {
+      integer_mul_pow2(lp_Z, a + i, a + i, k*i);
+      if (c_sgn < 0 && (i % 2)) {
+        integer_neg(lp_Z, a + i, a + i);
+      }
+    }
+  }
+
+  const lp_integer_t* shift = c_is_pow2 ? 0 : c;
+  if (n <= UPOLYNOMIAL_DENSE_TAYLOR_SHIFT_DC_SIZE) {
+    upolynomial_dense_taylor_shift_horner(a, n, shift);
+  } else {
+    lp_integer_t* pow[sizeof(size_t)*8] = { 0 };
+    upolynomial_dense_taylor_shift_dc(a, n, shift, pow);
+    for (k = 0; k < sizeof(size_t)*8; ++ k) {
+      if (pow[k]) {
+        upolynomial_dense_array_delete(pow[k], (((size_t) 1) << k) + 1);
+      }
+    }
+  }
+
+  if (c_is_pow2) {
+    k = mpz_scan1(c, 0);
+    for (i = 1; i < n; ++ i) {
+      assert(mpz_scan1(a + i, 0) >= k*i || integer_sgn(lp_Z, a + i) == 0);
+      mpz_tdiv_q_2exp(a + i, a + i, k*i);
+      if (c_sgn < 0 && (i % 2)) {
+        integer_neg(lp_Z, a + i, a + i);
+      }
+    }
+  }
+}
@@ -84,6 +84,22 @@ int upolynomial_dense_is_zero(const upolynomial_dense_t* p_d);
  */
 const lp_integer_t* upolynomial_dense_lead_coeff(const upolynomial_dense_t* p_d);
 
+/**
+ * Evaluate the homogenized polynomial b^d*p(a/b) in the integers, with d the
+ * degree of p_d and b positive. If b_pow is not 0, it should contain the
+ * powers b^0, ..., b^d, so that they can be shared among evaluations at points
+ * with the same denominator. Otherwise b is used.
+ */
+void upolynomial_dense_evaluate_homogeneous(const upolynomial_dense_t* p_d, const lp_integer_t* a,
+    const lp_integer_t* b, const lp_integer_t* b_pow, lp_integer_t* value);
+
+/**
+ * Evaluate the homogenized polynomial 2^(n*d)*p(a/2^n) in the integers, with
+ * d the degree of p_d.
+ */
+void upolynomial_dense_evaluate_homogeneous_2exp(const upolynomial_dense_t* p_d, const lp_integer_t* a,
+    unsigned long n, lp_integer_t* value);
+
 /**
  * Evaluate the polynomial at a rational point.
  */
@@ -205,3 +221,19 @@ void upolynomial_dense_reduce_Z(const upolynomial_dense_t* p_d, const upolynomia
  */
 void upolynomial_dense_derivative(const lp_int_ring_t* K, const upolynomial_dense_t* p_d,
     upolynomial_dense_t* p_d_prime);
+
+/**
+ * out += a*b in Z, where a has a_size and b has b_size coefficients (and out
+ * has a_size + b_size - 1 coefficients). Uses Karatsuba multiplication or
+ * Kronecker substitution for large inputs. The caller reduces the result if
+ * needed.
+ */
+void upolynomial_dense_mul_add_array(lp_integer_t* out, const lp_integer_t* a, size_t a_size,
+    const lp_integer_t* b, size_t b_size);
+
+/**
+ * Taylor shift p_d(x) = p_d(x + c) in Z[x]. Shifts by +/-2^k use only
+ * additions, and large degrees use a divide-and-conquer scheme with fast
+ * multiplication. The caller reduces the result if needed.
+ */
+void upolynomial_dense_taylor_shift(upolynomial_dense_t* p_d, const lp_integer_t* c);
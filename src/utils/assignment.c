@@ -22,6 +22,7 @@
 #include <value.h>
 #include <interval.h>
 
+#include "utils/assignment.h"
 #include "polynomial/polynomial.h"
 #include "number/value.h"
 
@@ -29,13 +30,21 @@
 
 #define DEFAULT_ASSIGNMENT_SIZE 100
 
+/**
+ * Ids of the assignments, so that cached results can't be confused. Threads
+ * construct their own assignments, so the counter is incremented atomically.
+ */
+static size_t assignment_next_id = 0;
+
 static
 void lp_assignment_ensure_size(lp_assignment_t* m, size_t size) {
   if (size > m->size) {
     m->values = realloc(m->values, sizeof(lp_value_t)*size);
+    m->timestamps = realloc(m->timestamps, sizeof(size_t)*size);
     size_t i;
     for (i = m->size; i < size; ++ i) {
       lp_value_construct(m->values + i, LP_VALUE_NONE, 0);
+      m->timestamps[i] = 0;
     }
     m->size = size;
   }
@@ -44,6 +53,15 @@ void lp_assignment_ensure_size(lp_assignment_t* m, size_t size) {
 void lp_assignment_construct(lp_assignment_t* m, const lp_variable_db_t* var_db) {
   m->size = 0;
   m->values = 0;
+  m->timestamps = 0;
+  m->timestamp = 0;
+  m->id = __atomic_add_fetch(&assignment_next_id, 1, __ATOMIC_RELAXED);
+  m->trail = 0;
+  m->trail_size = 0;
+  m->trail_capacity = 0;
+  m->scopes = 0;
+  m->scopes_size = 0;
+  m->scopes_capacity = 0;
   m->var_db = var_db;
   lp_variable_db_attach((lp_variable_db_t*)var_db);
   lp_assignment_ensure_size(m, DEFAULT_ASSIGNMENT_SIZE);
@@ -62,7 +80,14 @@ void lp_assignment_destruct(lp_assignment_t* m) {
       lp_value_destruct(m->values + i);
     }
     free(m->values);
+    free(m->timestamps);
+  }
+  size_t i;
+  for (i = 0; i < m->trail_size; ++ i) {
+    lp_value_destruct(&m->trail[i].value);
   }
+  free(m->trail);
+  free(m->scopes);
   lp_variable_db_detach((lp_variable_db_t*)m->var_db);
 }
 
@@ -96,21 +121,94 @@ char* lp_assignment_to_string(const lp_assignment_t* m) {
   return str;
 }
 
+/**
+ * Make the value of x ready to be overwritten. If there are open scopes, the
+ * current value is moved to the trail, otherwise it is destructed. Either way,
+ * the value of x is left to be constructed again.
+ */
+static
+void lp_assignment_save_value(lp_assignment_t* m, lp_variable_t x) {
+  if (m->scopes_size) {
+    if (m->trail_size == m->trail_capacity) {
+      m->trail_capacity = m->trail_capacity ? 2*m->trail_capacity : DEFAULT_ASSIGNMENT_SIZE;
+      m->trail = realloc(m->trail, sizeof(lp_assignment_trail_entry_t)*m->trail_capacity);
+    }
+    lp_assignment_trail_entry_t* entry = m->trail + m->trail_size ++;
+    entry->x = x;
+    entry->value = m->values[x];
+  } else {
+    lp_value_destruct(m->values + x);
+  }
+}
+
 void lp_assignment_set_value(lp_assignment_t* m, lp_variable_t x, const lp_value_t* value) {
   if (value) {
     lp_assignment_ensure_size(m, x + 1);
-    lp_value_destruct(m->values + x);
+    lp_assignment_save_value(m, x);
     lp_value_construct_copy(m->values + x, value);
+    // Values in the assignment are used directly, so they can't be lazy
+    if (value->type == LP_VALUE_ALGEBRAIC) {
+      lp_algebraic_number_force(&m->values[x].value.a);
+    }
+    m->timestamps[x] = ++ m->timestamp;
   } else {
     if (m->size > x) {
       if ((m->values + x)->type != LP_VALUE_NONE) {
-        lp_value_destruct(m->values + x);
+        lp_assignment_save_value(m, x);
         lp_value_construct(m->values + x, LP_VALUE_NONE, 0);
+        m->timestamps[x] = ++ m->timestamp;
       }
     }
   }
 }
 
+void assignment_swap_value(lp_assignment_t* m, lp_variable_t x, lp_value_t* value) {
+  lp_assignment_ensure_size(m, x + 1);
+  lp_value_swap(m->values + x, value);
+  if (m->values[x].type == LP_VALUE_ALGEBRAIC) {
+    lp_algebraic_number_force(&m->values[x].value.a);
+  }
+  m->timestamps[x] = ++ m->timestamp;
+}
+
+void lp_assignment_push(lp_assignment_t* m) {
+  if (m->scopes_size == m->scopes_capacity) {
+    m->scopes_capacity = m->scopes_capacity ? 2*m->scopes_capacity : 10;
+    m->scopes = realloc(m->scopes, sizeof(size_t)*m->scopes_capacity);
+  }
+  m->scopes[m->scopes_size ++] = m->trail_size;
+}
+
+void lp_assignment_pop(lp_assignment_t* m) {
+  assert(m->scopes_size > 0);
+  size_t scope_start = m->scopes[-- m->scopes_size];
+  // Undo in reverse order, so the value from before the scope comes back last.
+  // Restored variables get a new timestamp, as cached results from inside the
+  // scope are not valid anymore.
+  while (m->trail_size > scope_start) {
+    lp_assignment_trail_entry_t* entry = m->trail + -- m->trail_size;
+    lp_value_destruct(m->values + entry->x);
+    m->values[entry->x] = entry->value;
+    m->timestamps[entry->x] = ++ m->timestamp;
+  }
+}
+
+size_t lp_assignment_scope_level(const lp_assignment_t* m) {
+  return m->scopes_size;
+}
+
+size_t lp_assignment_get_timestamp(const lp_assignment_t* m, lp_variable_t x) {
+  if (x < m->size) {
+    return m->timestamps[x];
+  } else {
+    return 0;
+  }
+}
+
+size_t lp_assignment_get_version(const lp_assignment_t* m) {
+  return m->timestamp;
+}
+
 const lp_value_t* lp_assignment_get_value(const lp_assignment_t* m, lp_variable_t x) {
   if (x < m->size) {
     return m->values + x;
@@ -149,6 +247,7 @@ void lp_interval_assignment_construct(lp_interval_assignment_t* m, const lp_vari
   m->intervals = 0;
   m->var_db = var_db;
   m->timestamp = 1;
+  m->clock = 1;
   m->timestamps = 0;
   lp_variable_db_attach((lp_variable_db_t*)var_db);
   lp_interval_assignment_ensure_size(m, DEFAULT_ASSIGNMENT_SIZE);
@@ -181,7 +280,7 @@ int lp_interval_assignment_print(const lp_interval_assignment_t* m, FILE* out) {
   size_t i, j, ret = 0;
   ret += fprintf(out, "[");
   for (i = 0, j = 0; i < m->size; ++ i) {
-    if (m->timestamps[i] < m->timestamp) {
+    if (m->timestamps[i] <= m->timestamp) {
       continue;
     }
     if (j ++) {
@@ -211,20 +310,32 @@ void lp_interval_assignment_set_interval(lp_interval_assignment_t* m, lp_variabl
   } else {
     lp_interval_construct_full(m->intervals + x);
   }
-  m->timestamps[x] = m->timestamp;
+  m->timestamps[x] = ++ m->clock;
 }
 
 const lp_interval_t* lp_interval_assignment_get_interval(const lp_interval_assignment_t* m, lp_variable_t x) {
   if (x >= m->size) {
     return lp_interval_full();
   }
-  if (m->timestamps[x] == m->timestamp) {
+  if (m->timestamps[x] > m->timestamp) {
     return m->intervals + x;
   } else {
     return lp_interval_full();
   }
 }
 
+size_t lp_interval_assignment_get_timestamp(const lp_interval_assignment_t* m, lp_variable_t x) {
+  if (x < m->size && m->timestamps[x] > m->timestamp) {
+    return m->timestamps[x];
+  }
+  // Full since the last reset
+  return m->timestamp;
+}
+
+size_t lp_interval_assignment_get_clock(const lp_interval_assignment_t* m) {
+  return m->clock;
+}
+
 void lp_interval_assignment_reset(lp_interval_assignment_t* m) {
-  m->timestamp ++;
+  m->timestamp = ++ m->clock;
 }
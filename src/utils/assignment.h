@@ -0,0 +1,30 @@
+/**
+ * Copyright 2015, SRI International.
+ *
+ * This file is part of LibPoly.
+ *
+ * LibPoly is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LibPoly is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with LibPoly.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <assignment.h>
+
+/**
+ * Swap the value of x in m with the given value, without going through the
+ * trail. This is for temporary changes that are undone by swapping again,
+ * i.e. by queries that take the assignment as const. The variable still gets
+ * a new timestamp, so results cached with the temporary value are not reused.
+ */
+void assignment_swap_value(lp_assignment_t* m, lp_variable_t x, lp_value_t* value);
@@ -21,11 +21,12 @@
 
 #include <string.h>
 #include <stdlib.h>
+#include <assert.h>
 
 
 #ifdef LIBPOLY_STATISTICS
 
-#define INITIAL_STATS 100
+#define INITIAL_STATS 256
 
 typedef struct int_stats_struct {
   size_t count;
@@ -38,6 +39,7 @@ static
 int_stats_t int_stats;
 
 int* stats_register_int(const char* name) {
+  assert(int_stats.count < INITIAL_STATS);
   size_t i = int_stats.count ++;
   int_stats.values[i] = 0;
   int_stats.names[i] = strdup(name);
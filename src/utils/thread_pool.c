@@ -0,0 +1,181 @@
+/**
+ * Copyright 2015, SRI International.
+ *
+ * This file is part of LibPoly.
+ *
+ * LibPoly is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LibPoly is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with LibPoly.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/thread_pool.h"
+
+#include <stdlib.h>
+
+#ifdef LIBPOLY_THREADS
+#include <pthread.h>
+#endif
+
+size_t thread_pool_threads = 1;
+
+void thread_pool_set_threads(size_t threads) {
+  thread_pool_threads = threads ? threads : 1;
+}
+
+#ifdef LIBPOLY_THREADS
+
+/** Range of jobs [begin, end) owned by a thread */
+typedef struct {
+  pthread_mutex_t lock;
+  size_t begin;
+  size_t end;
+} thread_pool_range_t;
+
+typedef struct {
+  /** The ranges, one per thread */
+  thread_pool_range_t* ranges;
+  /** Number of threads */
+  size_t threads;
+  /** The job function */
+  thread_pool_job_f job;
+  /** The job data */
+  void* data;
+} thread_pool_t;
+
+typedef struct {
+  thread_pool_t* pool;
+  size_t id;
+} thread_pool_worker_t;
+
+/** Take the next job from own range, returns 0 if none */
+static
+int thread_pool_pop(thread_pool_range_t* range, size_t* job) {
+  int result = 0;
+  pthread_mutex_lock(&range->lock);
+  if (range->begin < range->end) {
+    *job = range->begin ++;
+    result = 1;
+  }
+  pthread_mutex_unlock(&range->lock);
+  return result;
+}
+
+/** Steal the upper half of some other range into own range, returns 0 if all empty */
+static
+int thread_pool_steal(thread_pool_t* pool, size_t id) {
+  size_t k;
+  for (k = 1; k < pool->threads; ++ k) {
+    thread_pool_range_t* victim = pool->ranges + (id + k) % pool->threads;
+    size_t begin = 0, end = 0;
+    pthread_mutex_lock(&victim->lock);
+    if (victim->begin < victim->end) {
+      begin = victim->begin + (victim->end - victim->begin) / 2;
+      end = victim->end;
+      victim->end = begin;
+    }
+    pthread_mutex_unlock(&victim->lock);
+    if (begin < end) {
+      thread_pool_range_t* own = pool->ranges + id;
+      pthread_mutex_lock(&own->lock);
+      own->begin = begin;
+      own->end = end;
+      pthread_mutex_unlock(&own->lock);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static
+void* thread_pool_worker(void* arg) {
+  thread_pool_worker_t* worker = (thread_pool_worker_t*) arg;
+  thread_pool_t* pool = worker->pool;
+  size_t job;
+  for (;;) {
+    while (thread_pool_pop(pool->ranges + worker->id, &job)) {
+      pool->job(job, worker->id, pool->data);
+    }
+    // Jobs are never added, so if nothing to steal we're done
+    if (!thread_pool_steal(pool, worker->id)) {
+      break;
+    }
+  }
+  return 0;
+}
+
+void thread_pool_run(size_t jobs, thread_pool_job_f job, void* data) {
+
+  size_t threads = thread_pool_threads;
+  if (threads > jobs) {
+    threads = jobs;
+  }
+
+  size_t i;
+  if (threads <= 1) {
+    for (i = 0; i < jobs; ++ i) {
+      job(i, 0, data);
+    }
+    return;
+  }
+
+  thread_pool_t pool;
+  pool.ranges = malloc(sizeof(thread_pool_range_t)*threads);
+  pool.threads = threads;
+  pool.job = job;
+  pool.data = data;
+
+  // Split the jobs evenly
+  for (i = 0; i < threads; ++ i) {
+    pthread_mutex_init(&pool.ranges[i].lock, 0);
+    pool.ranges[i].begin = jobs * i / threads;
+    pool.ranges[i].end = jobs * (i + 1) / threads;
+  }
+
+  // Start the workers, the calling thread is worker 0. If a thread can't be
+  // created its jobs will be stolen by the others (worker 0 only stops once
+  // all ranges are empty).
+  thread_pool_worker_t* workers = malloc(sizeof(thread_pool_worker_t)*threads);
+  pthread_t* pthreads = malloc(sizeof(pthread_t)*threads);
+  int* started = calloc(threads, sizeof(int));
+  for (i = 0; i < threads; ++ i) {
+    workers[i].pool = &pool;
+    workers[i].id = i;
+  }
+  for (i = 1; i < threads; ++ i) {
+    started[i] = pthread_create(pthreads + i, 0, thread_pool_worker, workers + i) == 0;
+  }
+  thread_pool_worker(workers);
+  for (i = 1; i < threads; ++ i) {
+    if (started[i]) {
+      pthread_join(pthreads[i], 0);
+    }
+  }
+
+  for (i = 0; i < threads; ++ i) {
+    pthread_mutex_destroy(&pool.ranges[i].lock);
+  }
+  free(started);
+  free(pthreads);
+  free(workers);
+  free(pool.ranges);
+}
+
+#else
+
+void thread_pool_run(size_t jobs, thread_pool_job_f job, void* data) {
+  size_t i;
+  for (i = 0; i < jobs; ++ i) {
+    job(i, 0, data);
+  }
+}
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * Copyright 2015, SRI International.
+ *
+ * This file is part of LibPoly.
+ *
+ * LibPoly is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LibPoly is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with LibPoly.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * A job of the pool, gets the job index, the index of the thread running it
+ * (0 is the calling thread) and the user data.
+ */
+typedef void (*thread_pool_job_f)(size_t job, size_t thread, void* data);
+
+/** Number of threads to use (default 1) */
+extern
+size_t thread_pool_threads;
+
+/** Set the number of threads to use (0 is treated as 1) */
+void thread_pool_set_threads(size_t threads);
+
+/**
+ * Run the jobs 0, ..., jobs-1 using thread_pool_threads threads (including
+ * the calling thread) and wait for all of them to finish. Each thread starts
+ * with a contiguous range of jobs and, once it runs out, steals half of the
+ * remaining range of another thread. Jobs must be independent: they can read
+ * shared data, but must only write to their own output, or to per-thread
+ * scratch data (the thread index is below thread_pool_threads).
+ *
+ * Without thread support (LIBPOLY_THREADS undefined) the jobs are run in
+ * order in the calling thread.
+ */
+void thread_pool_run(size_t jobs, thread_pool_job_f job, void* data);
@@ -21,6 +21,7 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <variable_order.h>
+#include "variable/variable_order.h"
 
 #define INITIAL_LIST_SIZE 100
 #define INITIAL_MAP_SIZE 100
@@ -123,7 +124,7 @@ const lp_variable_order_t* lp_variable_list_cmp_order = 0;
 int lp_variable_list_cmp(const void* x, const void* y) {
   lp_variable_t x_var = *(lp_variable_t*)x;
   lp_variable_t y_var = *(lp_variable_t*)y;
-  return lp_variable_order_cmp(lp_variable_list_cmp_order, x_var, y_var);
+  return variable_order_cmp(lp_variable_list_cmp_order, x_var, y_var);
 }
 
 void lp_variable_list_order(lp_variable_list_t* list, const lp_variable_order_t* order) {
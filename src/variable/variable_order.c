@@ -28,20 +28,38 @@
 
 #include "utils/open_memstream.h"
 
-/**
- * A simple variable order that orders variable based on a given list, and
- * order the rest of the variables based on their variable id.
- */
-struct lp_variable_order_struct {
-  /** Reference count */
-  size_t ref_count;
-  /** The actual order */
-  lp_variable_list_t list;
-  /** Special top variable */
-  lp_variable_t top;
-  /** Special bottom variable */
-  lp_variable_t bot;
-};
+#define INITIAL_RANK_SIZE 100
+
+/** Recompute the rank of x from the list and the special variables */
+static
+void lp_variable_order_update_rank(lp_variable_order_t* var_order, lp_variable_t x) {
+  if (x == lp_variable_null) {
+    return;
+  }
+  if (x >= var_order->rank_size) {
+    size_t i, size = var_order->rank_size ? var_order->rank_size : INITIAL_RANK_SIZE;
+    while (size <= x) {
+      size *= 2;
+    }
+    var_order->rank = realloc(var_order->rank, sizeof(size_t)*size);
+    for (i = var_order->rank_size; i < size; ++ i) {
+      var_order->rank[i] = VARIABLE_ORDER_RANK_REST + i;
+    }
+    var_order->rank_size = size;
+  }
+  if (x == var_order->bot) {
+    var_order->rank[x] = VARIABLE_ORDER_RANK_BOT;
+  } else if (x == var_order->top) {
+    var_order->rank[x] = VARIABLE_ORDER_RANK_TOP;
+  } else {
+    int index = lp_variable_list_index(&var_order->list, x);
+    if (index == -1) {
+      var_order->rank[x] = VARIABLE_ORDER_RANK_REST + x;
+    } else {
+      var_order->rank[x] = VARIABLE_ORDER_RANK_LIST + index;
+    }
+  }
+}
 
 void lp_variable_order_construct(lp_variable_order_t* var_order) {
   // No-one pointing yet
@@ -50,9 +68,13 @@ void lp_variable_order_construct(lp_variable_order_t* var_order) {
   lp_variable_list_construct(&var_order->list);
   var_order->bot = lp_variable_null;
   var_order->top = lp_variable_null;
+  var_order->epoch = 1;
+  var_order->rank = 0;
+  var_order->rank_size = 0;
 }
 
 void lp_variable_order_reverse(lp_variable_order_t* var_order) {
+  var_order->epoch ++;
   size_t size = var_order->list.list_size;
   if (size > 1) {
     size_t first, last;
@@ -62,11 +84,20 @@ void lp_variable_order_reverse(lp_variable_order_t* var_order) {
       vars[first] = vars[last];
       vars[last] = tmp;
     }
+    // Update the indices and the ranks
+    size_t i;
+    for (i = 0; i < size; ++ i) {
+      if (vars[i] != lp_variable_null) {
+        var_order->list.var_to_index_map[vars[i]] = i;
+        lp_variable_order_update_rank(var_order, vars[i]);
+      }
+    }
   }
 }
 
 void lp_variable_order_destruct(lp_variable_order_t* var_order) {
   lp_variable_list_destruct(&var_order->list);
+  free(var_order->rank);
 }
 
 void lp_variable_order_attach(lp_variable_order_t* var_order) {
@@ -92,38 +123,7 @@ lp_variable_order_t* lp_variable_order_new(void) {
 }
 
 int lp_variable_order_cmp(const lp_variable_order_t* var_order, lp_variable_t x, lp_variable_t y) {
-  const lp_variable_order_t* self = (lp_variable_order_t*) var_order;
-
-  if (x == y) {
-    return 0;
-  }
-
-  // if bot is smaller than anything
-  if (x == var_order->bot) { return -1; }
-  if (y == var_order->bot) { return 1;  }
-  if (x == var_order->top) { return 1;  }
-  if (y == var_order->top) { return -1; }
-
-  // Compare indices
-  int x_index = lp_variable_list_index(&self->list, x);
-  int y_index = lp_variable_list_index(&self->list, y);
-
-  int cmp = 0;
-  if (x_index == y_index) {
-    // Indices same, just compare the variables
-    cmp = ((int) x) - ((int) y);
-  } else {
-    // If a variable doesn't have an index, it's bigger
-    if (x_index == -1) {
-      cmp = 1;
-    } else if (y_index == -1) {
-      cmp = -1;
-    } else {
-      cmp = x_index - y_index;
-    }
-  }
-
-  return cmp;
+  return variable_order_cmp(var_order, x, y);
 }
 
 size_t lp_variable_order_size(const lp_variable_order_t* var_order) {
@@ -132,16 +132,21 @@ size_t lp_variable_order_size(const lp_variable_order_t* var_order) {
 
 void lp_variable_order_clear(lp_variable_order_t* var_order) {
   while (lp_variable_list_size(&var_order->list)) {
-    lp_variable_list_pop(&var_order->list);
+    lp_variable_order_pop(var_order);
   }
 }
 
 void lp_variable_order_push(lp_variable_order_t* var_order, lp_variable_t var) {
+  var_order->epoch ++;
   lp_variable_list_push(&var_order->list, var);
+  lp_variable_order_update_rank(var_order, var);
 }
 
 void lp_variable_order_pop(lp_variable_order_t* var_order) {
+  var_order->epoch ++;
+  lp_variable_t var = lp_variable_list_top(&var_order->list);
   lp_variable_list_pop(&var_order->list);
+  lp_variable_order_update_rank(var_order, var);
 }
 
 lp_variable_t lp_variable_order_top(const lp_variable_order_t* var_order) {
@@ -177,12 +182,22 @@ int lp_variable_order_contains(lp_variable_order_t* var_order, lp_variable_t x)
 
 void lp_variable_order_make_top(lp_variable_order_t* var_order, lp_variable_t var) {
   assert(var_order->top == lp_variable_null || var == lp_variable_null);
+  lp_variable_t old_top = var_order->top;
   var_order->top = var;
+  var_order->epoch ++;
+  lp_variable_order_update_rank(var_order, var == lp_variable_null ? old_top : var);
 }
 
 void lp_variable_order_make_bot(lp_variable_order_t* var_order, lp_variable_t var) {
   assert(var_order->bot == lp_variable_null || var == lp_variable_null);
+  lp_variable_t old_bot = var_order->bot;
   var_order->bot = var;
+  var_order->epoch ++;
+  lp_variable_order_update_rank(var_order, var == lp_variable_null ? old_bot : var);
+}
+
+size_t lp_variable_order_get_epoch(const lp_variable_order_t* var_order) {
+  return var_order->epoch;
 }
 
 const lp_variable_list_t* lp_variable_order_get_list(const lp_variable_order_t* var_order) {
@@ -20,6 +20,53 @@
 #pragma once
 
 #include <poly.h>
+#include <variable_list.h>
+
+#include <limits.h>
+
+/**
+ * A simple variable order that orders variable based on a given list, and
+ * order the rest of the variables based on their variable id.
+ */
+struct lp_variable_order_struct {
+  /** Reference count */
+  size_t ref_count;
+  /** The actual order */
+  lp_variable_list_t list;
+  /** Special top variable */
+  lp_variable_t top;
+  /** Special bottom variable */
+  lp_variable_t bot;
+  /** Modification epoch, incremented on every change of the order */
+  size_t epoch;
+  /** Rank of each variable, variables compare as their ranks */
+  size_t* rank;
+  /** Size of the rank array */
+  size_t rank_size;
+};
+
+/** Rank of the bottom variable */
+#define VARIABLE_ORDER_RANK_BOT ((size_t) 0)
+/** Ranks of the variables in the list start here, in the list order */
+#define VARIABLE_ORDER_RANK_LIST ((size_t) 1)
+/** Ranks of the variables not in the list start here, by variable id */
+#define VARIABLE_ORDER_RANK_REST ((size_t) INT_MAX + 1)
+/** Rank of the top variable */
+#define VARIABLE_ORDER_RANK_TOP ((size_t) -1)
+
+/** Get the rank of the variable (variables beyond the array are not listed) */
+static inline
+size_t variable_order_rank(const lp_variable_order_t* var_order, lp_variable_t x) {
+  return x < var_order->rank_size ? var_order->rank[x] : VARIABLE_ORDER_RANK_REST + x;
+}
+
+/** Compare two variables in the order, same as lp_variable_order_cmp() */
+static inline
+int variable_order_cmp(const lp_variable_order_t* var_order, lp_variable_t x, lp_variable_t y) {
+  size_t x_rank = variable_order_rank(var_order, x);
+  size_t y_rank = variable_order_rank(var_order, y);
+  return (x_rank > y_rank) - (x_rank < y_rank);
+}
 
 /** Make a variable the top variable (bigger than anything) */
 void lp_variable_order_make_top(lp_variable_order_t* var_order, lp_variable_t var);
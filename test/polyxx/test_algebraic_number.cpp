@@ -46,6 +46,105 @@ TEST_CASE("algebraic_number::to_rational_approximation") {
   CHECK(r2 < Rational(2));
 }
 
+TEST_CASE("algebraic_number::refine") {
+  for (auto refinement : {LP_ALGEBRAIC_NUMBER_REFINE_BISECTION,
+                          LP_ALGEBRAIC_NUMBER_REFINE_QIR}) {
+    lp_algebraic_number_set_refinement(refinement);
+    AlgebraicNumber a(UPolynomial({-2, 0, 1}), DyadicInterval(1, 2));
+    for (int i = 0; i < 6; ++i) refine(a);
+    int size = lp_dyadic_interval_size(&a.get_internal()->I);
+    if (refinement == LP_ALGEBRAIC_NUMBER_REFINE_QIR) {
+      CHECK(size < -20);
+    } else {
+      CHECK(size > -10);
+    }
+    CHECK(to_double(a) == doctest::Approx(1.4142135623730951));
+    AlgebraicNumber b(UPolynomial({-1, -1, 0, 1}), DyadicInterval(1, 2));
+    CHECK(to_double(b) == doctest::Approx(1.3247179572447460));
+    CHECK(b < a);
+    AlgebraicNumber c(UPolynomial({-2, 0, 1}), DyadicInterval(0, 2));
+    CHECK(a == c);
+  }
+  lp_algebraic_number_set_refinement(LP_ALGEBRAIC_NUMBER_REFINE_QIR);
+}
+
+TEST_CASE("algebraic_number::refine_qir_precision") {
+  // Each successful step squares N, so the bits gained keep growing
+  AlgebraicNumber a(UPolynomial({-2, 0, 1}), DyadicInterval(1, 2));
+  int size = lp_dyadic_interval_size(&a.get_internal()->I);
+  int gain = 0;
+  for (int i = 0; i < 6; ++i) {
+    refine(a);
+    int new_size = lp_dyadic_interval_size(&a.get_internal()->I);
+    CHECK(size - new_size > gain);
+    gain = size - new_size;
+    size = new_size;
+  }
+  CHECK(gain > 100);
+  CHECK(to_double(a) == doctest::Approx(1.4142135623730951));
+}
+
+TEST_CASE("algebraic_number::lazy") {
+  AlgebraicNumber sqrt2(UPolynomial({-2, 0, 1}), DyadicInterval(1, 2));
+  AlgebraicNumber sqrt3(UPolynomial({-3, 0, 1}), DyadicInterval(1, 2));
+  AlgebraicNumber a = sqrt2 * sqrt3 + sqrt2;
+  CHECK(lp_algebraic_number_is_lazy(a.get_internal()));
+  CHECK(to_double(a) == doctest::Approx(3.8637033051562732));
+  CHECK(a > Integer(3));
+  CHECK(a < sqrt3 + sqrt3 + AlgebraicNumber(DyadicRational(1, 1)));
+  CHECK(lp_algebraic_number_is_lazy(a.get_internal()));
+  // Can't be decided with intervals, so the value is computed
+  AlgebraicNumber zero = sqrt2 * sqrt2 - AlgebraicNumber(DyadicRational(2));
+  CHECK(zero == Integer(0));
+  CHECK_FALSE(lp_algebraic_number_is_lazy(zero.get_internal()));
+  // Same as the eager computation
+  lp_algebraic_number_set_lazy(0);
+  AlgebraicNumber b = sqrt2 * sqrt3 + sqrt2;
+  CHECK_FALSE(lp_algebraic_number_is_lazy(b.get_internal()));
+  lp_algebraic_number_set_lazy(1);
+  CHECK(a == b);
+  CHECK(get_defining_polynomial(a) == get_defining_polynomial(b));
+}
+
+TEST_CASE("algebraic_number::minimal_polynomial") {
+  AlgebraicNumber sqrt2(UPolynomial({-2, 0, 1}), DyadicInterval(1, 2));
+  AlgebraicNumber sqrt3(UPolynomial({-3, 0, 1}), DyadicInterval(1, 2));
+  AlgebraicNumber sqrt8(UPolynomial({-8, 0, 1}), DyadicInterval(2, 3));
+  // The composed sum is (x^2 - 2)(x^2 - 18)
+  AlgebraicNumber a = sqrt2 + sqrt8;
+  CHECK(get_defining_polynomial(a) == UPolynomial({-18, 0, 1}));
+  // The composed sum is irreducible
+  AlgebraicNumber b = sqrt2 + sqrt3;
+  CHECK(degree(get_defining_polynomial(b)) == 4);
+  // sqrt(2)*sqrt(3)*sqrt(6) = 6
+  AlgebraicNumber sqrt6(UPolynomial({-6, 0, 1}), DyadicInterval(2, 3));
+  AlgebraicNumber c = sqrt2 * sqrt3 * sqrt6;
+  CHECK(c == Integer(6));
+  CHECK(degree(get_defining_polynomial(a * b)) <= 4);
+  // Composed difference: sqrt(8) - sqrt(2) = sqrt(2)
+  CHECK(sqrt8 - sqrt2 == sqrt2);
+}
+
+TEST_CASE("algebraic_number::root_set") {
+  // (x^2 - 2)(x^2 - 3) is square-free, so all roots share one set
+  UPolynomial p = UPolynomial({-2, 0, 1}) * UPolynomial({-3, 0, 1});
+  std::vector<AlgebraicNumber> roots = isolate_real_roots(p);
+  CHECK(roots.size() == 4);
+  for (std::size_t i = 0; i < roots.size(); ++i) {
+    CHECK(roots[i].get_internal()->f == roots[0].get_internal()->f);
+  }
+  CHECK(roots[1] < roots[2]);
+  CHECK(roots[3] > roots[0]);
+  // Copies share the set and its refinements
+  AlgebraicNumber r(roots[2]);
+  CHECK(r == roots[2]);
+  CHECK(r.get_internal()->f == roots[2].get_internal()->f);
+  for (int i = 0; i < 10; ++i) refine(r);
+  refine(roots[2]);
+  CHECK(lp_dyadic_interval_size(&roots[2].get_internal()->I) <= lp_dyadic_interval_size(&r.get_internal()->I));
+  CHECK(r == AlgebraicNumber(UPolynomial({-2, 0, 1}), DyadicInterval(1, 2)));
+}
+
 TEST_CASE("algebraic_number::is_rational") {
   CHECK_FALSE(is_rational(
       AlgebraicNumber(UPolynomial({-2, 0, 1}), DyadicInterval(-2, -1))));
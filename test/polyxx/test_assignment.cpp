@@ -1,5 +1,6 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <polyxx.h>
+#include <feasibility_set.h>
 
 #include "doctest.h"
 
@@ -59,4 +60,102 @@ TEST_CASE("assignment") {
   CHECK(a.has(z));
   CHECK(a.get(x) == Value(4));
   CHECK(a.get(z) == Value(5));
-}
\ No newline at end of file
+}
+
+TEST_CASE("assignment::timestamp") {
+  Assignment a;
+
+  Variable x("x");
+  Variable y("y");
+
+  CHECK(lp_assignment_get_timestamp(a.get_internal(), x.get_internal()) == 0);
+
+  a.set(x, Value(1));
+  CHECK(lp_assignment_get_timestamp(a.get_internal(), x.get_internal()) > 0);
+  CHECK(lp_assignment_get_timestamp(a.get_internal(), y.get_internal()) == 0);
+
+  a.set(y, Value(2));
+  size_t x_timestamp = lp_assignment_get_timestamp(a.get_internal(), x.get_internal());
+  size_t y_timestamp = lp_assignment_get_timestamp(a.get_internal(), y.get_internal());
+  CHECK(y_timestamp > x_timestamp);
+  CHECK(lp_assignment_get_version(a.get_internal()) >= y_timestamp);
+
+  a.unset(x);
+  CHECK(lp_assignment_get_timestamp(a.get_internal(), x.get_internal()) > y_timestamp);
+  CHECK(lp_assignment_get_timestamp(a.get_internal(), y.get_internal()) == y_timestamp);
+}
+
+TEST_CASE("assignment::push_pop") {
+  Assignment a;
+
+  Variable x("x");
+  Variable y("y");
+
+  a.set(x, Value(1));
+  size_t version = lp_assignment_get_version(a.get_internal());
+
+  a.push();
+  CHECK(lp_assignment_scope_level(a.get_internal()) == 1);
+  a.set(x, Value(2));
+  a.set(y, Value(3));
+  a.set(x, Value(4));
+
+  a.push();
+  a.unset(x);
+  CHECK_FALSE(a.has(x));
+  a.pop();
+
+  CHECK(a.get(x) == Value(4));
+  CHECK(a.get(y) == Value(3));
+
+  a.pop();
+  CHECK(lp_assignment_scope_level(a.get_internal()) == 0);
+  CHECK(a.get(x) == Value(1));
+  CHECK_FALSE(a.has(y));
+  CHECK(lp_assignment_get_version(a.get_internal()) > version);
+
+  // Cached signs must not survive the pop
+  Polynomial p = x * y - 3;
+  a.set(y, Value(2));
+  CHECK(lp_polynomial_sgn(p.get_internal(), a.get_internal()) < 0);
+  a.push();
+  a.set(x, Value(3));
+  CHECK(lp_polynomial_sgn(p.get_internal(), a.get_internal()) > 0);
+  a.pop();
+  CHECK(lp_polynomial_sgn(p.get_internal(), a.get_internal()) < 0);
+
+  // Open scopes are cleaned up with the assignment
+  a.push();
+  a.set(x, Value(5));
+}
+
+TEST_CASE("assignment::push_pop_queries") {
+  Assignment a;
+
+  Variable x("x");
+  Variable y("y");
+  Variable z("z");
+
+  // Queries only change the assignment temporarily, so nothing is trailed
+  Polynomial p = x * x * y - 2;
+  Polynomial q = z * z * y - 2;
+  a.set(x, Value(1));
+  a.set(y, Value(AlgebraicNumber(UPolynomial({-2, 0, 1}), DyadicInterval(1, 2))));
+  a.push();
+  size_t trail_size = a.get_internal()->trail_size;
+  for (int i = 0; i < 100; ++ i) {
+    lp_value_t roots[2];
+    size_t roots_size = 0;
+    lp_polynomial_roots_isolate(p.get_internal(), a.get_internal(), roots, &roots_size);
+    CHECK(roots_size == 1);
+    for (size_t j = 0; j < roots_size; ++ j) {
+      lp_value_destruct(roots + j);
+    }
+    lp_feasibility_set_t* s = lp_polynomial_constraint_get_feasible_set(q.get_internal(), LP_SGN_LT_0, 0, a.get_internal());
+    lp_feasibility_set_delete(s);
+  }
+  CHECK(a.get_internal()->trail_size == trail_size);
+  CHECK(a.get(x) == Value(1));
+  a.pop();
+  CHECK(a.get(x) == Value(1));
+}
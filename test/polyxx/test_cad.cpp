@@ -0,0 +1,303 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <polyxx.h>
+#include <cad.h>
+#include <polynomial_hash_set.h>
+
+#include "doctest.h"
+
+using namespace poly;
+
+namespace {
+
+  /** Owning wrapper for lp_polynomial_hash_set_t */
+  struct PolynomialSet {
+    lp_polynomial_hash_set_t set;
+    PolynomialSet() { lp_polynomial_hash_set_construct(&set); }
+    PolynomialSet(std::initializer_list<Polynomial> polys) {
+      lp_polynomial_hash_set_construct(&set);
+      for (const auto& p : polys) {
+        lp_polynomial_hash_set_insert(&set, p.get_internal());
+      }
+    }
+    ~PolynomialSet() { lp_polynomial_hash_set_destruct(&set); }
+    size_t size() const { return set.size; }
+    /** Membership check, the set must be closed */
+    bool contains(const Polynomial& p) const {
+      for (size_t i = 0; i < set.size; ++i) {
+        if (lp_polynomial_eq(set.data[i], p.get_internal())) return true;
+      }
+      return false;
+    }
+  };
+
+}
+
+TEST_CASE("cad::project") {
+  Variable y("y");
+  Variable x("x");
+
+  {
+    PolynomialSet P({x * x + y * y - 1, x - y});
+    PolynomialSet basis, proj;
+    lp_cad_project(LP_CAD_PROJECTION_MCCALLUM, &P.set, x.get_internal(), &basis.set, &proj.set);
+    CHECK(basis.size() == 2);
+    CHECK(basis.contains(x * x + y * y - 1));
+    CHECK(basis.contains(x - y));
+    CHECK(proj.size() == 2);
+    CHECK(proj.contains(y * y - 1));
+    CHECK(proj.contains(2 * y * y - 1));
+  }
+
+  {
+    // Duplicates, multiple factors and content, lower level polynomials
+    PolynomialSet P({3 * (x - y) * (x - y) * (y + 2), y - x, y + 1});
+    PolynomialSet basis, proj;
+    lp_cad_project(LP_CAD_PROJECTION_MCCALLUM, &P.set, x.get_internal(), &basis.set, &proj.set);
+    CHECK(basis.size() == 1);
+    CHECK(basis.contains(x - y));
+    CHECK(proj.size() == 2);
+    CHECK(proj.contains(y + 1));
+    CHECK(proj.contains(y + 2));
+  }
+
+  {
+    // Common factors are split into a square-free basis
+    PolynomialSet P({(x - y) * (x + y), (x - y) * (x - 1)});
+    PolynomialSet basis, proj;
+    lp_cad_project(LP_CAD_PROJECTION_MCCALLUM, &P.set, x.get_internal(), &basis.set, &proj.set);
+    CHECK(basis.size() == 3);
+    CHECK(basis.contains(x - y));
+    CHECK(basis.contains(x + y));
+    CHECK(basis.contains(x - 1));
+    CHECK(proj.size() == 3);
+    CHECK(proj.contains(y));
+    CHECK(proj.contains(y - 1));
+    CHECK(proj.contains(y + 1));
+  }
+
+  {
+    // McCallum takes all coefficients, Lazard only leading and trailing
+    Polynomial f = y * x * x + (y + 1) * x + y - 2;
+    PolynomialSet P({f});
+    PolynomialSet basis1, proj1, basis2, proj2;
+    lp_cad_project(LP_CAD_PROJECTION_MCCALLUM, &P.set, x.get_internal(), &basis1.set, &proj1.set);
+    lp_cad_project(LP_CAD_PROJECTION_LAZARD, &P.set, x.get_internal(), &basis2.set, &proj2.set);
+    CHECK(proj1.contains(y));
+    CHECK(proj1.contains(y + 1));
+    CHECK(proj1.contains(y - 2));
+    CHECK(proj2.contains(y));
+    CHECK_FALSE(proj2.contains(y + 1));
+    CHECK(proj2.contains(y - 2));
+    CHECK(proj1.size() == proj2.size() + 1);
+  }
+}
+
+TEST_CASE("cad::project_threads") {
+  Variable z("z");
+  Variable y("y");
+  Variable x("x");
+
+  std::vector<Polynomial> polys;
+  for (int i = 1; i <= 6; ++i) {
+    polys.push_back(x * x + i * y * z - i * x + z - y);
+    polys.push_back(pow(x, 3) - i * y * x + z * z - i);
+  }
+  PolynomialSet P;
+  for (const auto& p : polys) {
+    lp_polynomial_hash_set_insert(&P.set, p.get_internal());
+  }
+
+  PolynomialSet basis1, proj1, basis4, proj4;
+  lp_cad_project(LP_CAD_PROJECTION_MCCALLUM, &P.set, x.get_internal(), &basis1.set, &proj1.set);
+  lp_set_threads(4);
+  lp_cad_project(LP_CAD_PROJECTION_MCCALLUM, &P.set, x.get_internal(), &basis4.set, &proj4.set);
+  lp_set_threads(1);
+
+  CHECK(basis1.size() == 12);
+  CHECK(basis4.size() == 12);
+  CHECK(proj1.size() == proj4.size());
+  bool same = true;
+  for (size_t i = 0; i < proj1.size(); ++i) {
+    same = same && lp_polynomial_eq(proj1.set.data[i], proj4.set.data[i]);
+  }
+  CHECK(same);
+}
+
+namespace {
+
+  bool is_root(const lp_cad_root_t& root, const Polynomial& p, size_t index) {
+    return root.p && lp_polynomial_eq(root.p, p.get_internal()) && root.index == index;
+  }
+
+}
+
+TEST_CASE("cad::cell") {
+  Variable y("y");
+  Variable x("x");
+
+  lp_variable_order_t* order = Context::get_context().get_variable_order();
+  lp_variable_order_push(order, y.get_internal());
+  lp_variable_order_push(order, x.get_internal());
+
+  Polynomial circle = x * x + y * y - 1;
+
+  {
+    // Sector, bounded by the circle and its discriminant
+    PolynomialSet P({circle});
+    Assignment m;
+    m.set(y, Value(long(0)));
+    m.set(x, Value(Rational(1, 2)));
+    lp_cad_cell_t* cell = lp_cad_cell_new(&P.set, order, m.get_internal());
+    CHECK(cell->size == 2);
+    CHECK(cell->levels[1].x == x.get_internal());
+    CHECK(!cell->levels[1].is_section);
+    CHECK(is_root(cell->levels[1].lower, circle, 0));
+    CHECK(is_root(cell->levels[1].upper, circle, 1));
+    CHECK(lp_value_cmp(&cell->levels[1].lower.value, Value(-1).get_internal()) == 0);
+    CHECK(lp_value_cmp(&cell->levels[1].upper.value, Value(1).get_internal()) == 0);
+    CHECK(cell->levels[0].x == y.get_internal());
+    CHECK(is_root(cell->levels[0].lower, y * y - 1, 0));
+    CHECK(is_root(cell->levels[0].upper, y * y - 1, 1));
+    lp_cad_cell_delete(cell);
+  }
+
+  {
+    // Section at a non-dyadic sample
+    PolynomialSet P({circle, 3 * x - 1});
+    Assignment m;
+    m.set(y, Value(long(0)));
+    m.set(x, Value(Rational(1, 3)));
+    lp_cad_cell_t* cell = lp_cad_cell_new(&P.set, order, m.get_internal());
+    CHECK(cell->levels[1].is_section);
+    CHECK(is_root(cell->levels[1].lower, 3 * x - 1, 0));
+    CHECK(is_root(cell->levels[1].upper, 3 * x - 1, 0));
+    // The circle meets the line at y = -sqrt(8)/3, sqrt(8)/3
+    CHECK(is_root(cell->levels[0].lower, 9 * y * y - 8, 0));
+    CHECK(is_root(cell->levels[0].upper, 9 * y * y - 8, 1));
+    lp_cad_cell_delete(cell);
+  }
+
+  {
+    // Only the closest roots, irrational bounds
+    Polynomial f = (x - 1) * (x - 2) * (x - 3) * (x - 4) * (x - 5);
+    Polynomial g = x * x - 2 * y;
+    PolynomialSet P({f, g});
+    Assignment m;
+    m.set(y, Value(4));
+    m.set(x, Value(Rational(5, 2)));
+    lp_cad_cell_t* cell = lp_cad_cell_new(&P.set, order, m.get_internal());
+    CHECK(is_root(cell->levels[1].lower, f, 1));
+    CHECK(is_root(cell->levels[1].upper, g, 1));
+    CHECK(lp_value_cmp(&cell->levels[1].lower.value, Value(2).get_internal()) == 0);
+    // sqrt(8) < 3
+    CHECK(lp_value_cmp(&cell->levels[1].upper.value, Value(Rational(57, 20)).get_internal()) < 0);
+    CHECK(lp_value_cmp(&cell->levels[1].upper.value, Value(Rational(56, 20)).get_internal()) > 0);
+    // g meets f at y = k^2/2, the closest are y = 2 and y = 9/2
+    Polynomial r = (2 * y - 1) * (y - 2) * (2 * y - 9) * (y - 8) * (2 * y - 25);
+    CHECK(is_root(cell->levels[0].lower, r, 1));
+    CHECK(is_root(cell->levels[0].upper, r, 2));
+    CHECK(lp_value_cmp(&cell->levels[0].upper.value, Value(Rational(9, 2)).get_internal()) == 0);
+    CHECK(cell->projection.size == 4);
+    lp_cad_cell_delete(cell);
+  }
+
+  {
+    // Algebraic sample
+    PolynomialSet P({circle, x * x - 2 * y * y});
+    AlgebraicNumber sqrt2(UPolynomial({-2, 0, 1}), DyadicInterval(DyadicRational(1, 0), DyadicRational(2, 0)));
+    Assignment m;
+    m.set(y, Value(1));
+    m.set(x, Value(sqrt2));
+    lp_cad_cell_t* cell = lp_cad_cell_new(&P.set, order, m.get_internal());
+    CHECK(cell->levels[1].is_section);
+    CHECK(is_root(cell->levels[1].lower, x * x - 2 * y * y, 1));
+    CHECK(cell->levels[0].lower.value.type == LP_VALUE_INTEGER);
+    lp_cad_cell_delete(cell);
+  }
+
+  lp_variable_order_clear(order);
+}
+
+namespace {
+
+  size_t count_leaves(const lp_cad_sample_t* s) {
+    if (s->children_size == 0) return 1;
+    size_t count = 0;
+    for (size_t i = 0; i < s->children_size; ++i) {
+      count += count_leaves(s->children + i);
+    }
+    return count;
+  }
+
+  bool same_tree(const lp_cad_sample_t* s1, const lp_cad_sample_t* s2) {
+    if (s1->x != s2->x || s1->is_section != s2->is_section) return false;
+    if (s1->parent && lp_value_cmp(&s1->value, &s2->value) != 0) return false;
+    if (s1->children_size != s2->children_size) return false;
+    for (size_t i = 0; i < s1->children_size; ++i) {
+      if (!same_tree(s1->children + i, s2->children + i)) return false;
+    }
+    return true;
+  }
+
+}
+
+TEST_CASE("cad::lift") {
+  Variable y("y");
+  Variable x("x");
+
+  lp_variable_order_t* order = Context::get_context().get_variable_order();
+  lp_variable_order_push(order, y.get_internal());
+  lp_variable_order_push(order, x.get_internal());
+
+  {
+    Polynomial circle = x * x + y * y - 1;
+    PolynomialSet P({circle, y * y - 1});
+    lp_cad_sample_t* root = lp_cad_lift(&P.set, order);
+    CHECK(root->children_size == 5);
+    CHECK(count_leaves(root) == 13);
+    for (size_t i = 0; i < root->children_size; ++i) {
+      const lp_cad_sample_t* s = root->children + i;
+      CHECK(s->x == y.get_internal());
+      CHECK(s->is_section == (i % 2 == 1));
+      if (i > 0) {
+        CHECK(lp_value_cmp(&root->children[i - 1].value, &s->value) < 0);
+      }
+    }
+    // On each leaf the circle is either zero (sections) or not
+    Assignment m;
+    for (size_t i = 0; i < root->children_size; ++i) {
+      const lp_cad_sample_t* s = root->children + i;
+      for (size_t j = 0; j < s->children_size; ++j) {
+        lp_cad_sample_get_assignment(s->children + j, m.get_internal());
+        int sgn = lp_polynomial_sgn(circle.get_internal(), m.get_internal());
+        CHECK((sgn == 0) == (s->children[j].is_section == 1));
+      }
+    }
+    lp_cad_sample_delete(root);
+  }
+
+  {
+    // Same tree with threads
+    PolynomialSet P({x * x + y * y - 1, x - 2 * y + 1});
+    PolynomialSet basis, proj;
+    lp_cad_project(LP_CAD_PROJECTION_MCCALLUM, &P.set, x.get_internal(), &basis.set, &proj.set);
+    PolynomialSet all;
+    for (size_t i = 0; i < basis.size(); ++i) {
+      lp_polynomial_hash_set_insert(&all.set, basis.set.data[i]);
+    }
+    for (size_t i = 0; i < proj.size(); ++i) {
+      lp_polynomial_hash_set_insert(&all.set, proj.set.data[i]);
+    }
+    lp_cad_sample_t* root1 = lp_cad_lift(&all.set, order);
+    lp_set_threads(4);
+    lp_cad_sample_t* root4 = lp_cad_lift(&all.set, order);
+    lp_set_threads(1);
+    CHECK(root1->children_size == 9);
+    CHECK(count_leaves(root1) == 47);
+    CHECK(same_tree(root1, root4));
+    lp_cad_sample_delete(root1);
+    lp_cad_sample_delete(root4);
+  }
+
+  lp_variable_order_clear(order);
+}
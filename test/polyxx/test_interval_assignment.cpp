@@ -1,5 +1,6 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <polyxx.h>
+#include <interval_propagator.h>
 
 #include "doctest.h"
 
@@ -59,4 +60,83 @@ TEST_CASE("interval_assignment") {
   CHECK(a.has(z));
   CHECK(a.get(x) == Interval(4, 5));
   CHECK(a.get(z) == Interval(5, 6));
-}
\ No newline at end of file
+}
+
+TEST_CASE("interval_assignment::propagator") {
+  IntervalAssignment a;
+
+  Variable x("x");
+  Variable y("y");
+  Variable z("z");
+
+  Polynomial px(x);
+  Polynomial py(y);
+  Polynomial pz(z);
+
+  Polynomial p0 = px - py - 1;
+  Polynomial p1 = py - 2;
+  Polynomial p2 = px * px - 9;
+
+  lp_interval_propagator_t* P = lp_interval_propagator_new();
+  lp_interval_propagator_add(P, p0.get_internal(), LP_SGN_GE_0, 0);
+  lp_interval_propagator_add(P, p1.get_internal(), LP_SGN_LT_0, 1);
+  lp_interval_propagator_add(P, p2.get_internal(), LP_SGN_LE_0, 0);
+  CHECK(lp_interval_propagator_size(P) == 3);
+
+  // y >= 2 => x >= 3, and x^2 <= 9 => x <= 3 => y <= 2
+  a.set(y, Interval(Value(long(0)), false, Value(10), false));
+  CHECK(lp_interval_propagator_run(P, a.get_internal(), 100) == 1);
+  CHECK(a.get(x) == Interval(Value(3)));
+  CHECK(a.get(y) == Interval(Value(2)));
+
+  // At the fixpoint, nothing is revised again
+  CHECK(lp_interval_propagator_run(P, a.get_internal(), 100) == 0);
+  CHECK(lp_interval_propagator_get_revisions(P) == 0);
+
+  // Only the constraints of z are revised
+  Polynomial p3 = pz * pz - px;
+  lp_interval_propagator_add(P, p3.get_internal(), LP_SGN_LE_0, 0);
+  CHECK(lp_interval_propagator_run(P, a.get_internal(), 100) == 1);
+  CHECK(lp_interval_propagator_get_revisions(P) == 1);
+  Interval z_I = a.get(z);
+  CHECK(lp_value_cmp_rational(lp_interval_get_upper_bound(z_I.get_internal()), Rational(17, 9).get_internal()) < 0);
+  CHECK(lp_value_cmp_rational(lp_interval_get_upper_bound(z_I.get_internal()), Rational(173, 100).get_internal()) > 0);
+
+  // x^2 <= 9 and x >= 3 conflict with x > 3
+  Polynomial p4 = px - 3;
+  lp_interval_propagator_add(P, p4.get_internal(), LP_SGN_GT_0, 0);
+  CHECK(lp_interval_propagator_run(P, a.get_internal(), 100) == -1);
+  CHECK(lp_interval_propagator_get_conflict(P) == 4);
+
+  lp_interval_propagator_delete(P);
+}
+
+TEST_CASE("interval_assignment::propagator_budget") {
+  IntervalAssignment a;
+
+  Variable x("x");
+  Variable y("y");
+
+  Polynomial px(x);
+  Polynomial py(y);
+
+  // x = 2y and y = 2x only converge in the limit
+  Polynomial p0 = px - 2 * py;
+  Polynomial p1 = py - 2 * px;
+
+  lp_interval_propagator_t* P = lp_interval_propagator_new();
+  lp_interval_propagator_add(P, p0.get_internal(), LP_SGN_EQ_0, 0);
+  lp_interval_propagator_add(P, p1.get_internal(), LP_SGN_EQ_0, 0);
+
+  a.set(x, Interval(Value(long(0)), false, Value(1), false));
+  CHECK(lp_interval_propagator_run(P, a.get_internal(), 10) == 1);
+  CHECK(lp_interval_propagator_get_revisions(P) == 10);
+  Interval x_I = a.get(x);
+
+  // The next run goes on from there
+  CHECK(lp_interval_propagator_run(P, a.get_internal(), 10) == 1);
+  CHECK(lp_interval_propagator_get_revisions(P) == 10);
+  CHECK(lp_interval_cmp_upper_bounds(a.get(x).get_internal(), x_I.get_internal()) < 0);
+
+  lp_interval_propagator_delete(P);
+}
@@ -71,4 +71,218 @@ TEST_CASE("polynomial::psc") {
   CHECK(tmp[3] == Integer(0));
   CHECK(tmp[4] == Integer(-45));
   CHECK(tmp[5] == Integer(7));
-}
\ No newline at end of file
+}
+
+TEST_CASE("polynomial::mul_packed") {
+  Variable x("x");
+  Variable y("y");
+  Variable z("z");
+  Polynomial p;
+  for (unsigned i = 0; i < 5; ++i) {
+    for (unsigned j = 0; j < 5; ++j) {
+      p += Integer(long(i + j) - 3) * pow(x, i) * pow(y, j) * pow(z, (i * j) % 3);
+    }
+  }
+  Polynomial q = p - 2 * pow(y, 5) * z + 1;
+
+  Polynomial pq;
+  add_mul(pq, p, q);
+  CHECK(p * q == pq);
+
+  Polynomial p2;
+  add_mul(p2, p, p);
+  Polynomial p3;
+  add_mul(p3, p2, p);
+  CHECK(pow(p, 2) == p2);
+  CHECK(pow(p, 3) == p3);
+  CHECK(is_zero(p * q - q * p));
+}
+
+TEST_CASE("polynomial::order_packed") {
+  Variable x("x");
+  Variable y("y");
+  Variable z("z");
+  Polynomial p;
+  for (unsigned i = 0; i < 5; ++i) {
+    for (unsigned j = 0; j < 5; ++j) {
+      p += Integer(long(i + j) - 3) * pow(x, i) * pow(y, j) * pow(z, (i * j) % 3);
+    }
+  }
+  p += pow(z, 300) * x - 1;
+
+  // Reorder to z < x < y, and compare to the polynomial built in that order
+  lp_variable_order_t* order = Context::get_context().get_variable_order();
+  lp_variable_order_push(order, z.get_internal());
+  lp_variable_order_push(order, x.get_internal());
+  lp_variable_order_push(order, y.get_internal());
+  Polynomial q;
+  for (unsigned i = 0; i < 5; ++i) {
+    for (unsigned j = 0; j < 5; ++j) {
+      q += Integer(long(i + j) - 3) * pow(x, i) * pow(y, j) * pow(z, (i * j) % 3);
+    }
+  }
+  q += pow(z, 300) * x - 1;
+  CHECK_FALSE(lp_polynomial_check_order(p.get_internal()));
+  lp_polynomial_ensure_order(p.get_internal());
+  CHECK(lp_polynomial_check_order(p.get_internal()));
+  CHECK(main_variable(p) == y);
+  CHECK(p == q);
+  lp_variable_order_clear(order);
+}
+
+TEST_CASE("polynomial::div_packed") {
+  Variable x("x");
+  Variable y("y");
+  Variable z("z");
+  Polynomial p;
+  Polynomial q;
+  for (unsigned i = 0; i < 5; ++i) {
+    for (unsigned j = 0; j < 5; ++j) {
+      p += Integer(long(i + j) - 3) * pow(x, i) * pow(y, j) * pow(z, (i * j) % 3);
+      q += Integer(long(2 * i) - long(j) + 1) * pow(x, j) * pow(z, i) * pow(y, (i + j) % 2);
+    }
+  }
+  Polynomial pq = p * q;
+  CHECK(div(pq, q) == p);
+  CHECK(div(pq, p) == q);
+  CHECK(div(pq * pq, pq) == pq);
+
+  Polynomial r = 3 * pow(x, 2) * y - 2 * z + 1;
+  CHECK(gcd(pq, p * r) == p);
+}
+
+TEST_CASE("polynomial::sgn") {
+  Variable x("x");
+  Variable y("y");
+  Assignment a;
+  a.set(x, Value(AlgebraicNumber(UPolynomial({-2, 0, 1}), DyadicInterval(1, 2))));
+  a.set(y, Value(Rational(1, 3)));
+
+  CHECK(sgn(x - 1, a) == 1);
+  CHECK(sgn(x * x - 2, a) == 0);
+  CHECK(sgn(3 * y - 1, a) == 0);
+  CHECK(sgn(1000000 * x - 1414214, a) == -1);
+  CHECK(sgn(1000000 * x - 1414213, a) == 1);
+  CHECK(sgn(pow(x, 2) * y - y - 1, a) == -1);
+  CHECK(sgn(pow(x, 4) - 4 + pow(3 * y - 1, 3), a) == 0);
+
+  Polynomial p = Integer(1000000000000) * x - Integer(1414213562373);
+  CHECK(sgn(p, a) == 1);
+  lp_set_sgn_refinement_budget(0);
+  CHECK(sgn(p, a) == 1);
+  CHECK(sgn(Integer(1000000000000) * x * y - Integer(471404520791), a) == 1);
+  lp_set_sgn_refinement_budget(64);
+  CHECK(sgn(Integer(1000000000000) * x * y - Integer(471404520791), a) == 1);
+  CHECK(sgn(Integer(1000000000000) * x * y - Integer(471404520792), a) == -1);
+}
+
+TEST_CASE("polynomial::sgn_memoized") {
+  Variable x("x");
+  Variable y("y");
+  Assignment a;
+  // Exact zeros are not decided by the double approximation, so the signs
+  // below go through the (memoized) rational evaluation
+  Polynomial p = 3 * x * y - 1;
+  a.set(y, Value(Rational(1, 9)));
+  a.set(x, Value(Rational(3)));
+  CHECK(sgn(p, a) == 0);
+  a.set(x, Value(Rational(4)));
+  CHECK(sgn(p, a) == 1);
+  a.set(y, Value(Rational(1, 12)));
+  CHECK(sgn(p, a) == 0);
+  a.set(x, Value(Rational(3)));
+  CHECK(sgn(p, a) == -1);
+  // Same address, different assignment
+  a.clear();
+  a.set(y, Value(Rational(1, 3)));
+  a.set(x, Value(Rational(2)));
+  CHECK(sgn(p, a) == 1);
+  // Modified polynomial
+  p = 9 * x * y - 6;
+  CHECK(sgn(p, a) == 0);
+}
+
+TEST_CASE("polynomial::order_epoch") {
+  Variable x("x");
+  Variable y("y");
+  Polynomial p = x * y + y;
+  // Only external polynomials are kept in order on entry
+  lp_polynomial_set_external(p.get_internal());
+  lp_variable_order_t* order = Context::get_context().get_variable_order();
+  size_t epoch = lp_variable_order_get_epoch(order);
+  CHECK(main_variable(p) == y);
+  CHECK(lp_variable_order_get_epoch(order) == epoch);
+  // Reordered on first use after the order changes
+  lp_variable_order_push(order, y.get_internal());
+  lp_variable_order_push(order, x.get_internal());
+  CHECK(lp_variable_order_get_epoch(order) > epoch);
+  CHECK(main_variable(p) == x);
+  CHECK(lp_polynomial_check_order(p.get_internal()));
+  CHECK(degree(p) == 1);
+  lp_variable_order_clear(order);
+  CHECK(main_variable(p) == y);
+  CHECK(lp_polynomial_check_order(p.get_internal()));
+}
+
+TEST_CASE("polynomial::contract_newton") {
+  Variable x("x");
+  Variable y("y");
+  IntervalAssignment m;
+
+  // x^5 + x - 3 has a root in (1.1329975658, 1.1329975659)
+  Polynomial p = x * x * x * x * x + x - 3;
+  Rational root_lb(11329975658, 10000000000), root_ub(11329975659, 10000000000);
+  m.set(x, Interval(Value(long(0)), false, Value(2), false));
+  Assignment root;
+  root.set(x, Value(root_lb));
+  for (int i = 0; i < 5; ++ i) {
+    lp_polynomial_t* f = lp_polynomial_constraint_explain_contract_newton(p.get_internal(), LP_SGN_EQ_0, 0, m.get_internal(), x.get_internal());
+    CHECK(lp_polynomial_constraint_contract_newton(p.get_internal(), LP_SGN_EQ_0, 0, m.get_internal()) == 1);
+    // Explained by f(x) <= 0, true close to the root
+    REQUIRE(f);
+    CHECK(lp_polynomial_degree(f) == 2);
+    CHECK(lp_polynomial_sgn(f, root.get_internal()) <= 0);
+    lp_polynomial_delete(f);
+  }
+  const lp_interval_t* x_I = lp_interval_assignment_get_interval(m.get_internal(), x.get_internal());
+  CHECK(lp_value_cmp_rational(lp_interval_get_lower_bound(x_I), root_ub.get_internal()) < 0);
+  CHECK(lp_value_cmp_rational(lp_interval_get_upper_bound(x_I), root_lb.get_internal()) > 0);
+  CHECK(lp_value_cmp_rational(lp_interval_get_lower_bound(x_I), Rational(1132, 1000).get_internal()) > 0);
+  CHECK(lp_value_cmp_rational(lp_interval_get_upper_bound(x_I), Rational(1134, 1000).get_internal()) < 0);
+
+  // Only equations are contracted
+  CHECK(lp_polynomial_constraint_contract_newton(p.get_internal(), LP_SGN_LE_0, 0, m.get_internal()) == 0);
+
+  // x*y - 2: x' = y doesn't contain 0, y' = x does (Krawczyk, no contraction)
+  IntervalAssignment m2;
+  Polynomial q = x * y - 2;
+  m2.set(x, Interval(Value(long(0)), false, Value(4), false));
+  m2.set(y, Interval(Value(1), false, Value(2), false));
+  CHECK(lp_polynomial_constraint_contract_newton(q.get_internal(), LP_SGN_NE_0, 1, m2.get_internal()) == 1);
+  CHECK(m2.get(x) == Interval(Value(long(0)), false, Value(2), false));
+  CHECK(m2.get(y) == Interval(Value(1), false, Value(2), false));
+  CHECK(lp_polynomial_constraint_explain_contract_newton(q.get_internal(), LP_SGN_EQ_0, 0, m2.get_internal(), y.get_internal()) == nullptr);
+
+  // Krawczyk contracts x^2 - 2 on [-1/10, 2]
+  IntervalAssignment m3;
+  Polynomial r = x * x - 2;
+  m3.set(x, Interval(Value(Rational(-1, 10)), false, Value(2), false));
+  CHECK(lp_polynomial_constraint_contract_newton(r.get_internal(), LP_SGN_EQ_0, 0, m3.get_internal()) == 1);
+  CHECK(lp_value_sgn(lp_interval_get_lower_bound(m3.get(x).get_internal())) > 0);
+  CHECK(lp_interval_contains(m3.get(x).get_internal(), Value(Rational(1414, 1000)).get_internal()));
+
+  // x^2 - 3 on [sqrt(3), 2], with sqrt(3) isolated in (1, 4): the middle point
+  // 3/2 is outside the interval, but the derivative is taken over [1, 2]
+  IntervalAssignment m4;
+  Polynomial t = x * x - 3;
+  Value sqrt3(AlgebraicNumber(UPolynomial({-3, 0, 1}), DyadicInterval(1, 4)));
+  m4.set(x, Interval(sqrt3, false, Value(2), false));
+  CHECK(lp_polynomial_constraint_contract_newton(t.get_internal(), LP_SGN_EQ_0, 0, m4.get_internal()) == 1);
+  CHECK(lp_interval_contains(m4.get(x).get_internal(), sqrt3.get_internal()));
+
+  // No solutions: x^2 + 1 on [1, 2]
+  IntervalAssignment m5;
+  Polynomial s = x * x + 1;
+  m5.set(x, Interval(Value(1), false, Value(2), false));
+  CHECK(lp_polynomial_constraint_contract_newton(s.get_internal(), LP_SGN_EQ_0, 0, m5.get_internal()) == -1);
+}
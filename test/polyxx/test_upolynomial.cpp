@@ -116,10 +116,79 @@ TEST_CASE("upolynomial::sign_at") {
   CHECK(sign_at(p, DyadicRational(71, 3)) == -1);
 }
 
+TEST_CASE("upolynomial::evaluate_many") {
+  UPolynomial p({2, 1, -1, 0, 3});
+  std::vector<Rational> xs = {Rational(-5, 2), Rational(-1, 1), Rational(),
+                              Rational(1, 3), Rational(2, 3), Rational(7, 3)};
+  std::vector<lp_rational_t> x(xs.size()), values(xs.size());
+  std::vector<int> sgns(xs.size());
+  for (std::size_t i = 0; i < xs.size(); ++i) {
+    lp_rational_construct_copy(&x[i], xs[i].get_internal());
+    lp_rational_construct(&values[i]);
+  }
+  lp_upolynomial_evaluate_many(p.get_internal(), x.size(), x.data(), values.data());
+  lp_upolynomial_sgn_many(p.get_internal(), x.size(), x.data(), sgns.data());
+  for (std::size_t i = 0; i < xs.size(); ++i) {
+    CHECK(lp_rational_cmp(&values[i], evaluate_at(p, xs[i]).get_internal()) == 0);
+    CHECK(sgns[i] == sign_at(p, xs[i]));
+    lp_rational_destruct(&x[i]);
+    lp_rational_destruct(&values[i]);
+  }
+
+  std::vector<DyadicRational> ys = {DyadicRational(-13, 2), DyadicRational(-1, 1),
+                                    DyadicRational(), DyadicRational(3, 3),
+                                    DyadicRational(71, 3)};
+  std::vector<lp_dyadic_rational_t> y(ys.size()), y_values(ys.size());
+  std::vector<int> y_sgns(ys.size());
+  for (std::size_t i = 0; i < ys.size(); ++i) {
+    lp_dyadic_rational_construct_copy(&y[i], ys[i].get_internal());
+    lp_dyadic_rational_construct(&y_values[i]);
+  }
+  lp_upolynomial_evaluate_many_dyadic(p.get_internal(), y.size(), y.data(), y_values.data());
+  lp_upolynomial_sgn_many_dyadic(p.get_internal(), y.size(), y.data(), y_sgns.data());
+  for (std::size_t i = 0; i < ys.size(); ++i) {
+    CHECK(lp_dyadic_rational_cmp(&y_values[i], evaluate_at(p, ys[i]).get_internal()) == 0);
+    CHECK(y_sgns[i] == sign_at(p, ys[i]));
+    lp_dyadic_rational_destruct(&y[i]);
+    lp_dyadic_rational_destruct(&y_values[i]);
+  }
+}
+
 TEST_CASE("upolynomial::subst_x_neg") {
   CHECK(subst_x_neg(UPolynomial({2, 1, -1})) == UPolynomial({2, -1, -1}));
 }
 
+TEST_CASE("upolynomial::taylor_shift") {
+  UPolynomial p({3, -1, 0, 7, 2, -5});
+  for (long a : {0, 1, -1, 3, 4, -8}) {
+    for (unsigned long n : {0, 1, 3}) {
+      DyadicRational c(a, n);
+      UPolynomial q(lp_upolynomial_taylor_shift(p.get_internal(), c.get_internal()));
+      Rational scale(1l << (c.get_internal()->n * 5), 1);
+      for (long k = -3; k <= 3; ++k) {
+        Rational x(k, 3);
+        CHECK(evaluate_at(q, x) == scale * evaluate_at(p, x + Rational(a, 1ul << n)));
+      }
+    }
+  }
+
+  // Large degrees, shifting back and forth
+  std::vector<long> coeffs;
+  long seed = 1;
+  for (int i = 0; i < 600; ++i) {
+    seed = (seed * 1103515245 + 12345) % 2147483648;
+    coeffs.push_back(seed % 2001 - 1000);
+  }
+  UPolynomial f(coeffs);
+  for (long a : {3, -2, 1}) {
+    DyadicRational c(a, 0), c_neg(-a, 0);
+    UPolynomial g(lp_upolynomial_taylor_shift(f.get_internal(), c.get_internal()));
+    UPolynomial h(lp_upolynomial_taylor_shift(g.get_internal(), c_neg.get_internal()));
+    CHECK(h == f);
+    CHECK(evaluate_at(g, Integer(1)) == evaluate_at(f, Integer(a + 1)));
+  }
+}
+
 TEST_CASE("upolynomial::operator-") {
   CHECK(-UPolynomial({2, 1, -1}) == UPolynomial({-2, -1, 1}));
 }
@@ -217,6 +286,79 @@ TEST_CASE("upolynomial::gcd") {
   CHECK(gcd(p * q, q * r) == q);
   CHECK(gcd(p * q, p * r) == p);
   CHECK(gcd(p * r, r * r) == -r);
+  // Small degrees go through the subresultants
+  UPolynomial x1({1, 1});
+  CHECK(gcd(UPolynomial({-2, 1}) * x1, UPolynomial({3, 2}) * x1) == x1);
+  CHECK(gcd(Integer(6) * x1 * x1, Integer(-4) * x1 * UPolynomial({-1, 1})) == Integer(2) * x1);
+  CHECK(gcd(q * q, q * x1) == q * x1);
+}
+
+TEST_CASE("upolynomial::gcd_large_Zp") {
+  // Large degrees in Z_p go through the half-gcd
+  IntegerRing K(Integer(1000003), true);
+  std::vector<long> g_coeffs, a_coeffs, b_coeffs;
+  long seed = 1;
+  for (int i = 0; i < 800; ++i) {
+    seed = (seed * 1103515245 + 12345) % 2147483648;
+    g_coeffs.push_back(seed % 1000);
+    a_coeffs.push_back((seed / 1000) % 1000);
+    b_coeffs.push_back((seed / 1000000) % 1000);
+  }
+  g_coeffs.push_back(1);
+  a_coeffs.push_back(1);
+  UPolynomial g(K, g_coeffs);
+  UPolynomial a(K, a_coeffs);
+  UPolynomial b(K, b_coeffs);
+  UPolynomial d = gcd(a * g, b * g);
+  // gcd(a, b) is almost always 1, in any case g divides the gcd
+  CHECK(degree(d) >= 800);
+  CHECK(is_zero(rem_exact(d, g)));
+  CHECK(d == gcd(g, d) * gcd(a, b));
+}
+
+TEST_CASE("upolynomial::gcd_hgcd_threshold") {
+  // Just above the half-gcd threshold, while gcd(a, b) is computed by Euclid
+  IntegerRing K(Integer(1000003), true);
+  std::vector<long> g_coeffs, a_coeffs, b_coeffs;
+  long seed = 7;
+  for (int i = 0; i < 250; ++i) {
+    seed = (seed * 1103515245 + 12345) % 2147483648;
+    g_coeffs.push_back(seed % 1000);
+    a_coeffs.push_back((seed / 1000) % 1000);
+    b_coeffs.push_back((seed / 1000000) % 1000);
+  }
+  g_coeffs.push_back(1);
+  a_coeffs.push_back(1);
+  b_coeffs.push_back(1);
+  UPolynomial g(K, g_coeffs);
+  UPolynomial a(K, a_coeffs);
+  UPolynomial b(K, b_coeffs);
+  UPolynomial d = gcd(a * g, b * g);
+  CHECK(degree(d) >= 250);
+  CHECK(is_zero(rem_exact(d, g)));
+  CHECK(d == gcd(g, d) * gcd(a, b));
+}
+
+TEST_CASE("upolynomial::gcd_large_Z") {
+  std::vector<long> g_coeffs, a_coeffs, b_coeffs;
+  long seed = 1;
+  for (int i = 0; i < 60; ++i) {
+    seed = (seed * 1103515245 + 12345) % 2147483648;
+    g_coeffs.push_back(seed % 2000000001 - 1000000000);
+    seed = (seed * 1103515245 + 12345) % 2147483648;
+    a_coeffs.push_back(seed % 2000000001 - 1000000000);
+    seed = (seed * 1103515245 + 12345) % 2147483648;
+    b_coeffs.push_back(seed % 2000000001 - 1000000000);
+  }
+  g_coeffs.push_back(7);
+  a_coeffs.push_back(3);
+  UPolynomial g = primitive_part(UPolynomial(g_coeffs));
+  UPolynomial a(a_coeffs);
+  UPolynomial b(b_coeffs);
+  UPolynomial d = gcd(Integer(6) * a * g, Integer(-4) * b * g);
+  CHECK(is_zero(rem_exact(d, g)));
+  CHECK(d == Integer(2) * g * gcd(a, b));
+  CHECK(gcd(d, Integer(-1) * d) == d);
 }
 
 TEST_CASE("upolynomial::square_free_factors") {
@@ -245,6 +387,19 @@ TEST_CASE("upolynomial::count_real_roots") {
     CHECK(count_real_roots(p, RationalInterval(-5,5)) == 4);
     CHECK(count_real_roots(p, RationalInterval(-5,0)) == 2);
   }
+  {
+    // Repeated counting reuses the Sturm sequences, changes drop them
+    UPolynomial p = UPolynomial({-2, 0, 1}) * UPolynomial({-1, 1}) * UPolynomial({0, 1});
+    CHECK(count_real_roots(p, RationalInterval(-5,5)) == 4);
+    CHECK(count_real_roots(p, RationalInterval(0,2)) == 2);
+    CHECK(count_real_roots(p, RationalInterval(-2,0)) == 1);
+    CHECK(isolate_real_roots(p).size() == 4);
+    CHECK(count_real_roots(p, RationalInterval(-1,1)) == 1);
+    lp_upolynomial_reverse_in_place(p.get_internal());
+    // Now the roots are 1/sqrt(2), 1, -1/sqrt(2)
+    CHECK(count_real_roots(p, RationalInterval(-5,5)) == 3);
+    CHECK(count_real_roots(p, RationalInterval(-1,0)) == 1);
+  }
 }
 
 TEST_CASE("upolynomial::isolate_real_roots") {
@@ -267,3 +422,72 @@ TEST_CASE("upolynomial::isolate_real_roots") {
     CHECK(roots[3] == AlgebraicNumber(UPolynomial({-3, 0, 1}), DyadicInterval(1, 2)));
   }
 }
+
+TEST_CASE("upolynomial::isolate_real_roots_large") {
+  // High degree factors go through numerical isolation with exact certification
+  std::vector<long> coeffs(101, 0);
+  coeffs[0] = -2;
+  coeffs[100] = 1;
+  UPolynomial r(coeffs);
+  std::vector<long> h_coeffs(91, 0);
+  h_coeffs[0] = 1;
+  h_coeffs[90] = 1;
+  UPolynomial h(h_coeffs);
+  UPolynomial p = r * h * UPolynomial({-1, 1}) * UPolynomial({3, 1}) * UPolynomial({-1, 2});
+  std::vector<AlgebraicNumber> roots = isolate_real_roots(p);
+  CHECK(roots.size() == 5);
+  CHECK(roots[0] == AlgebraicNumber(UPolynomial({3, 1}), DyadicInterval(-4, -2)));
+  CHECK(roots[1] == AlgebraicNumber(r, DyadicInterval(-2, -1)));
+  CHECK(roots[2] == AlgebraicNumber(UPolynomial({-1, 2}), DyadicInterval(0, 1)));
+  CHECK(roots[3] == AlgebraicNumber(UPolynomial({-1, 1}), DyadicInterval(0, 2)));
+  CHECK(roots[4] == AlgebraicNumber(r, DyadicInterval(1, 2)));
+
+  // Clustered roots k/64 and a double root
+  UPolynomial q({1});
+  for (long k = -50; k <= 50; ++k) {
+    q = q * UPolynomial({k, 64});
+  }
+  q = q * UPolynomial({-5, 1});
+  roots = isolate_real_roots(q * UPolynomial({-5, 1}));
+  CHECK(roots.size() == 102);
+  for (long k = -50; k <= 50; ++k) {
+    CHECK(roots[50 - k] == AlgebraicNumber(DyadicRational(-k, 6)));
+  }
+  CHECK(roots[101] == AlgebraicNumber(UPolynomial({-5, 1}), DyadicInterval(4, 6)));
+
+  // Two roots extremely close to 2^-20 can't be certified numerically, so the
+  // Sturm sequences are computed (and kept for the next isolation)
+  std::vector<long> m_coeffs(101, 0);
+  m_coeffs[0] = -2;
+  m_coeffs[1] = 4L << 20;
+  m_coeffs[2] = -(2L << 40);
+  m_coeffs[100] = 1;
+  UPolynomial m(m_coeffs);
+  roots = isolate_real_roots(m);
+  CHECK(roots.size() == 4);
+  CHECK(roots[1] < AlgebraicNumber(DyadicRational(1, 20)));
+  CHECK(roots[2] > AlgebraicNumber(DyadicRational(1, 20)));
+  CHECK(isolate_real_roots(m) == roots);
+}
+
+TEST_CASE("upolynomial::composed") {
+  UPolynomial f({-2, 0, 1});
+  UPolynomial g({-3, 0, 1});
+  {
+    // sqrt(2) + sqrt(3)
+    UPolynomial p(lp_upolynomial_composed_sum(f.get_internal(), g.get_internal()));
+    CHECK(p == UPolynomial({1, 0, -10, 0, 1}));
+  }
+  {
+    // sqrt(2) * sqrt(3)
+    UPolynomial p(lp_upolynomial_composed_product(f.get_internal(), g.get_internal()));
+    CHECK(p == UPolynomial({-6, 0, 1}) * UPolynomial({-6, 0, 1}));
+  }
+  {
+    // Rational roots: 1/2 + {1, 2} and 1/2 * {1, 2}
+    UPolynomial h({-1, 2});
+    UPolynomial k({2, -3, 1});
+    CHECK(UPolynomial(lp_upolynomial_composed_sum(h.get_internal(), k.get_internal())) == UPolynomial({15, -16, 4}));
+    CHECK(UPolynomial(lp_upolynomial_composed_product(h.get_internal(), k.get_internal())) == UPolynomial({1, -3, 2}));
+  }
+}
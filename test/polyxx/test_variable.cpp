@@ -15,4 +15,72 @@ TEST_CASE("variable") {
   CHECK_FALSE(v1 != v1);
   CHECK(v1 != v2);
   CHECK_FALSE(v2 != v2);
-}
\ No newline at end of file
+}
+
+TEST_CASE("variable::order") {
+  Variable x("x");
+  Variable y("y");
+  Variable z("z");
+  lp_variable_t vx = x.get_internal();
+  lp_variable_t vy = y.get_internal();
+  lp_variable_t vz = z.get_internal();
+  lp_variable_order_t* order = lp_variable_order_new();
+
+  // Unlisted variables are ordered by id
+  CHECK(lp_variable_order_cmp(order, vx, vx) == 0);
+  CHECK(lp_variable_order_cmp(order, vx, vy) < 0);
+  CHECK(lp_variable_order_cmp(order, vz, vy) > 0);
+
+  // Listed variables are below the rest
+  lp_variable_order_push(order, vz);
+  lp_variable_order_push(order, vy);
+  CHECK(lp_variable_order_cmp(order, vz, vy) < 0);
+  CHECK(lp_variable_order_cmp(order, vy, vx) < 0);
+  CHECK(lp_variable_order_cmp(order, vx, vz) > 0);
+
+  lp_variable_order_pop(order);
+  CHECK(lp_variable_order_cmp(order, vz, vx) < 0);
+  CHECK(lp_variable_order_cmp(order, vx, vy) < 0);
+
+  // Variables with large ids
+  lp_variable_order_push(order, 1000);
+  CHECK(lp_variable_order_cmp(order, 1000, vx) < 0);
+  CHECK(lp_variable_order_cmp(order, vz, 1000) < 0);
+  CHECK(lp_variable_order_cmp(order, 2000, 1500) > 0);
+
+  lp_variable_order_clear(order);
+  CHECK(lp_variable_order_cmp(order, vx, vy) < 0);
+  CHECK(lp_variable_order_cmp(order, vy, vz) < 0);
+  CHECK(lp_variable_order_cmp(order, 1000, vz) > 0);
+
+  lp_variable_order_detach(order);
+}
+
+TEST_CASE("variable::order_reverse") {
+  Variable x("x");
+  Variable y("y");
+  Polynomial p = x * y + x;
+  lp_polynomial_set_external(p.get_internal());
+  lp_variable_order_t* order = Context::get_context().get_variable_order();
+
+  lp_variable_order_push(order, x.get_internal());
+  lp_variable_order_push(order, y.get_internal());
+  CHECK(lp_variable_order_cmp(order, x.get_internal(), y.get_internal()) < 0);
+  CHECK(main_variable(p) == y);
+
+  // Reversing the list reverses the ranks
+  lp_variable_order_reverse(order);
+  CHECK(lp_variable_order_cmp(order, x.get_internal(), y.get_internal()) > 0);
+  CHECK(lp_variable_order_cmp(order, y.get_internal(), x.get_internal()) < 0);
+  CHECK(main_variable(p) == x);
+  CHECK(lp_polynomial_check_order(p.get_internal()));
+
+  // Popping after a reverse removes the new top, x is unlisted again
+  lp_variable_order_pop(order);
+  CHECK(lp_variable_order_size(order) == 1);
+  CHECK(lp_variable_order_cmp(order, y.get_internal(), x.get_internal()) < 0);
+  CHECK(main_variable(p) == x);
+  CHECK(lp_polynomial_check_order(p.get_internal()));
+
+  lp_variable_order_clear(order);
+}